@@ -0,0 +1,71 @@
+/**
+ * @file bench/bench.h
+ *
+ * Minimal timing helpers of benchmarks. Benchmarks are built only with
+ * `-DRTTL_BUILD_BENCHMARKS=ON`, are not run by `ctest`, and print one line
+ * per case:
+ *  - `bench::measure` runs a case several times and keeps the fastest run,
+ *    which is the least disturbed by the scheduler and cold caches;
+ *  - `bench::keep` stores a result where the compiler cannot drop the code
+ *    computing it, and `bench::opaque` hides a value from the optimizer.
+ *
+ */
+#ifndef BENCH_BENCH_H_
+#define BENCH_BENCH_H_
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+/// Keeps a function out of line, to time the call as callers from other
+/// translation units would see it
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace bench {
+
+inline volatile std::size_t sink = 0;
+
+template <typename T>
+inline void keep(const T& value) noexcept {
+    sink = sink + static_cast<std::size_t>(value);
+}
+
+/**
+ * Returns `value`, which the compiler cannot assume, so that calls of pure
+ * functions taking it are not hoisted out of loops.
+ */
+template <typename T>
+inline T opaque(T value) noexcept {
+    volatile T v = value;
+    return v;
+}
+
+/**
+ * Nanoseconds per operation of the fastest of `runs` calls of `f`, each of
+ * which performs `ops` operations.
+ */
+template <typename F>
+double measure(std::size_t ops, F f, int runs = 20) {
+    using clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int i = 0; i < runs; ++i) {
+        auto start = clock::now();
+        f();
+        std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+        if (i == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best / static_cast<double>(ops);
+}
+
+inline void report(const char* name, std::size_t param, double ns_per_op) {
+    std::printf("%-24s %8zu %10.2f ns/op\n", name, param, ns_per_op);
+}
+
+}
+
+#endif  // BENCH_BENCH_H_
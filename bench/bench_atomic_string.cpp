@@ -0,0 +1,90 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "rttl/atomic_string.h"
+#include "rttl/string.h"
+#include "bench.h"
+
+/// Load and store of short strings through `rttl::atomic_string`, against an
+/// `rttl::string` guarded by `std::mutex`
+
+namespace {
+
+constexpr std::size_t ops = 1 << 20;
+
+const std::array<std::string_view, 4> s_values = { "IBM", "MSFT", "AAPL", "HALTED" };
+const std::array<std::string_view, 4> s_long_values = {
+    "OPEN", "CLOSED", "AUCTION_OPEN", "HALTED_VOLAT" };
+
+template <std::size_t N>
+class mutex_string {
+public:
+    void store(std::string_view desired) {
+        rttl::string<N> value(desired);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_value = value;
+    }
+
+    rttl::string<N> load() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_value;
+    }
+
+private:
+    rttl::string<N> m_value;
+    mutable std::mutex m_mutex;
+};
+
+template <typename Holder>
+void run(const char* name, const std::array<std::string_view, 4>& values) {
+    Holder holder;
+    bench::report((std::string(name) + " store").c_str(), 1, bench::measure(ops, [&] {
+        for (std::size_t i = 0; i < ops; ++i) {
+            holder.store(values[i & 3]);
+        }
+    }));
+    bench::report((std::string(name) + " load").c_str(), 1, bench::measure(ops, [&] {
+        std::size_t length = 0;
+        for (std::size_t i = 0; i < ops; ++i) {
+            length += holder.load().length();
+        }
+        bench::keep(length);
+    }));
+    /// One writer and three readers, all making `ops` calls
+    bench::report((std::string(name) + " 1w+3r").c_str(), 4, bench::measure(4 * ops, [&] {
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&holder]() {
+                std::size_t length = 0;
+                for (std::size_t i = 0; i < ops; ++i) {
+                    length += holder.load().length();
+                }
+                bench::keep(length);
+            });
+        }
+        for (std::size_t i = 0; i < ops; ++i) {
+            holder.store(values[i & 3]);
+        }
+        for (auto& t : readers) {
+            t.join();
+        }
+    }, 5));
+}
+
+}
+
+int main() {
+    std::printf("16-byte words are %s\n",
+                rttl::atomic_string<15>::is_always_lock_free ? "lock-free" : "locked");
+    run<rttl::atomic_string<7>>("atomic_string<7>", s_values);
+    run<rttl::atomic_string<15>>("atomic_string<15>", s_long_values);
+    run<rttl::atomic_string<32>>("atomic_string<32>", s_long_values);
+    run<mutex_string<7>>("mutex string<7>", s_values);
+    run<mutex_string<15>>("mutex string<15>", s_long_values);
+    return 0;
+}
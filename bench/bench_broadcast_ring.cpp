@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "rttl/broadcast_ring.h"
+#include "rttl/hdr_histogram.h"
+#include "bench.h"
+
+/// Fan-out of 64-byte events to 1..8 consumers through one broadcast ring,
+/// against copying every event into a single-producer single-consumer queue
+/// per consumer
+
+namespace {
+
+constexpr std::size_t ring_size = 1024;
+constexpr std::size_t max_consumers = 8;
+
+struct event {
+    std::uint64_t seq;
+    std::int64_t stamp;
+    std::array<double, 6> payload;
+};
+
+using clock_type = std::chrono::steady_clock;
+using latency_histogram = rttl::hdr_histogram<1, 10LL * 1000 * 1000 * 1000, 3>;
+
+std::int64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               clock_type::now().time_since_epoch()).count();
+}
+
+template <typename T, std::size_t N>
+class spsc_queue {
+public:
+    bool try_push(const T& value) noexcept {
+        std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        m_slots[tail % N] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Function>
+    std::size_t consume(Function f) {
+        std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        std::uint64_t tail = m_tail.load(std::memory_order_acquire);
+        for (std::uint64_t i = head; i != tail; ++i) {
+            f(m_slots[i % N]);
+        }
+        m_head.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> m_head{0};
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};
+    alignas(64) std::array<T, N> m_slots;
+};
+
+/// Producer and consumer sides of the broadcast ring
+class ring_fan_out {
+public:
+    explicit ring_fan_out(std::size_t consumers) {
+        for (std::size_t i = 0; i < consumers; ++i) {
+            m_ring.subscribe();
+        }
+    }
+
+    template <typename Fill>
+    bool try_publish(std::size_t count, Fill fill) {
+        ring::sequence_type first;
+        if (!m_ring.try_claim(count, first)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            fill(m_ring[first + i]);
+        }
+        m_ring.publish();
+        return true;
+    }
+
+    template <typename Function>
+    std::size_t consume(std::size_t id, Function f) {
+        return m_ring.consume(id, f);
+    }
+
+private:
+    using ring = rttl::broadcast_ring<event, ring_size, max_consumers>;
+    ring m_ring;
+};
+
+/// Producer and consumer sides of a queue per consumer
+class queue_fan_out {
+public:
+    explicit queue_fan_out(std::size_t consumers) : m_count(consumers) {}
+
+    template <typename Fill>
+    bool try_publish(std::size_t count, Fill fill) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fill(m_event);
+            /// A queue that is full is retried, others already have the event
+            for (std::size_t q = 0; q < m_count; ++q) {
+                while (!m_queues[q].try_push(m_event)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename Function>
+    std::size_t consume(std::size_t id, Function f) {
+        return m_queues[id].consume(f);
+    }
+
+private:
+    std::size_t m_count;
+    event m_event = {};
+    std::array<spsc_queue<event, ring_size>, max_consumers> m_queues;
+};
+
+/// Producer and consumers alternate in one thread: cost of the copies and
+/// cursor updates alone, per event and all consumers
+template <typename FanOut>
+double interleaved(std::size_t consumers) {
+    constexpr std::size_t batch = 64;
+    constexpr std::size_t events = 1 << 16;
+    auto fan_out = std::make_unique<FanOut>(consumers);
+    std::uint64_t seq = 0;
+    return bench::measure(events, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < events; i += batch) {
+            fan_out->try_publish(batch, [&seq](event& e) { e.seq = seq++; });
+            for (std::size_t c = 0; c < consumers; ++c) {
+                fan_out->consume(c, [&sum](const event& e) { sum += e.seq; });
+            }
+        }
+        bench::keep(sum);
+    });
+}
+
+/// Consumers in their own threads; throughput and latency from publishing to
+/// reading an event
+template <typename FanOut>
+void threaded(const char* name, std::size_t consumers) {
+    constexpr std::size_t batch = 16;
+    constexpr std::size_t events = 1 << 18;
+    auto fan_out = std::make_unique<FanOut>(consumers);
+    std::vector<latency_histogram> latencies(consumers);
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&fan_out, &latencies, c]() {
+            std::size_t seen = 0;
+            while (seen < events) {
+                std::size_t n = fan_out->consume(c, [&latencies, c](const event& e) {
+                    latencies[c].record(now() - e.stamp);
+                });
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                seen += n;
+            }
+        });
+    }
+    auto start = clock_type::now();
+    std::uint64_t seq = 0;
+    for (std::size_t i = 0; i < events; i += batch) {
+        while (!fan_out->try_publish(batch, [&seq](event& e) {
+            e.seq = seq++;
+            e.stamp = now();
+        })) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+    latency_histogram total;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        total.add(latencies[c]);
+    }
+    std::printf("%-24s %8zu %10.2f ns/event  p50 %8lld ns  p99 %8lld ns\n",
+                name, consumers, elapsed.count() / events,
+                static_cast<long long>(total.value_at_percentile(50.0)),
+                static_cast<long long>(total.value_at_percentile(99.0)));
+}
+
+}
+
+int main() {
+    for (std::size_t consumers : { 1u, 2u, 4u, 8u }) {
+        bench::report("broadcast_ring", consumers,
+                      interleaved<ring_fan_out>(consumers));
+        bench::report("SPSC queue per consumer", consumers,
+                      interleaved<queue_fan_out>(consumers));
+    }
+    for (std::size_t consumers : { 1u, 2u, 4u }) {
+        threaded<ring_fan_out>("broadcast_ring", consumers);
+        threaded<queue_fan_out>("SPSC queue per consumer", consumers);
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "rttl/char_traits.h"
+#include "bench.h"
+
+/// `find`, `compare` and `length` of `rttl::char_traits` for 16- and 32-bit
+/// characters, against `std::char_traits`, on strings of 16..4096 characters
+/// scanned in full
+
+namespace {
+
+constexpr std::size_t chars_per_run = 1 << 20;
+
+template <typename Traits>
+void run(const char* name, std::size_t length) {
+    using char_type = typename Traits::char_type;
+    std::vector<char_type> a(length + 1, char_type('x'));
+    a[length] = char_type(0);
+    std::vector<char_type> b(a);
+    const std::size_t calls = chars_per_run / length;
+    std::string label(name);
+    /// Per character, so that lengths compare
+    bench::report((label + " find").c_str(), length, bench::measure(chars_per_run, [&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            found += Traits::find(a.data(), bench::opaque(length), char_type('y')) == nullptr;
+        }
+        bench::keep(found);
+    }));
+    bench::report((label + " compare").c_str(), length, bench::measure(chars_per_run, [&] {
+        int sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += Traits::compare(a.data(), b.data(), bench::opaque(length));
+        }
+        bench::keep(sum == 0);
+    }));
+    bench::report((label + " length").c_str(), length, bench::measure(chars_per_run, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += Traits::length(bench::opaque(a.data()));
+        }
+        bench::keep(sum);
+    }));
+}
+
+}
+
+int main() {
+    for (std::size_t length : { 16u, 256u, 4096u }) {
+        run<rttl::char_traits<char16_t>>("rttl char16_t", length);
+        run<std::char_traits<char16_t>>("std char16_t", length);
+        run<rttl::char_traits<char32_t>>("rttl char32_t", length);
+        run<std::char_traits<char32_t>>("std char32_t", length);
+    }
+    return 0;
+}
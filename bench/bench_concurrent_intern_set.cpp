@@ -0,0 +1,104 @@
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "rttl/concurrent_intern_set.h"
+#include "bench.h"
+
+/// Interning a stream of symbols, most of them seen before, from 1..4 threads
+/// into `rttl::concurrent_intern_set`, against a `std::unordered_set` of
+/// `std::string` guarded by `std::mutex`
+
+namespace {
+
+constexpr std::size_t symbol_count = 4096;
+constexpr std::size_t ops_per_thread = 1 << 18;
+
+using intern_set = rttl::concurrent_intern_set<1 << 20, 1 << 16>;
+
+class mutex_intern_set {
+public:
+    std::string_view intern(std::string_view str) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return *m_set.emplace(str).first;
+    }
+
+private:
+    std::unordered_set<std::string> m_set;
+    std::mutex m_mutex;
+};
+
+std::vector<std::string> make_symbols() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::uniform_int_distribution<std::size_t> length(3, 12);
+    std::vector<std::string> symbols(symbol_count);
+    for (std::size_t i = 0; i < symbol_count; ++i) {
+        symbols[i] = std::to_string(i) + ".";
+        for (std::size_t n = length(gen); n > 0; --n) {
+            symbols[i].push_back(static_cast<char>(letter(gen)));
+        }
+    }
+    return symbols;
+}
+
+/// Each thread interns the symbols in its own random order
+std::vector<std::vector<std::size_t>> make_streams(std::size_t threads) {
+    std::vector<std::vector<std::size_t>> streams(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        std::mt19937 gen(static_cast<unsigned>(t));
+        std::uniform_int_distribution<std::size_t> pick(0, symbol_count - 1);
+        streams[t].resize(ops_per_thread);
+        for (std::size_t& s : streams[t]) {
+            s = pick(gen);
+        }
+    }
+    return streams;
+}
+
+template <typename Set, typename Intern>
+double run(std::size_t threads, const std::vector<std::string>& symbols,
+           Intern intern) {
+    const auto streams = make_streams(threads);
+    return bench::measure(threads * ops_per_thread, [&] {
+        auto set = std::make_unique<Set>();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                std::size_t sum = 0;
+                for (std::size_t s : streams[t]) {
+                    sum += intern(*set, symbols[s]);
+                }
+                bench::keep(sum);
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }, 5);
+}
+
+}
+
+int main() {
+    const std::vector<std::string> symbols = make_symbols();
+    for (std::size_t threads : { 1u, 2u, 4u }) {
+        bench::report("concurrent_intern_set", threads,
+                      run<intern_set>(threads, symbols,
+                                      [](intern_set& s, const std::string& str) {
+            return static_cast<std::size_t>(s.intern(str));
+        }));
+        bench::report("mutex unordered_set", threads,
+                      run<mutex_intern_set>(threads, symbols,
+                                            [](mutex_intern_set& s, const std::string& str) {
+            return s.intern(str).size();
+        }));
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "rttl/decimal.h"
+#include "rttl/string.h"
+#include "bench.h"
+
+/// Parsing prices into `rttl::decimal<Scale>` with `parse_decimal`, against
+/// `rttl::stod` followed by scaling to an integer; and formatting them with
+/// `format_decimal`, against `snprintf` of the double and of the integer
+/// parts. Also counts values the floating-point route gets wrong
+
+namespace {
+
+constexpr std::size_t count = 4096;
+
+using text = rttl::string<32>;
+
+/// Prices of `integer_digits` digits with 0..`Scale` fractional digits
+template <unsigned Scale>
+std::vector<text> make_prices(unsigned integer_digits) {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int> digit('0', '9');
+    std::uniform_int_distribution<unsigned> fraction_digits(0, Scale);
+    std::vector<text> prices(count);
+    for (text& t : prices) {
+        t.push_back(static_cast<char>(std::uniform_int_distribution<int>('1', '9')(gen)));
+        for (unsigned i = 1; i < integer_digits; ++i) {
+            t.push_back(static_cast<char>(digit(gen)));
+        }
+        if (unsigned n = fraction_digits(gen); n > 0) {
+            t.push_back('.');
+            for (; n > 0; --n) {
+                t.push_back(static_cast<char>(digit(gen)));
+            }
+        }
+    }
+    return prices;
+}
+
+template <unsigned Scale>
+void run(unsigned integer_digits) {
+    using number = rttl::decimal<Scale>;
+    constexpr double one = static_cast<double>(number::one);
+    const std::vector<text> prices = make_prices<Scale>(integer_digits);
+    std::vector<number> values(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        rttl::parse_decimal(prices[i], values[i]);
+    }
+    std::size_t truncated = 0;
+    std::size_t rounded = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        double x = rttl::stod(prices[i]) * one;
+        truncated += static_cast<std::int64_t>(x) != values[i].raw();
+        rounded += std::llround(x) != values[i].raw();
+    }
+    std::printf("scale %u, %u integer digits: stod wrong for %zu truncated, "
+                "%zu rounded of %zu\n", Scale, integer_digits, truncated,
+                rounded, count);
+
+    bench::report("parse_decimal", integer_digits, bench::measure(count, [&] {
+        std::int64_t sum = 0;
+        for (const text& t : prices) {
+            number n;
+            rttl::parse_decimal(t, n);
+            sum += n.raw();
+        }
+        bench::keep(sum);
+    }));
+    bench::report("stod and llround", integer_digits, bench::measure(count, [&] {
+        std::int64_t sum = 0;
+        for (const text& t : prices) {
+            sum += std::llround(rttl::stod(t) * one);
+        }
+        bench::keep(sum);
+    }));
+
+    text out;
+    bench::report("format_decimal", integer_digits, bench::measure(count, [&] {
+        std::size_t sum = 0;
+        for (const number& n : values) {
+            rttl::format_decimal(n, out);
+            sum += out.size();
+        }
+        bench::keep(sum);
+    }));
+    char buffer[64];
+    bench::report("snprintf double", integer_digits, bench::measure(count, [&] {
+        std::size_t sum = 0;
+        for (const number& n : values) {
+            sum += static_cast<std::size_t>(std::snprintf(
+                buffer, sizeof(buffer), "%.*f", static_cast<int>(Scale),
+                static_cast<double>(n.raw()) / one));
+        }
+        bench::keep(sum);
+    }));
+    bench::report("snprintf integers", integer_digits, bench::measure(count, [&] {
+        std::size_t sum = 0;
+        for (const number& n : values) {
+            sum += static_cast<std::size_t>(std::snprintf(
+                buffer, sizeof(buffer), "%" PRId64 ".%0*" PRId64,
+                n.raw() / number::one, static_cast<int>(Scale),
+                n.raw() % number::one));
+        }
+        bench::keep(sum);
+    }));
+}
+
+}
+
+int main() {
+    /// Second column is the number of integer digits
+    run<4>(3);
+    run<4>(6);
+    run<8>(10);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "rttl/dispatcher.h"
+#include "bench.h"
+
+/// Publishing quotes to 100 topics of 1 to 64 subscribers each through
+/// `rttl::dispatcher`, by topic handle and by name, against the
+/// `std::unordered_map` of topic names to `std::vector` of `std::function`
+/// it replaces; subscriptions to different topics are interleaved
+
+namespace {
+
+constexpr std::size_t topic_count = 100;
+constexpr std::size_t publishes = 4096;
+
+struct quote {
+    std::uint32_t symbol;
+    double price;
+};
+
+using dispatcher = rttl::dispatcher<128, 8192, 32, void(const quote&)>;
+using std_dispatcher =
+    std::unordered_map<std::string, std::vector<std::function<void(const quote&)>>>;
+
+double s_total = 0;
+
+/// With `interleaved`, topics take turns to subscribe, otherwise all
+/// subscribers of a topic subscribe in a row
+void run(std::size_t subscribers, bool interleaved) {
+    auto owner = std::make_unique<dispatcher>();
+    dispatcher& d = *owner;
+    std_dispatcher map;
+    std::vector<std::string> names;
+    std::vector<dispatcher::topic_handle> handles;
+    for (std::size_t t = 0; t < topic_count; ++t) {
+        names.push_back("md.quote.SYM" + std::to_string(t * 7919));
+        handles.push_back(d.topic(names.back()));
+    }
+    for (std::size_t k = 0; k < subscribers * topic_count; ++k) {
+        std::size_t i = interleaved ? k / topic_count : k % subscribers;
+        std::size_t t = interleaved ? k % topic_count : k / subscribers;
+        double weight = static_cast<double>(i + 1);
+        auto callback = [weight](const quote& q) { s_total += q.price * weight; };
+        d.subscribe(handles[t], callback);
+        map[names[t]].push_back(callback);
+    }
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> pick(0, topic_count - 1);
+    std::vector<std::size_t> order(publishes);
+    for (std::size_t& t : order) {
+        t = pick(gen);
+    }
+    const quote q = { 42, 101.25 };
+
+    bench::report("publish by handle", subscribers, bench::measure(publishes, [&] {
+        for (std::size_t t : order) {
+            d.publish(handles[t], q);
+        }
+    }));
+    bench::report("publish by name", subscribers, bench::measure(publishes, [&] {
+        for (std::size_t t : order) {
+            d.publish(names[t], q);
+        }
+    }));
+    bench::report("unordered_map by name", subscribers, bench::measure(publishes, [&] {
+        for (std::size_t t : order) {
+            auto it = map.find(names[t]);
+            if (it != map.end()) {
+                for (const auto& f : it->second) {
+                    f(q);
+                }
+            }
+        }
+    }));
+    std::vector<const std::vector<std::function<void(const quote&)>>*> lists;
+    for (const std::string& name : names) {
+        lists.push_back(&map[name]);
+    }
+    bench::report("  with the list cached", subscribers, bench::measure(publishes, [&] {
+        for (std::size_t t : order) {
+            for (const auto& f : *lists[t]) {
+                f(q);
+            }
+        }
+    }));
+    bench::keep(s_total);
+}
+
+}
+
+int main() {
+    /// Second column is the number of subscribers per topic
+    for (bool interleaved : { true, false }) {
+        std::printf("%s subscriptions\n", interleaved ? "interleaved" : "grouped");
+        for (std::size_t subscribers : { 1u, 4u, 16u, 64u }) {
+            run(subscribers, interleaved);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include "rttl/edit_distance.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Scoring a query against 10000 candidates of 5..30 characters with the
+/// bit-parallel `rttl::edit_distances`, against the two-row dynamic
+/// programming loop, unbounded and with `max_k = 2`; and one pair of 120
+/// characters, which takes two words
+
+namespace {
+
+constexpr std::size_t candidate_count = 10000;
+
+using word = rttl::string<32>;
+
+rttl::vector<word, candidate_count> s_candidates;
+rttl::vector<std::size_t, candidate_count> s_distances;
+
+/// `O(nm)` edit distance, stopping once a whole row exceeds `max_k`
+std::size_t dp_distance(std::string_view a, std::string_view b,
+                        std::size_t max_k) noexcept {
+    std::array<std::size_t, 129> prev;
+    std::array<std::size_t, 129> cur;
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    for (std::size_t i = 0; i <= a.size(); ++i) {
+        prev[i] = i;
+    }
+    for (std::size_t j = 1; j <= b.size(); ++j) {
+        cur[0] = j;
+        std::size_t row_min = cur[0];
+        for (std::size_t i = 1; i <= a.size(); ++i) {
+            std::size_t sub = prev[i - 1] + (a[i - 1] != b[j - 1]);
+            cur[i] = std::min({ sub, prev[i] + 1, cur[i - 1] + 1 });
+            row_min = std::min(row_min, cur[i]);
+        }
+        if (row_min > max_k) {
+            return max_k + 1;
+        }
+        std::swap(prev, cur);
+    }
+    return std::min(prev[a.size()], max_k + 1);
+}
+
+void make_candidates() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<std::size_t> length(5, 30);
+    for (std::size_t i = 0; i < candidate_count; ++i) {
+        word w;
+        for (std::size_t n = length(gen); n > 0; --n) {
+            w.push_back(static_cast<char>(letter(gen)));
+        }
+        s_candidates.push_back(w);
+    }
+}
+
+void run(std::string_view query, std::size_t max_k, const char* bound) {
+    std::string label = std::string(" (k ") + bound + ")";
+    bench::report(("edit_distances" + label).c_str(), query.size(),
+                  bench::measure(candidate_count, [&] {
+        s_distances.clear();
+        rttl::edit_distances<32>(query, s_candidates, max_k, s_distances);
+        bench::keep(s_distances.back());
+    }));
+    bench::report(("edit_distance" + label).c_str(), query.size(),
+                  bench::measure(candidate_count, [&] {
+        std::size_t sum = 0;
+        for (const word& w : s_candidates) {
+            sum += rttl::edit_distance<32>(query, w, max_k);
+        }
+        bench::keep(sum);
+    }));
+    bench::report(("dynamic programming" + label).c_str(), query.size(),
+                  bench::measure(candidate_count, [&] {
+        std::size_t sum = 0;
+        for (const word& w : s_candidates) {
+            sum += dp_distance(query, w, max_k);
+        }
+        bench::keep(sum);
+    }, 5));
+}
+
+}
+
+int main() {
+    make_candidates();
+    for (std::string_view query : { "quot", "tradingvenue", "consolidatedorderbookfeed" }) {
+        run(query, rttl::edit_distance_unbounded, "inf");
+        run(query, 2, "2");
+    }
+    /// Two words per column of the pattern
+    rttl::string<128> a(120, 'a');
+    rttl::string<128> b(a);
+    for (std::size_t i = 0; i < 120; i += 7) {
+        b[i] = 'b';
+    }
+    bench::report("edit_distance, 2 words", 120, bench::measure(1, [&] {
+        bench::keep(rttl::edit_distance(a, b));
+    }, 1000));
+    bench::report("dynamic programming", 120, bench::measure(1, [&] {
+        bench::keep(dp_distance(a, b, rttl::edit_distance_unbounded));
+    }, 1000));
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "rttl/group_by.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Count, volume and VWAP of trades per symbol with `rttl::group_by`, and
+/// with `group_by_sorted` on trades sorted by symbol, against a
+/// `std::unordered_map` of aggregates built per call; for 10k to 1M trades
+/// of 10 to 10k symbols
+
+namespace {
+
+constexpr std::size_t max_rows = 1 << 20;
+constexpr std::size_t max_groups = 1 << 14;
+
+struct trade {
+    std::uint32_t symbol;
+    double price;
+    std::int64_t quantity;
+};
+
+using row = rttl::group_row<std::uint32_t, std::size_t, std::int64_t, double>;
+
+struct aggregate {
+    std::size_t count = 0;
+    std::int64_t volume = 0;
+    double notional = 0;
+};
+
+rttl::vector<trade, max_rows> s_trades;
+rttl::vector<trade, max_rows> s_sorted;
+rttl::vector<row, max_groups> s_rows;
+
+auto symbol_of = [](const trade& t) { return t.symbol; };
+auto price_of = [](const trade& t) { return t.price; };
+auto quantity_of = [](const trade& t) { return t.quantity; };
+
+void make_trades(std::size_t n, std::uint32_t groups) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::uint32_t> symbol(0, groups - 1);
+    std::uniform_int_distribution<int> tick(0, 1000);
+    std::uniform_int_distribution<std::int64_t> quantity(1, 500);
+    s_trades.clear();
+    s_sorted.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        /// Symbol ids are spread, not dense indices
+        s_trades.push_back({ symbol(gen) * 2654435761u, 100 + tick(gen) / 100.0,
+                             quantity(gen) });
+        s_sorted.push_back(s_trades.back());
+    }
+    std::sort(s_sorted.begin(), s_sorted.end(),
+              [](const trade& a, const trade& b) { return a.symbol < b.symbol; });
+}
+
+void run(std::size_t n, std::uint32_t groups) {
+    make_trades(n, groups);
+    const int runs = (n >= max_rows) ? 5 : 20;
+    std::printf("%u groups\n", groups);
+    bench::report("group_by", n, bench::measure(n, [&] {
+        rttl::group_by(s_trades, symbol_of, s_rows, rttl::aggregate::count(),
+                       rttl::aggregate::sum(quantity_of),
+                       rttl::aggregate::weighted_mean(price_of, quantity_of));
+        bench::keep(s_rows.size());
+    }, runs));
+    bench::report("group_by_sorted", n, bench::measure(n, [&] {
+        rttl::group_by_sorted(s_sorted, symbol_of, s_rows, rttl::aggregate::count(),
+                              rttl::aggregate::sum(quantity_of),
+                              rttl::aggregate::weighted_mean(price_of, quantity_of));
+        bench::keep(s_rows.size());
+    }, runs));
+    bench::report("std::unordered_map", n, bench::measure(n, [&] {
+        std::unordered_map<std::uint32_t, aggregate> map;
+        for (const trade& t : s_trades) {
+            aggregate& a = map[t.symbol];
+            ++a.count;
+            a.volume += t.quantity;
+            a.notional += t.price * static_cast<double>(t.quantity);
+        }
+        std::vector<row> rows;
+        rows.reserve(map.size());
+        for (const auto& [symbol, a] : map) {
+            rows.push_back({ symbol, { a.count, a.volume,
+                                       a.notional / static_cast<double>(a.volume) } });
+        }
+        bench::keep(rows.size());
+    }, runs));
+}
+
+}
+
+int main() {
+    for (std::uint32_t groups : { 10u, 100u, 1000u, 10000u }) {
+        for (std::size_t n : { 10000u, 100000u, 1000000u }) {
+            run(n, groups);
+        }
+    }
+    return 0;
+}
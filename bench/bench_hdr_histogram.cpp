@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+#include "rttl/hdr_histogram.h"
+#include "bench.h"
+
+/// Cost of recording a latency and of querying the 99th percentile, against
+/// a `std::map` of counts and a vector of samples sorted per query
+
+namespace {
+
+constexpr std::int64_t max_latency = 3600LL * 1000 * 1000 * 1000;
+constexpr std::size_t sample_count = 1 << 16;
+
+using histogram = rttl::hdr_histogram<1, max_latency, 3>;
+using atomic_histogram = rttl::atomic_hdr_histogram<1, max_latency, 3>;
+
+histogram s_histogram;
+atomic_histogram s_atomic_histogram;
+
+std::vector<std::int64_t> make_latencies() {
+    std::mt19937 gen(42);
+    /// Around 10 us with a long tail, in nanoseconds
+    std::lognormal_distribution<double> dist(std::log(10000.0), 1.0);
+    std::vector<std::int64_t> latencies(sample_count);
+    for (std::int64_t& latency : latencies) {
+        latency = std::min(static_cast<std::int64_t>(dist(gen)), max_latency);
+    }
+    return latencies;
+}
+
+}
+
+int main() {
+    const std::vector<std::int64_t> latencies = make_latencies();
+    std::map<std::int64_t, std::int64_t> counts;
+    std::vector<std::int64_t> samples;
+    samples.reserve(sample_count);
+
+    bench::report("hdr_histogram::record", sample_count, bench::measure(sample_count, [&] {
+        s_histogram.reset();
+        for (std::int64_t latency : latencies) {
+            s_histogram.record(latency);
+        }
+        bench::keep(s_histogram.total_count());
+    }));
+    bench::report("atomic_hdr_histogram", sample_count, bench::measure(sample_count, [&] {
+        s_atomic_histogram.reset();
+        for (std::int64_t latency : latencies) {
+            s_atomic_histogram.record(latency);
+        }
+        bench::keep(s_atomic_histogram.total_count());
+    }));
+    bench::report("std::map record", sample_count, bench::measure(sample_count, [&] {
+        counts.clear();
+        for (std::int64_t latency : latencies) {
+            ++counts[latency];
+        }
+        bench::keep(counts.size());
+    }));
+    bench::report("std::vector record", sample_count, bench::measure(sample_count, [&] {
+        samples.clear();
+        for (std::int64_t latency : latencies) {
+            samples.push_back(latency);
+        }
+        bench::keep(samples.size());
+    }));
+
+    /// Queries of the samples recorded last
+    bench::report("hdr p99 query", sample_count, bench::measure(1, [&] {
+        bench::keep(s_histogram.value_at_percentile(99.0));
+    }));
+    bench::report("std::map p99 query", sample_count, bench::measure(1, [&] {
+        const auto rank = static_cast<std::int64_t>(0.99 * sample_count);
+        std::int64_t seen = 0;
+        auto it = counts.begin();
+        for (; it != counts.end() && seen + it->second <= rank; ++it) {
+            seen += it->second;
+        }
+        bench::keep(it->first);
+    }));
+    std::vector<std::int64_t> sorted;
+    sorted.reserve(sample_count);
+    bench::report("std::sort p99 query", sample_count, bench::measure(1, [&] {
+        sorted.assign(samples.begin(), samples.end());
+        std::sort(sorted.begin(), sorted.end());
+        bench::keep(sorted[sample_count * 99 / 100]);
+    }));
+    bench::report("nth_element p99 query", sample_count, bench::measure(1, [&] {
+        sorted.assign(samples.begin(), samples.end());
+        std::nth_element(sorted.begin(), sorted.begin() + sample_count * 99 / 100,
+                         sorted.end());
+        bench::keep(sorted[sample_count * 99 / 100]);
+    }));
+    return 0;
+}
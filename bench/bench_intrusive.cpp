@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "rttl/intrusive.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Orders stored in an `rttl::vector`, kept in an LRU list and indexed by id
+/// with `rttl::intrusive_list` and `intrusive_hash_set` of as many buckets as
+/// orders, against a `std::list` of pointers with its iterators kept aside
+/// and a reserved `std::unordered_map` of ids to pointers; for 1k to 128k
+/// orders, touching, relinking, iterating and looking up random orders
+
+namespace {
+
+constexpr std::size_t lookups = 4096;
+
+struct order {
+    std::uint32_t id = 0;
+    double price = 0;
+    rttl::intrusive_list_hook lru;
+    rttl::intrusive_hash_hook by_id;
+};
+
+struct order_id {
+    std::uint32_t operator()(const order& o) const noexcept {
+        return o.id;
+    }
+};
+
+template <std::size_t N>
+void run() {
+    using orders = rttl::vector<order, N>;
+    using lru_list = rttl::intrusive_list<order, &order::lru>;
+    using id_set = rttl::intrusive_hash_set<order, &order::by_id, N, order_id>;
+
+    auto storage = std::make_unique<orders>(N);
+    orders& all = *storage;
+    for (std::size_t i = 0; i < N; ++i) {
+        /// Ids are spread, not dense indices
+        all[i].id = static_cast<std::uint32_t>(i) * 2654435761u;
+        all[i].price = 100 + static_cast<double>(i % 1000) / 100;
+    }
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::size_t> pick(0, N - 1);
+    std::vector<std::size_t> order_of(lookups);
+    for (std::size_t& i : order_of) {
+        i = pick(gen);
+    }
+
+    lru_list lru;
+    std::list<order*> std_lru;
+    std::vector<std::list<order*>::iterator> positions;
+    for (order& o : all) {
+        lru.push_back(o);
+        positions.push_back(std_lru.insert(std_lru.end(), &o));
+    }
+    bench::report("intrusive_list move", N, bench::measure(lookups, [&] {
+        for (std::size_t i : order_of) {
+            lru.move(lru.end(), all[i]);
+        }
+    }));
+    bench::report("std::list splice", N, bench::measure(lookups, [&] {
+        for (std::size_t i : order_of) {
+            std_lru.splice(std_lru.end(), std_lru, positions[i]);
+        }
+    }));
+    bench::report("intrusive_list relink", N, bench::measure(lookups, [&] {
+        for (std::size_t i : order_of) {
+            lru.erase(lru.iterator_to(all[i]));
+            lru.push_back(all[i]);
+        }
+    }));
+    bench::report("std::list erase, insert", N, bench::measure(lookups, [&] {
+        for (std::size_t i : order_of) {
+            std_lru.erase(positions[i]);
+            positions[i] = std_lru.insert(std_lru.end(), &all[i]);
+        }
+    }));
+    bench::report("intrusive_list iterate", N, bench::measure(N, [&] {
+        double sum = 0;
+        for (const order& o : lru) {
+            sum += o.price;
+        }
+        bench::keep(sum);
+    }, 10));
+    bench::report("std::list iterate", N, bench::measure(N, [&] {
+        double sum = 0;
+        for (const order* o : std_lru) {
+            sum += o->price;
+        }
+        bench::keep(sum);
+    }, 10));
+
+    auto index = std::make_unique<id_set>();
+    std::unordered_map<std::uint32_t, order*> std_index;
+    bench::report("intrusive_hash insert", N, bench::measure(N, [&] {
+        index->clear();
+        for (order& o : all) {
+            index->insert(o);
+        }
+        bench::keep(index->empty());
+    }, 10));
+    bench::report("unordered_map insert", N, bench::measure(N, [&] {
+        std_index.clear();
+        std_index.reserve(N);
+        for (order& o : all) {
+            std_index.emplace(o.id, &o);
+        }
+        bench::keep(std_index.size());
+    }, 10));
+    bench::report("intrusive_hash find", N, bench::measure(lookups, [&] {
+        double sum = 0;
+        for (std::size_t i : order_of) {
+            sum += index->find(all[i].id)->price;
+        }
+        bench::keep(sum);
+    }));
+    bench::report("unordered_map find", N, bench::measure(lookups, [&] {
+        double sum = 0;
+        for (std::size_t i : order_of) {
+            sum += std_index.find(all[i].id)->second->price;
+        }
+        bench::keep(sum);
+    }));
+    /// Nodes of standard containers are allocated apart, with allocator
+    /// overhead on top
+    std::printf("  %zu bytes per order with hooks, %zu of which hooks; standard "
+                "containers add %zu per list node and %zu per map node and bucket\n",
+                sizeof(order), sizeof(rttl::intrusive_list_hook) +
+                sizeof(rttl::intrusive_hash_hook), sizeof(std::list<order*>::value_type) +
+                2 * sizeof(void*), sizeof(std::pair<const std::uint32_t, order*>) +
+                2 * sizeof(void*));
+}
+
+}
+
+int main() {
+    /// Second column is the number of orders
+    run<1024>();
+    run<16384>();
+    run<131072>();
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <cstddef>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "rttl/journal.h"
+#include "bench.h"
+
+/// Durable records per second of `rttl::journal_writer` on local disk, with
+/// 1..32 threads each appending a 100-byte record and waiting until it is
+/// durable, for commit windows of 0..10 ms; against writing and syncing every
+/// record under a mutex
+
+namespace {
+
+constexpr std::size_t record_size = 100;
+/// Records per run, shared by all threads
+constexpr std::size_t record_count = 2048;
+
+using writer = rttl::journal_writer<1 << 20>;
+
+const std::string s_path = "bench_journal.log";
+const std::string s_record(record_size, 'x');
+
+template <typename Commit>
+double run(std::size_t threads, Commit commit) {
+    return bench::measure(record_count, [&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for (std::size_t i = 0; i < record_count / threads; ++i) {
+                    commit();
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }, 3);
+}
+
+void report(const char* name, std::size_t threads, double ns_per_record) {
+    std::printf("%-24s %8zu %10.0f records/s\n", name, threads,
+                1e9 / ns_per_record);
+}
+
+/// `pwrite` and `fdatasync` of every record in turn
+class sync_per_record {
+public:
+    sync_per_record() {
+        m_fd = ::open(s_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+
+    ~sync_per_record() {
+        ::close(m_fd);
+    }
+
+    void commit() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        bench::keep(::pwrite(m_fd, s_record.data(), s_record.size(),
+                             static_cast<off_t>(m_offset)));
+        m_offset += s_record.size();
+        bench::keep(::fdatasync(m_fd));
+    }
+
+private:
+    int m_fd;
+    std::size_t m_offset = 0;
+    std::mutex m_mutex;
+};
+
+}
+
+int main() {
+    for (long window : { 0L, 100L, 1000L, 10000L }) {
+        std::string name = "journal, " + std::to_string(window) + " us";
+        for (std::size_t threads : { 1u, 8u, 32u }) {
+            ::unlink(s_path.c_str());
+            rttl::journal_options options;
+            options.commit_interval = std::chrono::microseconds(window);
+            auto journal = std::make_unique<writer>(s_path.c_str(), options);
+            report(name.c_str(), threads, run(threads, [&] {
+                journal->wait(journal->append(s_record));
+            }));
+        }
+    }
+    for (std::size_t threads : { 1u, 8u, 32u }) {
+        sync_per_record baseline;
+        report("fdatasync per record", threads, run(threads, [&] {
+            baseline.commit();
+        }));
+    }
+    /// Appends without waiting, as a producer that acknowledges later
+    for (long window : { 100L, 1000L }) {
+        ::unlink(s_path.c_str());
+        rttl::journal_options options;
+        options.commit_interval = std::chrono::microseconds(window);
+        auto journal = std::make_unique<writer>(s_path.c_str(), options);
+        std::string name = "streaming, " + std::to_string(window) + " us";
+        report(name.c_str(), 1, bench::measure(record_count * 64, [&] {
+            for (std::size_t i = 0; i < record_count * 64; ++i) {
+                journal->append(s_record);
+            }
+            journal->flush();
+        }, 3));
+    }
+    ::unlink(s_path.c_str());
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "rttl/algorithm.h"
+#include "bench.h"
+
+/// Merges of K sorted inputs of `length` ints each, per merged element
+
+namespace {
+
+constexpr std::size_t length = 1024;
+constexpr std::size_t max_inputs = 64;
+
+using input = std::vector<int>;
+using span = std::pair<const int*, const int*>;
+
+rttl::vector<int, max_inputs * length> s_out;
+
+template <std::size_t K>
+std::array<input, K> make_inputs() {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000000);
+    std::array<input, K> inputs;
+    for (input& in : inputs) {
+        in.resize(length);
+        std::generate(in.begin(), in.end(), [&] { return dist(gen); });
+        std::sort(in.begin(), in.end());
+    }
+    return inputs;
+}
+
+/// Merges neighbouring runs until one is left, as a tree of `std::merge` calls
+template <std::size_t K>
+void pairwise_merge(const std::array<input, K>& inputs, std::vector<int>& out,
+                    std::vector<int>& scratch, std::vector<span>& runs) {
+    runs.clear();
+    for (const input& in : inputs) {
+        runs.emplace_back(in.data(), in.data() + in.size());
+    }
+    std::vector<int>* dst = &out;
+    std::vector<int>* other = &scratch;
+    while (runs.size() > 1) {
+        int* d = dst->data();
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < runs.size(); i += 2) {
+            int* begin = d;
+            if (i + 1 < runs.size()) {
+                d = std::merge(runs[i].first, runs[i].second,
+                               runs[i + 1].first, runs[i + 1].second, d);
+            } else {
+                d = std::copy(runs[i].first, runs[i].second, d);
+            }
+            runs[n++] = span(begin, d);
+        }
+        runs.resize(n);
+        std::swap(dst, other);
+    }
+    if (other != &out) {
+        std::swap(out, scratch);
+    }
+}
+
+template <std::size_t K>
+void heap_merge(const std::array<input, K>& inputs, std::vector<int>& out) {
+    using entry = std::pair<int, std::size_t>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<>> heap;
+    std::array<std::size_t, K> next = {};
+    for (std::size_t i = 0; i < K; ++i) {
+        if (!inputs[i].empty()) {
+            heap.emplace(inputs[i][0], i);
+            next[i] = 1;
+        }
+    }
+    int* d = out.data();
+    while (!heap.empty()) {
+        auto [value, i] = heap.top();
+        heap.pop();
+        *d++ = value;
+        if (next[i] < inputs[i].size()) {
+            heap.emplace(inputs[i][next[i]++], i);
+        }
+    }
+}
+
+template <std::size_t K>
+void run() {
+    const std::array<input, K> inputs = make_inputs<K>();
+    const std::size_t total = K * length;
+    std::vector<int> out(total);
+    std::vector<int> scratch(total);
+    std::vector<span> runs;
+    runs.reserve(K);
+
+    bench::report("rttl::kway_merge", K, bench::measure(total, [&] {
+        s_out.clear();
+        rttl::kway_merge(inputs, s_out);
+        bench::keep(s_out.back());
+    }));
+    bench::report("stable_kway_merge", K, bench::measure(total, [&] {
+        s_out.clear();
+        rttl::stable_kway_merge(inputs, s_out);
+        bench::keep(s_out.back());
+    }));
+    bench::report("pairwise std::merge", K, bench::measure(total, [&] {
+        pairwise_merge(inputs, out, scratch, runs);
+        bench::keep(out.back());
+    }));
+    bench::report("std::priority_queue", K, bench::measure(total, [&] {
+        heap_merge(inputs, out);
+        bench::keep(out.back());
+    }));
+}
+
+template <std::size_t... K>
+void run_all(std::index_sequence<K...>) {
+    (run<std::size_t(2) << K>(), ...);
+}
+
+}
+
+int main() {
+    /// K = 2, 4, ..., 64
+    run_all(std::make_index_sequence<6>());
+    return 0;
+}
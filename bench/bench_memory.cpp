@@ -0,0 +1,67 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "rttl/hdr_histogram.h"
+#include "rttl/memory.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Latency of appending page-sized chunks to a large static `rttl::vector`
+/// whose pages are touched for the first time, against the same container
+/// prefaulted (and locked) at startup
+
+namespace {
+
+constexpr std::size_t capacity = 64 * 1024 * 1024;
+constexpr std::size_t chunk = 4096;
+
+using buffer = rttl::vector<std::uint8_t, capacity>;
+using clock_type = std::chrono::steady_clock;
+using latency_histogram = rttl::hdr_histogram<1, 1000LL * 1000 * 1000, 3>;
+
+buffer s_cold;
+buffer s_prefaulted;
+buffer s_locked;
+
+void run(const char* name, buffer& b) {
+    static std::array<std::uint8_t, chunk> s_chunk;
+    latency_histogram latencies;
+    auto start = clock_type::now();
+    while (b.size() + chunk <= b.capacity()) {
+        auto t = clock_type::now();
+        b.insert(b.cend(), s_chunk.begin(), s_chunk.end());
+        latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             clock_type::now() - t).count());
+    }
+    std::chrono::duration<double, std::milli> total = clock_type::now() - start;
+    std::printf("%-12s appends %.1f ms, per 4 KiB: p50 %6lld ns  p99 %6lld ns  "
+                "p99.9 %7lld ns  max %8lld ns\n", name, total.count(),
+                static_cast<long long>(latencies.value_at_percentile(50.0)),
+                static_cast<long long>(latencies.value_at_percentile(99.0)),
+                static_cast<long long>(latencies.value_at_percentile(99.9)),
+                static_cast<long long>(latencies.max()));
+    bench::keep(b.size());
+}
+
+void startup(const char* name, buffer& b, bool lock_pages) {
+    auto start = clock_type::now();
+    rttl::memory::report r = rttl::memory::prefault(b);
+    bool locked = lock_pages && rttl::memory::lock(b);
+    std::chrono::duration<double, std::milli> elapsed = clock_type::now() - start;
+    std::printf("%-12s startup %.1f ms: %zu pages touched, %zu MiB advised "
+                "huge, %s\n", name, elapsed.count(), r.pages_touched,
+                r.huge_page_bytes >> 20, locked ? "locked" : "not locked");
+}
+
+}
+
+int main() {
+    startup("prefaulted", s_prefaulted, false);
+    startup("locked", s_locked, true);
+    run("cold", s_cold);
+    run("prefaulted", s_prefaulted);
+    run("locked", s_locked);
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "rttl/bit.h"
+#include "rttl/packet_buffer.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Encapsulation of a payload in UDP, IPv4 and Ethernet headers by prepending
+/// into the headroom of `rttl::packet_buffer`, against inserting each header
+/// at the front of an `rttl::vector`
+
+namespace {
+
+constexpr std::size_t packets = 1 << 16;
+constexpr std::size_t mtu = 1500;
+
+using packet = rttl::packet_buffer<64, mtu>;
+using byte_vector = rttl::vector<std::uint8_t, 64 + mtu>;
+
+std::array<std::uint8_t, mtu> s_payload;
+
+template <typename Writer>
+void udp_header(Writer& w, std::size_t length) {
+    w.put_be(std::uint16_t{ 40000 }).put_be(std::uint16_t{ 9000 })
+     .put_be(static_cast<std::uint16_t>(length)).put_be(std::uint16_t{ 0 });
+}
+
+template <typename Writer>
+void ip_header(Writer& w, std::size_t length) {
+    w.put_be(std::uint16_t{ 0x4500 }).put_be(static_cast<std::uint16_t>(length))
+     .put_be(std::uint32_t{ 0 }).put_be(std::uint16_t{ 0x4011 })
+     .put_be(std::uint16_t{ 0 }).put_be(std::uint32_t{ 0x0A000001 })
+     .put_be(std::uint32_t{ 0x0A000002 });
+}
+
+template <typename Writer>
+void ethernet_header(Writer& w) {
+    const std::uint8_t mac[6] = { 0x02, 0, 0, 0, 0, 1 };
+    w.put(mac, 6).put(mac, 6).put_be(std::uint16_t{ 0x0800 });
+}
+
+/// Writer of big-endian integers into a byte array, for headers inserted into
+/// a vector
+struct array_writer {
+    std::uint8_t* p;
+
+    template <typename T>
+    array_writer& put_be(T value) noexcept {
+        rttl::detail::store_be(p, value);
+        p += sizeof(T);
+        return *this;
+    }
+
+    array_writer& put(const void* data, std::size_t count) noexcept {
+        std::memcpy(p, data, count);
+        p += count;
+        return *this;
+    }
+};
+
+void run(std::size_t payload_size) {
+    static packet s_packet;
+    static byte_vector s_vector;
+    bench::report("packet_buffer prepend", payload_size, bench::measure(packets, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < packets; ++i) {
+            s_packet.clear();
+            s_packet.append(s_payload.data(), payload_size);
+            auto udp = s_packet.push_header(8);
+            udp_header(udp, payload_size + 8);
+            auto ip = s_packet.push_header(20);
+            ip_header(ip, payload_size + 28);
+            auto eth = s_packet.push_header(14);
+            ethernet_header(eth);
+            total += s_packet.size();
+        }
+        bench::keep(total);
+    }));
+    bench::report("rttl::vector insert", payload_size, bench::measure(packets, [&] {
+        std::size_t total = 0;
+        std::array<std::uint8_t, 20> header;
+        for (std::size_t i = 0; i < packets; ++i) {
+            s_vector.clear();
+            s_vector.insert(s_vector.cend(), s_payload.begin(),
+                            s_payload.begin() + static_cast<std::ptrdiff_t>(payload_size));
+            array_writer udp{ header.data() };
+            udp_header(udp, payload_size + 8);
+            s_vector.insert(s_vector.cbegin(), header.begin(), header.begin() + 8);
+            array_writer ip{ header.data() };
+            ip_header(ip, payload_size + 28);
+            s_vector.insert(s_vector.cbegin(), header.begin(), header.begin() + 20);
+            array_writer eth{ header.data() };
+            ethernet_header(eth);
+            s_vector.insert(s_vector.cbegin(), header.begin(), header.begin() + 14);
+            total += s_vector.size();
+        }
+        bench::keep(total);
+    }));
+}
+
+}
+
+int main() {
+    run(64);
+    run(512);
+    run(1400);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "rttl/bit.h"
+#include "rttl/rank_select_bitset.h"
+#include "bench.h"
+
+/// `rank` and `select` of `rttl::rank_select_bitset<1M>` with 1%, 10% and 50%
+/// of bits set, against linear scans counting ones word by word
+
+namespace {
+
+constexpr std::size_t bits = 1 << 20;
+constexpr std::size_t queries = 1 << 12;
+
+using bitset = rttl::rank_select_bitset<bits>;
+
+bitset s_bitset;
+
+std::size_t scan_rank(const bitset& b, std::size_t pos) noexcept {
+    std::size_t result = 0;
+    std::size_t w = 0;
+    for (; w < pos / 64; ++w) {
+        result += static_cast<std::size_t>(rttl::popcount(b.words()[w]));
+    }
+    std::uint64_t mask = (std::uint64_t(1) << (pos % 64)) - 1;
+    return result + static_cast<std::size_t>(rttl::popcount(b.words()[w] & mask));
+}
+
+std::size_t scan_select(const bitset& b, std::size_t k) noexcept {
+    for (std::size_t w = 0; w < bitset::word_count; ++w) {
+        auto ones = static_cast<std::size_t>(rttl::popcount(b.words()[w]));
+        if (k < ones) {
+            return w * 64 + static_cast<std::size_t>(
+                rttl::detail::select_in_word(b.words()[w], static_cast<int>(k)));
+        }
+        k -= ones;
+    }
+    return bits;
+}
+
+void run(unsigned density) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<unsigned> percent(0, 99);
+    s_bitset.reset();
+    for (std::size_t i = 0; i < bits; ++i) {
+        if (percent(gen) < density) {
+            s_bitset.set(i);
+        }
+    }
+    s_bitset.rebuild();
+    std::uniform_int_distribution<std::size_t> pos(0, bits - 1);
+    std::uniform_int_distribution<std::size_t> rank(0, s_bitset.count() - 1);
+    std::vector<std::size_t> positions(queries);
+    std::vector<std::size_t> ranks(queries);
+    for (std::size_t i = 0; i < queries; ++i) {
+        positions[i] = pos(gen);
+        ranks[i] = rank(gen);
+    }
+    bench::report("rank", density, bench::measure(queries, [&] {
+        std::size_t sum = 0;
+        for (std::size_t p : positions) {
+            sum += s_bitset.rank(p);
+        }
+        bench::keep(sum);
+    }));
+    bench::report("popcount scan rank", density, bench::measure(queries, [&] {
+        std::size_t sum = 0;
+        for (std::size_t p : positions) {
+            sum += scan_rank(s_bitset, p);
+        }
+        bench::keep(sum);
+    }, 3));
+    bench::report("select", density, bench::measure(queries, [&] {
+        std::size_t sum = 0;
+        for (std::size_t k : ranks) {
+            sum += s_bitset.select(k);
+        }
+        bench::keep(sum);
+    }));
+    bench::report("popcount scan select", density, bench::measure(queries, [&] {
+        std::size_t sum = 0;
+        for (std::size_t k : ranks) {
+            sum += scan_select(s_bitset, k);
+        }
+        bench::keep(sum);
+    }, 3));
+}
+
+}
+
+int main() {
+    /// Second column is the percentage of set bits
+    run(1);
+    run(10);
+    run(50);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "rttl/algorithm.h"
+#include "rttl/roaring_bitmap.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Memory and set operations of `rttl::roaring_bitmap` against sorted
+/// `rttl::vector` sets with `rttl::set_intersect` and friends, for sets
+/// clustered in arrays, dense in bitmaps, made of runs, and spread over the
+/// whole 32-bit space with a container per value. Roaring operations are in
+/// place, so their time includes copying the left operand first
+
+namespace {
+
+constexpr std::size_t max_containers = 4096;
+constexpr std::size_t max_values = 1 << 21;
+
+using bitmap = rttl::roaring_bitmap<max_containers>;
+using set = rttl::vector<std::uint32_t, max_values>;
+
+bitmap s_a;
+bitmap s_b;
+bitmap s_result;
+set s_va;
+set s_vb;
+set s_out;
+
+/// `n` values of `[0, universe)`, in runs of `run` consecutive values
+void make(set& s, std::size_t n, std::uint64_t universe, std::uint32_t run,
+          unsigned seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<std::uint64_t> dist(0, universe / run - 1);
+    s.clear();
+    while (s.size() < n) {
+        auto first = static_cast<std::uint32_t>(dist(gen) * run);
+        for (std::uint32_t i = 0; i < run; ++i) {
+            s.push_back(first + i);
+        }
+    }
+    std::sort(s.begin(), s.end());
+    s.erase(std::unique(s.begin(), s.end()), s.end());
+}
+
+void fill(bitmap& b, const set& s) {
+    b.clear();
+    for (std::uint32_t x : s) {
+        b.add(x);
+    }
+    b.run_optimize();
+}
+
+template <typename Operation>
+double roaring_op(Operation op) {
+    return bench::measure(s_va.size() + s_vb.size(), [&] {
+        s_result.clear();
+        s_result |= s_a;
+        op(s_result);
+        bench::keep(s_result.container_count());
+    }, 10);
+}
+
+template <typename Operation>
+double vector_op(Operation op) {
+    return bench::measure(s_va.size() + s_vb.size(), [&] {
+        s_out.clear();
+        op(s_out);
+        bench::keep(s_out.size());
+    }, 10);
+}
+
+void run(const char* name, std::size_t n, std::uint64_t universe,
+         std::uint32_t run) {
+    make(s_va, n, universe, run, 1);
+    make(s_vb, n, universe, run, 2);
+    fill(s_a, s_va);
+    fill(s_b, s_vb);
+    std::printf("%s: %zu values, %zu containers, %zu KiB of pool, "
+                "%zu KiB serialized, %zu KiB as a vector\n", name, s_va.size(),
+                s_a.container_count(), s_a.container_count() * 8,
+                s_a.serialized_size() / 1024, s_va.size() * 4 / 1024);
+    const std::size_t ops = s_va.size() + s_vb.size();
+    bench::report("roaring copy", ops, roaring_op([](bitmap&) {}));
+    bench::report("roaring and", ops, roaring_op([](bitmap& r) { r &= s_b; }));
+    bench::report("vector set_intersect", ops, vector_op([](set& out) {
+        rttl::set_intersect(s_va, s_vb, out);
+    }));
+    bench::report("roaring or", ops, roaring_op([](bitmap& r) { r |= s_b; }));
+    bench::report("vector set_union", ops, vector_op([](set& out) {
+        rttl::set_union(s_va, s_vb, out);
+    }));
+    bench::report("roaring andnot", ops, roaring_op([](bitmap& r) { r -= s_b; }));
+    bench::report("vector set_difference", ops, vector_op([](set& out) {
+        rttl::set_difference(s_va, s_vb, out);
+    }));
+    bench::report("roaring cardinality", s_va.size(), bench::measure(s_va.size(), [&] {
+        bench::keep(s_a.cardinality());
+    }));
+    bench::report("roaring for_each", s_va.size(), bench::measure(s_va.size(), [&] {
+        std::uint64_t sum = 0;
+        s_a.for_each([&sum](std::uint32_t x) { sum += x; });
+        bench::keep(sum);
+    }));
+    bench::report("vector iterate", s_va.size(), bench::measure(s_va.size(), [&] {
+        std::uint64_t sum = 0;
+        for (std::uint32_t x : s_va) {
+            sum += x;
+        }
+        bench::keep(sum);
+    }));
+}
+
+}
+
+int main() {
+    /// Arrays of about 400 values per chunk
+    run("clustered", 100000, 1 << 24, 1);
+    /// Bitmaps of about 32768 values per chunk
+    run("dense", 1 << 20, 1 << 21, 1);
+    /// Runs of 64 values, about one per chunk
+    run("runs", 1 << 16, std::uint64_t(1) << 26, 64);
+    /// One value per chunk
+    run("spread", 2000, std::uint64_t(1) << 32, 1);
+    return 0;
+}
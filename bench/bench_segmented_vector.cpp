@@ -0,0 +1,86 @@
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include "rttl/segmented_vector.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Appending and iterating 1M `std::uint64_t` in `rttl::segmented_vector`
+/// with segments of 4096 elements, against `rttl::vector` and `std::deque`
+
+namespace {
+
+constexpr std::size_t count = 1 << 20;
+constexpr std::size_t segment_size = 4096;
+
+using segmented = rttl::segmented_vector<std::uint64_t, segment_size,
+                                         count / segment_size>;
+
+rttl::vector<std::uint64_t, count> s_vector;
+
+/// With `Release`, storage is given back before every run
+template <bool Release, typename Container>
+double append(Container& c) {
+    return bench::measure(count, [&] {
+        c.clear();
+        if constexpr (Release) {
+            c.shrink_to_fit();
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            c.push_back(i);
+        }
+        bench::keep(c.back());
+    });
+}
+
+template <typename Container>
+double iterate(const Container& c) {
+    return bench::measure(count, [&] {
+        std::uint64_t sum = 0;
+        for (std::uint64_t x : c) {
+            sum += x;
+        }
+        bench::keep(sum);
+    });
+}
+
+template <typename Container>
+double index(const Container& c) {
+    return bench::measure(count, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            sum += c[(i * 4099) & (count - 1)];
+        }
+        bench::keep(sum);
+    });
+}
+
+}
+
+int main() {
+    segmented s;
+    std::deque<std::uint64_t> d;
+    bench::report("segmented_vector append", count, append<false>(s));
+    bench::report("  with segments released", count, append<true>(s));
+    bench::report("rttl::vector append", count, append<false>(s_vector));
+    bench::report("std::deque append", count, append<false>(d));
+    bench::report("  with blocks released", count, append<true>(d));
+
+    bench::report("segmented_vector iterate", count, iterate(s));
+    bench::report("  for_each_segment", count, bench::measure(count, [&] {
+        std::uint64_t sum = 0;
+        s.for_each_segment([&sum](const std::uint64_t* first, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += first[i];
+            }
+        });
+        bench::keep(sum);
+    }));
+    bench::report("rttl::vector iterate", count, iterate(s_vector));
+    bench::report("std::deque iterate", count, iterate(d));
+
+    bench::report("segmented_vector index", count, index(s));
+    bench::report("rttl::vector index", count, index(s_vector));
+    bench::report("std::deque index", count, index(d));
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "rttl/algorithm.h"
+#include "bench.h"
+
+/// `rttl::set_intersect`, `set_union`, `set_difference` and the count-only
+/// intersection of sorted `std::uint32_t` sets, against `std::set_*`
+/// algorithms writing into a preallocated buffer, on balanced and skewed sizes
+
+namespace {
+
+using set = std::vector<std::uint32_t>;
+
+rttl::vector<std::uint32_t, (1 << 21)> s_out;
+
+/// `n` distinct values drawn from `[0, universe)`
+set make_set(std::size_t n, std::uint32_t universe, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::uint32_t> dist(0, universe - 1);
+    set s;
+    while (s.size() < n) {
+        s.push_back(dist(gen));
+        if (s.size() == n) {
+            std::sort(s.begin(), s.end());
+            s.erase(std::unique(s.begin(), s.end()), s.end());
+        }
+    }
+    return s;
+}
+
+void run(const char* name, const set& a, const set& b) {
+    const std::size_t ops = a.size() + b.size();
+    std::vector<std::uint32_t> out(ops);
+    std::printf("%s: %zu and %zu elements\n", name, a.size(), b.size());
+    bench::report("rttl::set_intersect", ops, bench::measure(ops, [&] {
+        s_out.clear();
+        rttl::set_intersect(a, b, s_out);
+        bench::keep(s_out.size());
+    }));
+    bench::report("set_intersect_count", ops, bench::measure(ops, [&] {
+        bench::keep(rttl::set_intersect_count(a, b));
+    }));
+    bench::report("std::set_intersection", ops, bench::measure(ops, [&] {
+        auto last = std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                          out.begin());
+        bench::keep(last - out.begin());
+    }));
+    bench::report("rttl::set_union", ops, bench::measure(ops, [&] {
+        s_out.clear();
+        rttl::set_union(a, b, s_out);
+        bench::keep(s_out.size());
+    }));
+    bench::report("std::set_union", ops, bench::measure(ops, [&] {
+        auto last = std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                                   out.begin());
+        bench::keep(last - out.begin());
+    }));
+    bench::report("rttl::set_difference", ops, bench::measure(ops, [&] {
+        s_out.clear();
+        rttl::set_difference(a, b, s_out);
+        bench::keep(s_out.size());
+    }));
+    bench::report("std::set_difference", ops, bench::measure(ops, [&] {
+        auto last = std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                                        out.begin());
+        bench::keep(last - out.begin());
+    }));
+}
+
+}
+
+int main() {
+    /// About half of the elements of each are in the other
+    run("balanced", make_set(1 << 16, 1 << 17, 1), make_set(1 << 16, 1 << 17, 2));
+    /// 1:1000, beyond the galloping ratio
+    run("skewed", make_set(1 << 10, 1 << 24, 3), make_set(1 << 20, 1 << 24, 4));
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "rttl/sketch.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Updates of `rttl::hyperloglog`, `count_min` and `heavy_hitters` with 1M
+/// symbol strings drawn from a Zipf distribution over 1k to 1M symbols,
+/// against exact `std::unordered_set` and `std::unordered_map` counting; and
+/// the measured error of estimates against the exact counts
+
+namespace {
+
+constexpr std::size_t stream_length = 1 << 20;
+
+using symbol = rttl::string<16>;
+using hll_10 = rttl::hyperloglog<10>;
+using hll_14 = rttl::hyperloglog<14>;
+using cms = rttl::count_min<4096, 4>;
+using hitters = rttl::heavy_hitters<symbol, 10, 4096, 4>;
+
+/// Ids of the stream, id `0` being the most frequent
+std::vector<std::uint32_t> make_stream(std::size_t symbols) {
+    std::vector<double> weights(symbols);
+    for (std::size_t i = 0; i < symbols; ++i) {
+        weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), 1.1);
+    }
+    std::discrete_distribution<std::uint32_t> zipf(weights.begin(), weights.end());
+    std::mt19937 gen(42);
+    std::vector<std::uint32_t> ids(stream_length);
+    for (std::uint32_t& id : ids) {
+        id = zipf(gen);
+    }
+    return ids;
+}
+
+symbol name_of(std::uint32_t id) {
+    symbol s("SYM.");
+    s.append(std::to_string(id * 2654435761u).c_str());
+    return s;
+}
+
+template <typename Sketch>
+double hll_error(const std::vector<symbol>& stream, std::size_t distinct) {
+    auto sketch = std::make_unique<Sketch>();
+    for (const symbol& s : stream) {
+        sketch->add(s);
+    }
+    return (sketch->estimate() - static_cast<double>(distinct)) /
+           static_cast<double>(distinct);
+}
+
+void run(std::size_t symbols) {
+    const std::vector<std::uint32_t> ids = make_stream(symbols);
+    std::vector<symbol> stream(stream_length);
+    for (std::size_t i = 0; i < stream_length; ++i) {
+        stream[i] = name_of(ids[i]);
+    }
+    std::unordered_map<std::uint32_t, std::uint32_t> exact;
+    for (std::uint32_t id : ids) {
+        ++exact[id];
+    }
+    std::printf("%zu symbols, %zu distinct in the stream\n", symbols, exact.size());
+
+    auto hll = std::make_unique<hll_14>();
+    bench::report("hyperloglog<14> add", symbols, bench::measure(stream_length, [&] {
+        hll->clear();
+        for (const symbol& s : stream) {
+            hll->add(s);
+        }
+        bench::keep(hll->registers()[0]);
+    }, 5));
+    bench::report("unordered_set insert", symbols, bench::measure(stream_length, [&] {
+        std::unordered_set<std::string> set;
+        for (const symbol& s : stream) {
+            set.emplace(s.data(), s.size());
+        }
+        bench::keep(set.size());
+    }, 5));
+    auto sketch = std::make_unique<cms>();
+    bench::report("count_min<4096, 4> add", symbols, bench::measure(stream_length, [&] {
+        sketch->clear();
+        for (const symbol& s : stream) {
+            sketch->add(s);
+        }
+        bench::keep(sketch->total());
+    }, 5));
+    bench::report("unordered_map count", symbols, bench::measure(stream_length, [&] {
+        std::unordered_map<std::string, std::uint32_t> map;
+        for (const symbol& s : stream) {
+            ++map[std::string(s.data(), s.size())];
+        }
+        bench::keep(map.size());
+    }, 5));
+    auto top = std::make_unique<hitters>();
+    bench::report("heavy_hitters<10> add", symbols, bench::measure(stream_length, [&] {
+        top->clear();
+        for (const symbol& s : stream) {
+            top->add(s);
+        }
+        bench::keep(top->sketch().total());
+    }, 5));
+
+    std::printf("  hyperloglog<10> error %+.2f%%, <14> %+.2f%%, "
+                "expected %.2f%% and %.2f%%\n",
+                100 * hll_error<hll_10>(stream, exact.size()),
+                100 * hll_error<hll_14>(stream, exact.size()),
+                100 * 1.04 / std::sqrt(1024.0), 100 * 1.04 / std::sqrt(16384.0));
+    /// Overestimates of every symbol seen, relative to the stream length
+    double bound = std::exp(1.0) / cms::width * stream_length;
+    double sum = 0;
+    double worst = 0;
+    std::size_t beyond = 0;
+    for (const auto& [id, count] : exact) {
+        double over = sketch->estimate(name_of(id)) - double(count);
+        sum += over;
+        worst = std::max(worst, over);
+        beyond += (over > bound) ? 1 : 0;
+    }
+    std::printf("  count_min overestimate mean %.1f, max %.0f, bound e/W*N %.0f "
+                "exceeded for %zu of %zu\n", sum / static_cast<double>(exact.size()),
+                worst, bound, beyond, exact.size());
+    rttl::vector<hitters::entry, 10> found;
+    top->top(found);
+    std::size_t recall = 0;
+    for (const auto& e : found) {
+        for (std::uint32_t id = 0; id < 10; ++id) {
+            recall += (e.key == name_of(id)) ? 1 : 0;
+        }
+    }
+    std::printf("  heavy_hitters found %zu of the true top 10\n", recall);
+}
+
+}
+
+int main() {
+    /// Second column is the number of symbols
+    run(1000);
+    run(100000);
+    run(1000000);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include "rttl/sliding_window.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Per-tick cost of pushing a sample and querying min, max and mean of the
+/// last N samples, against rescanning a ring of N samples on every tick
+
+namespace {
+
+constexpr std::size_t sample_count = 4096;
+
+std::array<double, sample_count> s_samples;
+
+void make_samples() {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> step(0.0, 0.01);
+    double price = 100.0;
+    for (double& sample : s_samples) {
+        price += step(gen);
+        sample = price;
+    }
+}
+
+double sample(std::size_t tick) noexcept {
+    return s_samples[tick % sample_count];
+}
+
+template <std::size_t N>
+void run() {
+    using window = rttl::sliding_window<double, N, rttl::window_min,
+                                        rttl::window_max, rttl::window_sum>;
+    static window s_window;
+    static rttl::vector<double, N> s_ring;
+    /// Rescanning costs `O(N)`, so it gets fewer ticks
+    const std::size_t ticks = 1 << 16;
+    const std::size_t rescan_ticks = std::max<std::size_t>(64, (1 << 22) / N);
+
+    for (std::size_t i = 0; i < N; ++i) {
+        s_window.push(sample(i));
+        s_ring.push_back(sample(i));
+    }
+    std::size_t tick = N;
+    bench::report("rttl::sliding_window", N, bench::measure(ticks, [&] {
+        double acc = 0;
+        for (std::size_t i = 0; i < ticks; ++i, ++tick) {
+            s_window.push(sample(tick));
+            acc += s_window.min() + s_window.max() + s_window.mean();
+        }
+        bench::keep(acc);
+    }));
+    tick = N;
+    bench::report("rescan rttl::vector", N, bench::measure(rescan_ticks, [&] {
+        double acc = 0;
+        for (std::size_t i = 0; i < rescan_ticks; ++i, ++tick) {
+            s_ring[tick % N] = sample(tick);
+            auto [min, max] = std::minmax_element(s_ring.begin(), s_ring.end());
+            double sum = 0;
+            for (double x : s_ring) {
+                sum += x;
+            }
+            acc += *min + *max + sum / static_cast<double>(N);
+        }
+        bench::keep(acc);
+    }));
+}
+
+}
+
+int main() {
+    make_samples();
+    run<64>();
+    run<512>();
+    run<4096>();
+    run<65536>();
+    return 0;
+}
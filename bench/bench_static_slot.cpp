@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "rttl/static_slot.h"
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Reading a large table through a function-local static, which checks its
+/// guard variable on every call, against `rttl::static_slot` and a plain
+/// global; and the time the dynamic initialization of such a global adds
+/// before `main`, which a slot moves to its `emplace`
+
+namespace {
+
+constexpr std::size_t table_size = 1 << 22;
+constexpr std::size_t reads = 1 << 20;
+/// Reads stay within the first 4 KB, to time the access rather than misses
+constexpr std::size_t hot_size = 1024;
+
+/// Filled by its constructor, so that a static of this type has a guard
+struct lookup_table {
+    lookup_table() {
+        for (std::size_t i = 0; i < table_size; ++i) {
+            values.push_back(static_cast<std::uint32_t>(i * 2654435761u));
+        }
+    }
+
+    rttl::vector<std::uint32_t, table_size> values;
+};
+
+/// Globals of a translation unit are initialized in order of definition
+const auto s_before_global = std::chrono::steady_clock::now();
+lookup_table s_global;
+const std::chrono::duration<double, std::nano> s_global_init =
+    std::chrono::steady_clock::now() - s_before_global;
+
+rttl::static_slot<lookup_table> s_slot;
+
+lookup_table& local_table() {
+    static lookup_table table;
+    return table;
+}
+
+BENCH_NOINLINE lookup_table& local_table_call() {
+    return local_table();
+}
+
+BENCH_NOINLINE lookup_table& slot_call() {
+    return *s_slot;
+}
+
+template <typename Table>
+double read(Table table) {
+    return bench::measure(reads, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < reads; ++i) {
+            sum += table().values[(i * 7) & (hot_size - 1)];
+        }
+        bench::keep(sum);
+    });
+}
+
+}
+
+int main() {
+    auto start = std::chrono::steady_clock::now();
+    s_slot.emplace();
+    std::chrono::duration<double, std::nano> emplace =
+        std::chrono::steady_clock::now() - start;
+    local_table();
+
+    bench::report("function-local static", reads,
+                  read([]() -> lookup_table& { return local_table(); }));
+    bench::report("static_slot", reads,
+                  read([]() -> lookup_table& { return *s_slot; }));
+    bench::report("global", reads,
+                  read([]() -> lookup_table& { return s_global; }));
+    bench::report("  not inlined, local", reads, read(local_table_call));
+    bench::report("  not inlined, slot", reads, read(slot_call));
+
+    /// One table of 16 MB, the time is per process, not per operation
+    bench::report("global before main", 1, s_global_init.count());
+    bench::report("static_slot before main", 1, 0);
+    bench::report("static_slot emplace", 1, emplace.count());
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include "rttl/string.h"
+#include "bench.h"
+
+/// `find` and `rfind` of `rttl::string<4096>` with the SIMD search, against
+/// `std::string_view`, which the string delegated to before, for needles of
+/// 2..64 characters on random text and on a repetitive worst case
+
+namespace {
+
+constexpr std::size_t text_length = 4000;
+constexpr std::size_t calls = 1 << 12;
+
+using text = rttl::string<4096>;
+
+/// Lowercase letters and spaces with English-like frequencies of vowels
+text random_text() {
+    std::mt19937 gen(42);
+    const char letters[] = "eeeeettttaaaooiinnsshhrrdlcumwfgypbvk    ";
+    std::uniform_int_distribution<std::size_t> pick(0, sizeof(letters) - 2);
+    text t;
+    for (std::size_t i = 0; i < text_length; ++i) {
+        t.push_back(letters[pick(gen)]);
+    }
+    return t;
+}
+
+void run(const char* name, const text& hay, std::string_view needle) {
+    const std::string_view view(hay.data(), hay.length());
+    std::string label(name);
+    bench::report((label + " find").c_str(), needle.length(), bench::measure(calls, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += hay.find(needle, bench::opaque<std::size_t>(0));
+        }
+        bench::keep(sum);
+    }));
+    bench::report((label + " find, std").c_str(), needle.length(), bench::measure(calls, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += view.find(needle, bench::opaque<std::size_t>(0));
+        }
+        bench::keep(sum);
+    }));
+    bench::report((label + " rfind").c_str(), needle.length(), bench::measure(calls, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += hay.rfind(needle, bench::opaque(text::npos));
+        }
+        bench::keep(sum);
+    }));
+    bench::report((label + " rfind, std").c_str(), needle.length(), bench::measure(calls, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < calls; ++i) {
+            sum += view.rfind(needle, bench::opaque(text::npos));
+        }
+        bench::keep(sum);
+    }));
+}
+
+}
+
+int main() {
+    const text words = random_text();
+    /// Absent needles, so the whole text is scanned
+    const text repetitive(text_length, 'a');
+    for (std::size_t m : { 2u, 4u, 8u, 16u, 32u, 64u }) {
+        std::string needle(words.data() + 1000, m);
+        needle.back() = 'z';
+        run("text", words, needle);
+        std::string worst(m - 1, 'a');
+        worst.push_back('b');
+        run("aaa..ab", repetitive, worst);
+    }
+    return 0;
+}
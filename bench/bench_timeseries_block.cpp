@@ -0,0 +1,99 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+#include "rttl/timeseries_block.h"
+#include "bench.h"
+
+/// Compression ratio, encode and decode speed of Gorilla blocks of 4 KiB on
+/// synthetic market data, against storing raw 16-byte points
+
+namespace {
+
+constexpr std::size_t point_count = 1 << 16;
+
+using point = std::pair<std::uint64_t, double>;
+using block = rttl::timeseries_block<4096>;
+
+/// Prices of a random walk on a tick grid of 0.01, mostly unchanged
+std::vector<point> make_points(std::uint64_t interval, std::uint64_t jitter) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> move(-1, 1);
+    std::bernoulli_distribution changes(0.3);
+    std::uniform_int_distribution<std::uint64_t> delay(0, jitter);
+    std::vector<point> points(point_count);
+    std::uint64_t timestamp = 1700000000ULL * 1000000000ULL;
+    long ticks = 10000;
+    for (point& p : points) {
+        timestamp += interval + delay(gen);
+        if (changes(gen)) {
+            ticks += move(gen);
+        }
+        p = point(timestamp, static_cast<double>(ticks) / 100.0);
+    }
+    return points;
+}
+
+void run(const char* name, const std::vector<point>& points) {
+    /// A point takes less than 160 bits, so this many blocks always suffice
+    static block s_blocks[point_count / 128];
+    static point s_raw[point_count];
+    std::size_t blocks = 0;
+
+    double encode = bench::measure(point_count, [&] {
+        blocks = 0;
+        s_blocks[0].clear();
+        for (const point& p : points) {
+            if (!s_blocks[blocks].append(p.first, p.second)) {
+                s_blocks[++blocks].clear();
+                s_blocks[blocks].append(p.first, p.second);
+            }
+        }
+        ++blocks;
+    });
+    std::size_t bits = 0;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        bits += s_blocks[i].bit_size();
+    }
+    double decode = bench::measure(point_count, [&] {
+        double sum = 0;
+        for (std::size_t i = 0; i < blocks; ++i) {
+            for (const point& p : s_blocks[i]) {
+                sum += p.second;
+            }
+        }
+        bench::keep(sum);
+    });
+    double raw_encode = bench::measure(point_count, [&] {
+        for (std::size_t i = 0; i < point_count; ++i) {
+            s_raw[i] = points[i];
+        }
+        bench::keep(s_raw[point_count - 1].first);
+    });
+    double raw_decode = bench::measure(point_count, [&] {
+        double sum = 0;
+        for (const point& p : s_raw) {
+            sum += p.second;
+        }
+        bench::keep(sum);
+    });
+    std::printf("%s: %.2f bits/point, compression ratio %.1f\n", name,
+                static_cast<double>(bits) / point_count,
+                128.0 * point_count / static_cast<double>(bits));
+    bench::report("timeseries_block append", point_count, encode);
+    bench::report("timeseries_block decode", point_count, decode);
+    bench::report("raw points append", point_count, raw_encode);
+    bench::report("raw points decode", point_count, raw_decode);
+}
+
+}
+
+int main() {
+    /// One second bars, and quotes about every millisecond in nanoseconds
+    run("1 s bars", make_points(1000000000, 0));
+    run("quotes", make_points(1000000, 200000));
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <vector>
+#include "rttl/string.h"
+#include "rttl/timestamp.h"
+#include "bench.h"
+
+/// Formatting and parsing nanosecond ISO-8601 timestamps with
+/// `rttl::timestamp_formatter`, `format_timestamp` and `parse_timestamp`,
+/// against `gmtime_r`, `strftime` and `snprintf` of the fraction, and
+/// `strptime`, `timegm` and `strtol`; for a log-like sequence a microsecond
+/// apart and for times spread over decades
+
+namespace {
+
+constexpr std::size_t count = 4096;
+constexpr std::int64_t nanos_per_second = 1000000000;
+
+using text = rttl::string<32>;
+
+std::vector<std::int64_t> make_times(bool spread) {
+    std::mt19937_64 gen(42);
+    /// From 2000 to 2040
+    std::uniform_int_distribution<std::int64_t> any(946684800 * nanos_per_second,
+                                                    2208988800 * nanos_per_second);
+    std::uniform_int_distribution<std::int64_t> step(0, 2000);
+    std::vector<std::int64_t> times(count);
+    std::int64_t t = 1710495000 * nanos_per_second;
+    for (std::int64_t& time : times) {
+        t += step(gen);
+        time = spread ? any(gen) : t;
+    }
+    return times;
+}
+
+void strftime_format(std::int64_t nanos, text& out) {
+    std::time_t seconds = nanos / nanos_per_second;
+    std::tm tm;
+    ::gmtime_r(&seconds, &tm);
+    char buffer[40];
+    std::size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(buffer + n, sizeof(buffer) - n, ".%09dZ",
+                  static_cast<int>(nanos % nanos_per_second));
+    out.assign(buffer);
+}
+
+bool strptime_parse(const text& str, std::int64_t& nanos) {
+    std::tm tm = {};
+    const char* rest = ::strptime(str.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+    if (rest == nullptr || *rest != '.') {
+        return false;
+    }
+    char* end = nullptr;
+    long fraction = std::strtol(rest + 1, &end, 10);
+    if (end != rest + 10 || *end != 'Z') {
+        return false;
+    }
+    std::int64_t seconds = ::timegm(&tm);
+    nanos = seconds * nanos_per_second + fraction;
+    return true;
+}
+
+void run(const char* name, bool spread) {
+    const std::vector<std::int64_t> times = make_times(spread);
+    std::printf("%s\n", name);
+    text out;
+    bench::report("timestamp_formatter", count, bench::measure(count, [&] {
+        rttl::timestamp_formatter<> formatter;
+        std::size_t sum = 0;
+        for (std::int64_t t : times) {
+            formatter.format(t, out);
+            sum += static_cast<unsigned char>(out[28]);
+        }
+        bench::keep(sum);
+    }));
+    bench::report("format_timestamp", count, bench::measure(count, [&] {
+        std::size_t sum = 0;
+        for (std::int64_t t : times) {
+            rttl::format_timestamp(t, out);
+            sum += static_cast<unsigned char>(out[28]);
+        }
+        bench::keep(sum);
+    }));
+    bench::report("strftime and snprintf", count, bench::measure(count, [&] {
+        std::size_t sum = 0;
+        for (std::int64_t t : times) {
+            strftime_format(t, out);
+            sum += static_cast<unsigned char>(out[28]);
+        }
+        bench::keep(sum);
+    }));
+
+    std::vector<text> texts(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        rttl::format_timestamp(times[i], texts[i]);
+    }
+    bench::report("parse_timestamp", count, bench::measure(count, [&] {
+        std::int64_t sum = 0;
+        for (const text& t : texts) {
+            std::int64_t nanos = 0;
+            rttl::parse_timestamp(t, nanos);
+            sum += nanos;
+        }
+        bench::keep(sum);
+    }));
+    bench::report("strptime and timegm", count, bench::measure(count, [&] {
+        std::int64_t sum = 0;
+        for (const text& t : texts) {
+            std::int64_t nanos = 0;
+            strptime_parse(t, nanos);
+            sum += nanos;
+        }
+        bench::keep(sum);
+    }));
+}
+
+}
+
+int main() {
+    run("log-like, 1 us apart", false);
+    run("spread over 2000..2040", true);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "rttl/vector.h"
+#include "bench.h"
+
+/// Lookups in `std::unordered_map` keyed by `rttl::vector<std::uint32_t, 8>`
+/// with the bulk `std::hash` specialization, against a hand-written hasher
+/// combining element hashes, and against `std::vector` keys
+
+namespace {
+
+constexpr std::size_t key_count = 1 << 16;
+constexpr std::size_t lookups = 1 << 18;
+
+using key = rttl::vector<std::uint32_t, 8>;
+
+/// The per-element loop used before `std::hash` was specialized
+struct combining_hash {
+    template <typename Range>
+    std::size_t operator()(const Range& r) const noexcept {
+        std::size_t h = r.size();
+        for (std::uint32_t x : r) {
+            h ^= std::hash<std::uint32_t>{}(x) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+};
+
+template <typename Map, typename Keys>
+double lookup(const Keys& keys) {
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.emplace(keys[i], static_cast<int>(i));
+    }
+    return bench::measure(lookups, [&] {
+        long sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            sum += map.find(keys[(i * 7919) % keys.size()])->second;
+        }
+        bench::keep(sum);
+    });
+}
+
+template <typename Hash, typename Keys>
+double hash_only(const Keys& keys) {
+    return bench::measure(lookups, [&] {
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i) {
+            sum += Hash{}(keys[i % keys.size()]);
+        }
+        bench::keep(sum);
+    });
+}
+
+void run(std::size_t length) {
+    std::mt19937 gen(42);
+    std::vector<key> keys(key_count);
+    std::vector<std::vector<std::uint32_t>> std_keys(key_count);
+    for (std::size_t i = 0; i < key_count; ++i) {
+        for (std::size_t k = 0; k < length; ++k) {
+            keys[i].push_back(static_cast<std::uint32_t>(gen()));
+        }
+        std_keys[i].assign(keys[i].begin(), keys[i].end());
+    }
+    bench::report("std::hash<rttl::vector>", length,
+                  hash_only<std::hash<key>>(keys));
+    bench::report("combining hash", length, hash_only<combining_hash>(keys));
+    bench::report("find, std::hash", length,
+                  lookup<std::unordered_map<key, int>>(keys));
+    bench::report("find, combining hash", length,
+                  lookup<std::unordered_map<key, int, combining_hash>>(keys));
+    bench::report("find, std::vector key", length,
+                  lookup<std::unordered_map<std::vector<std::uint32_t>, int,
+                                            combining_hash>>(std_keys));
+}
+
+}
+
+int main() {
+    run(2);
+    run(4);
+    run(8);
+    return 0;
+}
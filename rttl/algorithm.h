@@ -0,0 +1,751 @@
+/**
+ * @file rttl/algorithm.h
+ *
+ * Algorithms on sorted ranges that write into `rttl::vector` without dynamic
+ * memory allocation.
+ *
+ * K-way merge:
+ *  - `rttl::kway_merger` is a lazy merge of `K` sorted ranges; `K` is a
+ *    template argument, so the loser (tournament) tree of `K` nodes is stored
+ *    within the object and no allocation takes place;
+ *  - each step costs `O(log K)` comparisons, i.e. every element is moved once
+ *    instead of `O(log K)` times as with pairwise `std::merge`;
+ *  - `rttl::kway_merge` and `rttl::stable_kway_merge` append the merged
+ *    sequence to an `rttl::vector`, checking its capacity once; the stable
+ *    flavour keeps elements from preceding inputs first among equivalent ones,
+ *    like `std::merge` does for two inputs.
+ *
+ * Sorted sets of integers:
+ *  - `rttl::set_intersect`, `rttl::set_union` and `rttl::set_difference` take
+ *    contiguous ranges of integers sorted in ascending order and without
+ *    duplicates, e.g. lists of ids, and append the result to an `rttl::vector`;
+ *  - capacity is checked once, against the largest possible result size, or,
+ *    if that does not fit, against the exact size counted beforehand;
+ *  - with SSE2, intersection and difference of 32-bit integers compare blocks
+ *    of 4 elements of one range with 4 of the other at once, and of 16-bit
+ *    integers blocks of 8 with 8;
+ *  - when one range is more than `set_gallop_ratio` times longer than the
+ *    other, its elements are skipped by galloping (exponential search);
+ *  - `_count` variants compute the result size only, without writing it.
+ *
+ */
+#ifndef RTTL_ALGORITHM_H_
+#define RTTL_ALGORITHM_H_
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "rttl/bit.h"
+#include "rttl/simd.h"
+#include "rttl/vector.h"
+
+namespace rttl {
+
+/**
+ * Lazy merge of `K` sorted ranges.
+ *
+ * The ranges are given as pairs of iterators and are not copied. Each of them
+ * must be sorted with respect to `Compare`. When `Stable` is `true`, among
+ * equivalent elements those from the range with lower index come first.
+ */
+template <typename InputIt, std::size_t K, typename Compare = std::less<>,
+          bool Stable = false>
+class kway_merger {
+    static_assert(K > 0, "At least one range is required");
+public:
+
+    /// @section Member types
+
+    using value_type = typename std::iterator_traits<InputIt>::value_type;
+    using reference = typename std::iterator_traits<InputIt>::reference;
+    using size_type = std::size_t;
+
+    /**
+     * Input iterator over the merged sequence; incrementing it advances the
+     * merger itself.
+     */
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename kway_merger::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::iterator_traits<InputIt>::pointer;
+        using reference = typename kway_merger::reference;
+
+        iterator() noexcept = default;
+
+        explicit iterator(kway_merger* merger) noexcept : m_merger(merger) {}
+
+        reference operator*() const {
+            return m_merger->top();
+        }
+
+        iterator& operator++() {
+            m_merger->pop();
+            return *this;
+        }
+
+        void operator++(int) {
+            m_merger->pop();
+        }
+
+        bool operator==(const iterator& other) const {
+            return at_end() == other.at_end();
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        bool at_end() const {
+            return (m_merger == nullptr) || m_merger->empty();
+        }
+
+        kway_merger* m_merger = nullptr;
+    };
+
+    /// @section Member functions
+
+    /**
+     * @name (constructor)
+     */
+    ///{
+    kway_merger(const std::array<InputIt, K>& first,
+                const std::array<InputIt, K>& last,
+                Compare comp = Compare())
+        : m_first(first), m_last(last), m_comp(comp) {
+        build();
+    }
+
+    template <typename Range>
+    explicit kway_merger(const std::array<Range, K>& ranges,
+                         Compare comp = Compare())
+        : m_comp(comp) {
+        for (size_type i = 0; i < K; ++i) {
+            m_first[i] = std::cbegin(ranges[i]);
+            m_last[i] = std::cend(ranges[i]);
+        }
+        build();
+    }
+    ///}
+
+    [[nodiscard]] bool empty() const {
+        return m_first[m_tree[0]] == m_last[m_tree[0]];
+    }
+
+    /**
+     * Returns the number of remaining elements; `O(K)` for random access
+     * iterators.
+     */
+    size_type size() const {
+        size_type result = 0;
+        for (size_type i = 0; i < K; ++i) {
+            result += static_cast<size_type>(std::distance(m_first[i],
+                                                           m_last[i]));
+        }
+        return result;
+    }
+
+    /**
+     * Returns the least remaining element; the merger must not be empty.
+     */
+    reference top() const {
+        return *m_first[m_tree[0]];
+    }
+
+    /**
+     * Index of the range the least remaining element comes from.
+     */
+    size_type top_index() const noexcept {
+        return m_tree[0];
+    }
+
+    /**
+     * Removes the least remaining element; the merger must not be empty.
+     */
+    void pop() {
+        size_type winner = m_tree[0];
+        ++m_first[winner];
+        /// Replay the matches on the path from the leaf to the root
+        for (size_type node = (winner + K) / 2; node > 0; node /= 2) {
+            if (less(m_tree[node], winner)) {
+                std::swap(m_tree[node], winner);
+            }
+        }
+        m_tree[0] = winner;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this);
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+private:
+    /// Exhausted ranges compare greater than any other
+    bool less(size_type a, size_type b) const {
+        if (m_first[a] == m_last[a]) {
+            return false;
+        }
+        if (m_first[b] == m_last[b]) {
+            return true;
+        }
+        if constexpr(Stable) {
+            /// Ties are broken by the range index, with a single comparison
+            if (a < b) {
+                return !m_comp(*m_first[b], *m_first[a]);
+            }
+        }
+        return m_comp(*m_first[a], *m_first[b]);
+    }
+
+    /// Plays the matches in the subtree rooted at `node` and returns the
+    /// winner; leaf of range `i` is node `K + i`
+    size_type play(size_type node) {
+        if (node >= K) {
+            return node - K;
+        }
+        size_type a = play(2 * node);
+        size_type b = play(2 * node + 1);
+        if (less(b, a)) {
+            m_tree[node] = a;
+            return b;
+        }
+        m_tree[node] = b;
+        return a;
+    }
+
+    void build() {
+        m_tree[0] = (K > 1) ? play(1) : 0;
+    }
+
+    std::array<InputIt, K> m_first;
+    std::array<InputIt, K> m_last;
+    /// Losers of the matches at inner nodes `1..K-1`, overall winner at `0`
+    std::array<size_type, K> m_tree = {};
+    Compare m_comp;
+
+};
+
+
+namespace detail {
+
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, std::size_t MaxSize>
+struct is_vector<vector<T, MaxSize>> : std::true_type {};
+
+template <typename Range>
+using range_iterator_t = decltype(std::cbegin(std::declval<const Range&>()));
+
+template <typename Range, typename = void>
+struct range_value {};
+
+template <typename Range>
+struct range_value<Range, std::void_t<range_iterator_t<Range>>> {
+    using type = typename std::iterator_traits<
+                 range_iterator_t<Range>>::value_type;
+};
+
+/// Checks that the last of `Args` is `rttl::vector` and the others are ranges
+/// of its elements
+template <typename Tuple, typename Seq, typename = void>
+struct is_merge_args : std::false_type {};
+
+template <typename... Args, std::size_t... I>
+struct is_merge_args<std::tuple<Args...>, std::index_sequence<I...>,
+    std::enable_if_t<is_vector<std::decay_t<
+        std::tuple_element_t<sizeof...(I), std::tuple<Args...>>>>::value>>
+    : std::conjunction<std::is_same<
+        typename range_value<std::decay_t<
+            std::tuple_element_t<I, std::tuple<Args...>>>>::type,
+        typename std::decay_t<
+            std::tuple_element_t<sizeof...(I), std::tuple<Args...>>>::value_type
+        >...> {};
+
+template <typename... Args>
+constexpr bool is_merge_args_v = (sizeof...(Args) > 1) &&
+    is_merge_args<std::tuple<Args...>,
+                  std::make_index_sequence<sizeof...(Args) - 1>>::value;
+
+template <typename InputIt, std::size_t K, typename Compare, bool Stable,
+          typename T, std::size_t MaxSize>
+void merge_into(kway_merger<InputIt, K, Compare, Stable>& merger,
+                vector<T, MaxSize>& out) {
+    out.append_uninitialized(merger.size(), [&merger](T* d_first,
+                                                      std::size_t count) {
+        std::size_t n = 0;
+        try {
+            for (; n < count; ++n) {
+                ::new(static_cast<void*>(d_first + n)) T(merger.top());
+                merger.pop();
+            }
+        } catch (...) {
+            std::destroy(d_first, d_first + n);
+            throw;
+        }
+        return count;
+    });
+}
+
+template <bool Stable, typename Tuple, std::size_t... I>
+void kway_merge(Tuple&& args, std::index_sequence<I...>) {
+    /// Inputs may be of different container types, so they are walked with
+    /// plain pointers
+    constexpr std::size_t k = sizeof...(I);
+    using It = const typename std::decay_t<
+               std::tuple_element_t<k, Tuple>>::value_type*;
+    kway_merger<It, k, std::less<>, Stable> merger(
+        std::array<It, k>{ std::data(std::get<I>(args))... },
+        std::array<It, k>{ (std::data(std::get<I>(args)) +
+                            std::size(std::get<I>(args)))... });
+    merge_into(merger, std::get<k>(args));
+}
+
+}
+
+
+/**
+ * @name kway_merge
+ *
+ * Merges sorted ranges and appends the result to the `rttl::vector` given as
+ * the last argument; throws `std::length_error` before modifying it if the
+ * merged sequence does not fit. Inputs passed as separate arguments must be
+ * contiguous containers (`rttl::vector`, `std::vector`, `std::array`, ...).
+ */
+///{
+template <typename... Args>
+typename std::enable_if<detail::is_merge_args_v<Args...>>::type
+kway_merge(Args&&... args) {
+    detail::kway_merge<false>(std::forward_as_tuple(args...),
+                              std::make_index_sequence<sizeof...(Args) - 1>());
+}
+
+template <typename Range, std::size_t K, typename T, std::size_t MaxSize,
+          typename Compare = std::less<>>
+void kway_merge(const std::array<Range, K>& inputs, vector<T, MaxSize>& out,
+                Compare comp = Compare()) {
+    kway_merger<detail::range_iterator_t<Range>, K, Compare> merger(inputs,
+                                                                    comp);
+    detail::merge_into(merger, out);
+}
+///}
+
+/**
+ * @name stable_kway_merge
+ *
+ * Same as `kway_merge`, but preserves the order of equivalent elements, those
+ * from preceding inputs coming first.
+ */
+///{
+template <typename... Args>
+typename std::enable_if<detail::is_merge_args_v<Args...>>::type
+stable_kway_merge(Args&&... args) {
+    detail::kway_merge<true>(std::forward_as_tuple(args...),
+                             std::make_index_sequence<sizeof...(Args) - 1>());
+}
+
+template <typename Range, std::size_t K, typename T, std::size_t MaxSize,
+          typename Compare = std::less<>>
+void stable_kway_merge(const std::array<Range, K>& inputs,
+                       vector<T, MaxSize>& out, Compare comp = Compare()) {
+    kway_merger<detail::range_iterator_t<Range>, K, Compare, true> merger(
+        inputs, comp);
+    detail::merge_into(merger, out);
+}
+///}
+
+
+/// Size ratio of ranges starting from which set operations gallop
+constexpr std::size_t set_gallop_ratio = 32;
+
+namespace detail {
+
+/// Sink of set operations that counts elements
+struct set_counter {
+    std::size_t count = 0;
+
+    template <typename T>
+    void operator()(const T&) noexcept {
+        ++count;
+    }
+
+    template <typename T>
+    void copy(const T* first, const T* last) noexcept {
+        count += static_cast<std::size_t>(last - first);
+    }
+
+    template <typename T>
+    void masked(const T*, unsigned mask) noexcept {
+        count += static_cast<std::size_t>(popcount(mask));
+    }
+};
+
+/// Sink of set operations that constructs elements in uninitialized storage
+template <typename T>
+struct set_writer {
+    T* out;
+
+    void operator()(const T& value) noexcept {
+        ::new(static_cast<void*>(out++)) T(value);
+    }
+
+    void copy(const T* first, const T* last) noexcept {
+        out = std::uninitialized_copy(first, last, out);
+    }
+
+    /// Elements `block[k]` for bits `k` set in `mask`
+    void masked(const T* block, unsigned mask) noexcept {
+        for (; mask != 0; mask &= mask - 1) {
+            (*this)(block[countr_zero(mask)]);
+        }
+    }
+};
+
+/**
+ * The first position in `[first, last)` whose element is not less than
+ * `value`, probing positions 1, 2, 4, ... before the binary search.
+ */
+template <typename T>
+const T* gallop(const T* first, const T* last, const T& value) noexcept {
+    auto n = static_cast<std::size_t>(last - first);
+    std::size_t bound = 1;
+    while (bound < n && first[bound] < value) {
+        bound *= 2;
+    }
+    return std::lower_bound(first + bound / 2,
+                            first + std::min(bound + 1, n), value);
+}
+
+#if RTTL_HAS_SSE2
+/// Bits of 32-bit elements of block `a` equal to any element of block `b`
+inline unsigned match_blocks_32(const void* a, const void* b) noexcept {
+    __m128i va = _mm_loadu_si128(static_cast<const __m128i*>(a));
+    __m128i vb = _mm_loadu_si128(static_cast<const __m128i*>(b));
+    __m128i eq = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39))),
+        _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4E)),
+                     _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93))));
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+}
+
+/// Bits of 16-bit elements of block `a` equal to any element of block `b`
+inline unsigned match_blocks_16(const void* a, const void* b) noexcept {
+    __m128i va = _mm_loadu_si128(static_cast<const __m128i*>(a));
+    __m128i vb = _mm_loadu_si128(static_cast<const __m128i*>(b));
+    __m128i eq = _mm_cmpeq_epi16(va, vb);
+    for (int k = 1; k < 8; ++k) {
+        /// Rotates `b` by one element
+        vb = _mm_or_si128(_mm_srli_si128(vb, 2), _mm_slli_si128(vb, 14));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, vb));
+    }
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_packs_epi16(eq, _mm_setzero_si128())));
+}
+
+/// Elements per block compared at once, `0` if blocks are not supported
+template <typename T>
+constexpr std::size_t set_block_size = (sizeof(T) == 4 || sizeof(T) == 2)
+                                     ? 16 / sizeof(T) : 0;
+
+template <typename T>
+unsigned match_blocks(const T* a, const T* b) noexcept {
+    if constexpr (sizeof(T) == 4) {
+        return match_blocks_32(a, b);
+    } else {
+        return match_blocks_16(a, b);
+    }
+}
+#endif
+
+template <typename T, typename Sink>
+void set_intersect(const T* a, std::size_t na, const T* b, std::size_t nb,
+                   Sink& sink) noexcept {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na * set_gallop_ratio < nb) {
+        const T* pos = b;
+        for (std::size_t i = 0; i < na && pos != b + nb; ++i) {
+            pos = gallop(pos, b + nb, a[i]);
+            if (pos != b + nb && !(a[i] < *pos)) {
+                sink(a[i]);
+                ++pos;
+            }
+        }
+        return;
+    }
+    std::size_t i = 0;
+    std::size_t j = 0;
+#if RTTL_HAS_SSE2
+    if constexpr (set_block_size<T> > 0) {
+        constexpr std::size_t n = set_block_size<T>;
+        while (i + n <= na && j + n <= nb) {
+            sink.masked(a + i, match_blocks(a + i, b + j));
+            T a_max = a[i + n - 1];
+            T b_max = b[j + n - 1];
+            i += (a_max <= b_max) ? n : 0;
+            j += (b_max <= a_max) ? n : 0;
+        }
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            sink(a[i]);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+template <typename T, typename Sink>
+void set_difference(const T* a, std::size_t na, const T* b, std::size_t nb,
+                    Sink& sink) noexcept {
+    if (na * set_gallop_ratio < nb) {
+        const T* pos = b;
+        for (std::size_t i = 0; i < na; ++i) {
+            pos = gallop(pos, b + nb, a[i]);
+            if (pos == b + nb || a[i] < *pos) {
+                sink(a[i]);
+            }
+        }
+        return;
+    }
+    if (nb * set_gallop_ratio < na) {
+        const T* pos = a;
+        for (std::size_t j = 0; j < nb; ++j) {
+            const T* next = gallop(pos, a + na, b[j]);
+            sink.copy(pos, next);
+            pos = (next != a + na && !(b[j] < *next)) ? next + 1 : next;
+        }
+        sink.copy(pos, a + na);
+        return;
+    }
+    std::size_t i = 0;
+    std::size_t j = 0;
+    /// Elements of the current block of `a` found in `b` so far
+    unsigned matched = 0;
+#if RTTL_HAS_SSE2
+    if constexpr (set_block_size<T> > 0) {
+        constexpr std::size_t n = set_block_size<T>;
+        while (i + n <= na && j + n <= nb) {
+            matched |= match_blocks(a + i, b + j);
+            T a_max = a[i + n - 1];
+            T b_max = b[j + n - 1];
+            if (b_max <= a_max) {
+                j += n;
+            }
+            if (a_max <= b_max) {
+                sink.masked(a + i, ~matched & ((1u << n) - 1));
+                i += n;
+                matched = 0;
+            }
+        }
+    }
+#endif
+    /// `matched` has at most 8 bits, of the block starting at `block`
+    for (std::size_t block = i; i < na; ++i) {
+        if (i - block < 8 && ((matched >> (i - block)) & 1) != 0) {
+            continue;
+        }
+        while (j < nb && b[j] < a[i]) {
+            ++j;
+        }
+        if (j == nb || a[i] < b[j]) {
+            sink(a[i]);
+        } else {
+            ++j;
+        }
+    }
+}
+
+template <typename T, typename Sink>
+void set_union(const T* a, std::size_t na, const T* b, std::size_t nb,
+               Sink& sink) noexcept {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (na * set_gallop_ratio < nb) {
+        const T* pos = b;
+        for (std::size_t i = 0; i < na; ++i) {
+            const T* next = gallop(pos, b + nb, a[i]);
+            sink.copy(pos, next);
+            sink(a[i]);
+            pos = (next != b + nb && !(a[i] < *next)) ? next + 1 : next;
+        }
+        sink.copy(pos, b + nb);
+        return;
+    }
+    /// Advances are computed rather than branched on, since on interleaved
+    /// inputs which of them is taken is unpredictable
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < na && j < nb) {
+        T x = a[i];
+        T y = b[j];
+        sink(y < x ? y : x);
+        i += static_cast<std::size_t>(!(y < x));
+        j += static_cast<std::size_t>(!(x < y));
+    }
+    sink.copy(a + i, a + na);
+    sink.copy(b + j, b + nb);
+}
+
+/// Checks that `Range1` and `Range2` are ranges of the same integer type
+template <typename Range1, typename Range2, typename = void>
+struct is_set_args : std::false_type {};
+
+template <typename Range1, typename Range2>
+struct is_set_args<Range1, Range2, std::enable_if_t<
+    std::is_same<typename range_value<Range1>::type,
+                 typename range_value<Range2>::type>::value &&
+    std::is_integral<typename range_value<Range1>::type>::value>>
+    : std::true_type {};
+
+/**
+ * Appends the result of set operation `op` to `out`, bounded by `bound` or,
+ * if that exceeds the remaining capacity, by the size computed by `exact`.
+ */
+template <typename T, std::size_t MaxSize, typename Operation>
+void set_append(vector<T, MaxSize>& out, std::size_t bound,
+                std::size_t (*exact)(const T*, std::size_t, const T*,
+                                     std::size_t),
+                const T* a, std::size_t na, const T* b, std::size_t nb,
+                Operation op) {
+    if (bound > out.max_size() - out.size()) {
+        bound = exact(a, na, b, nb);
+    }
+    out.append_uninitialized(bound, [&](T* d_first, std::size_t) {
+        set_writer<T> sink{ d_first };
+        op(a, na, b, nb, sink);
+        return static_cast<std::size_t>(sink.out - d_first);
+    });
+}
+
+template <typename T>
+std::size_t set_intersect_count(const T* a, std::size_t na, const T* b,
+                                std::size_t nb) noexcept {
+    set_counter sink;
+    set_intersect(a, na, b, nb, sink);
+    return sink.count;
+}
+
+template <typename T>
+std::size_t set_union_count(const T* a, std::size_t na, const T* b,
+                            std::size_t nb) noexcept {
+    return na + nb - set_intersect_count(a, na, b, nb);
+}
+
+template <typename T>
+std::size_t set_difference_count(const T* a, std::size_t na, const T* b,
+                                 std::size_t nb) noexcept {
+    return na - set_intersect_count(a, na, b, nb);
+}
+
+}
+
+
+/**
+ * @name set_intersect
+ *
+ * Appends elements present in both sorted sets to `out`; throws
+ * `std::length_error` before modifying it if the result does not fit.
+ */
+///{
+template <typename Range1, typename Range2, typename T, std::size_t MaxSize>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value>::type
+set_intersect(const Range1& a, const Range2& b, vector<T, MaxSize>& out) {
+    detail::set_append(out, std::min(std::size(a), std::size(b)),
+                       &detail::set_intersect_count<T>,
+                       std::data(a), std::size(a), std::data(b), std::size(b),
+                       [](const T* pa, std::size_t na, const T* pb,
+                          std::size_t nb, detail::set_writer<T>& sink) {
+                           detail::set_intersect(pa, na, pb, nb, sink);
+                       });
+}
+
+template <typename Range1, typename Range2>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value,
+                        std::size_t>::type
+set_intersect_count(const Range1& a, const Range2& b) noexcept {
+    return detail::set_intersect_count(std::data(a), std::size(a),
+                                       std::data(b), std::size(b));
+}
+///}
+
+/**
+ * @name set_union
+ *
+ * Appends elements present in either of sorted sets to `out`; throws
+ * `std::length_error` before modifying it if the result does not fit.
+ */
+///{
+template <typename Range1, typename Range2, typename T, std::size_t MaxSize>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value>::type
+set_union(const Range1& a, const Range2& b, vector<T, MaxSize>& out) {
+    detail::set_append(out, std::size(a) + std::size(b),
+                       &detail::set_union_count<T>,
+                       std::data(a), std::size(a), std::data(b), std::size(b),
+                       [](const T* pa, std::size_t na, const T* pb,
+                          std::size_t nb, detail::set_writer<T>& sink) {
+                           detail::set_union(pa, na, pb, nb, sink);
+                       });
+}
+
+template <typename Range1, typename Range2>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value,
+                        std::size_t>::type
+set_union_count(const Range1& a, const Range2& b) noexcept {
+    return detail::set_union_count(std::data(a), std::size(a),
+                                   std::data(b), std::size(b));
+}
+///}
+
+/**
+ * @name set_difference
+ *
+ * Appends elements of sorted set `a` not present in sorted set `b` to `out`;
+ * throws `std::length_error` before modifying it if the result does not fit.
+ */
+///{
+template <typename Range1, typename Range2, typename T, std::size_t MaxSize>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value>::type
+set_difference(const Range1& a, const Range2& b, vector<T, MaxSize>& out) {
+    detail::set_append(out, std::size(a),
+                       &detail::set_difference_count<T>,
+                       std::data(a), std::size(a), std::data(b), std::size(b),
+                       [](const T* pa, std::size_t na, const T* pb,
+                          std::size_t nb, detail::set_writer<T>& sink) {
+                           detail::set_difference(pa, na, pb, nb, sink);
+                       });
+}
+
+template <typename Range1, typename Range2>
+typename std::enable_if<detail::is_set_args<Range1, Range2>::value,
+                        std::size_t>::type
+set_difference_count(const Range1& a, const Range2& b) noexcept {
+    return detail::set_difference_count(std::data(a), std::size(a),
+                                        std::data(b), std::size(b));
+}
+///}
+
+}
+
+#endif // RTTL_ALGORITHM_H_
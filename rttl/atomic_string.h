@@ -0,0 +1,385 @@
+/**
+ * @file rttl/atomic_string.h
+ *
+ * Atomic holder of `rttl::string<N>` value.
+ *
+ * `std::atomic<rttl::string<N>>` is ill-formed, since `rttl::basic_string` is
+ * not trivially copyable, and would not be lock-free anyway, since its length
+ * and characters take more than 16 bytes. `rttl::atomic_string<N>` provides
+ * the interface of `std::atomic` for strings instead:
+ *  - for `N <= 15` length and characters are packed into a single 8-byte
+ *    (`N <= 7`) or 16-byte word, which is loaded, stored, exchanged and
+ *    compared-and-swapped as a whole; 8-byte words use `std::atomic`, 16-byte
+ *    ones use 128-bit compare-and-swap instruction where it is available
+ *    (x86-64 with MSVC, or with GCC or Clang when the target has `cmpxchg16b`,
+ *    e.g. with `-mcx16` or `-march=x86-64-v2`), otherwise a spin lock;
+ *  - for greater `N` the value is guarded by a spin lock;
+ *  - 16-byte words are always accessed with sequential consistency, memory
+ *    order arguments are accepted for compatibility;
+ *  - `load` of a 16-byte word is a compare-and-swap, so it needs the word to
+ *    be writable and contends with other accesses of the same object.
+ *
+ */
+#ifndef RTTL_ATOMIC_STRING_H_
+#define RTTL_ATOMIC_STRING_H_
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include "rttl/string.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/// The first x86-64 CPUs lack `cmpxchg16b`, so GCC and Clang announce it only
+/// for targets that have it
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && \
+    defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define RTTL_HAS_CAS16 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define RTTL_HAS_CAS16 1
+#else
+#define RTTL_HAS_CAS16 0
+#endif
+
+namespace rttl {
+
+namespace detail {
+
+/**
+ * Spin lock for short critical sections.
+ */
+class spin_lock {
+public:
+    void lock() noexcept {
+        while (m_flag.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() noexcept {
+        m_flag.clear(std::memory_order_release);
+    }
+
+private:
+    std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
+
+};
+
+struct alignas(16) word128 {
+    std::uint64_t lo;
+    std::uint64_t hi;
+};
+
+inline bool operator==(const word128& lhs, const word128& rhs) noexcept {
+    return lhs.lo == rhs.lo && lhs.hi == rhs.hi;
+}
+
+/**
+ * Atomic 8- or 16-byte word.
+ */
+template <std::size_t Size>
+class atomic_word;
+
+template <>
+class atomic_word<8> {
+public:
+    using word_type = std::uint64_t;
+
+    static constexpr bool is_always_lock_free =
+        std::atomic<std::uint64_t>::is_always_lock_free;
+
+    bool is_lock_free() const noexcept {
+        return m_word.is_lock_free();
+    }
+
+    word_type load(std::memory_order order) const noexcept {
+        return m_word.load(order);
+    }
+
+    void store(word_type desired, std::memory_order order) noexcept {
+        m_word.store(desired, order);
+    }
+
+    word_type exchange(word_type desired, std::memory_order order) noexcept {
+        return m_word.exchange(desired, order);
+    }
+
+    bool compare_exchange(word_type& expected, word_type desired,
+                          std::memory_order order) noexcept {
+        return m_word.compare_exchange_strong(expected, desired, order);
+    }
+
+private:
+    std::atomic<std::uint64_t> m_word{0};
+
+};
+
+template <>
+class atomic_word<16> {
+public:
+    using word_type = word128;
+
+    static constexpr bool is_always_lock_free = RTTL_HAS_CAS16 != 0;
+
+    bool is_lock_free() const noexcept {
+        return is_always_lock_free;
+    }
+
+    word_type load(std::memory_order) const noexcept {
+        word_type result = {0, 0};
+        cas(result, result);
+        return result;
+    }
+
+    void store(word_type desired, std::memory_order order) noexcept {
+        exchange(desired, order);
+    }
+
+    word_type exchange(word_type desired, std::memory_order) noexcept {
+        word_type expected = {0, 0};
+        while (!cas(expected, desired)) {
+        }
+        return expected;
+    }
+
+    bool compare_exchange(word_type& expected, word_type desired,
+                          std::memory_order) noexcept {
+        return cas(expected, desired);
+    }
+
+private:
+    /// On failure, `expected` is updated with the current value
+    bool cas(word_type& expected, word_type desired) const noexcept {
+#if RTTL_HAS_CAS16 && (defined(__GNUC__) || defined(__clang__))
+        bool result;
+        __asm__ __volatile__("lock cmpxchg16b %1"
+                             : "=@ccz"(result), "+m"(m_word),
+                               "+a"(expected.lo), "+d"(expected.hi)
+                             : "b"(desired.lo), "c"(desired.hi)
+                             : "memory");
+        return result;
+#elif RTTL_HAS_CAS16
+        return _InterlockedCompareExchange128(
+            reinterpret_cast<volatile long long*>(&m_word),
+            static_cast<long long>(desired.hi),
+            static_cast<long long>(desired.lo),
+            reinterpret_cast<long long*>(&expected)) != 0;
+#else
+        m_lock.lock();
+        bool result = (m_word == expected);
+        if (result) {
+            m_word = desired;
+        } else {
+            expected = m_word;
+        }
+        m_lock.unlock();
+        return result;
+#endif
+    }
+
+    /// Mutable, since even load is a compare-and-swap
+    mutable word_type m_word = {0, 0};
+#if !RTTL_HAS_CAS16
+    mutable spin_lock m_lock;
+#endif
+
+};
+
+}
+
+
+/**
+ * Atomic string of up to `N` characters, guarded by a spin lock.
+ */
+template <std::size_t N, typename = void>
+class atomic_string {
+public:
+
+    /// @section Member types
+
+    using value_type = string<N>;
+
+    static constexpr bool is_always_lock_free = false;
+
+    /// @section Member functions
+
+    atomic_string() noexcept = default;
+
+    atomic_string(std::string_view desired) : m_value(desired) {}
+
+    atomic_string(const atomic_string&) = delete;
+    atomic_string& operator=(const atomic_string&) = delete;
+
+    atomic_string& operator=(std::string_view desired) {
+        store(desired);
+        return *this;
+    }
+
+    bool is_lock_free() const noexcept {
+        return false;
+    }
+
+    void store(std::string_view desired,
+               std::memory_order = std::memory_order_seq_cst) {
+        value_type value(desired);
+        m_lock.lock();
+        m_value = value;
+        m_lock.unlock();
+    }
+
+    value_type load(std::memory_order = std::memory_order_seq_cst) const {
+        m_lock.lock();
+        value_type result(m_value);
+        m_lock.unlock();
+        return result;
+    }
+
+    operator value_type() const {
+        return load();
+    }
+
+    value_type exchange(std::string_view desired,
+                        std::memory_order = std::memory_order_seq_cst) {
+        value_type value(desired);
+        m_lock.lock();
+        value.swap(m_value);
+        m_lock.unlock();
+        return value;
+    }
+
+    bool compare_exchange_strong(value_type& expected,
+                                 std::string_view desired,
+                                 std::memory_order = std::memory_order_seq_cst) {
+        value_type value(desired);
+        m_lock.lock();
+        bool result = (m_value == expected);
+        if (result) {
+            m_value = value;
+        } else {
+            expected = m_value;
+        }
+        m_lock.unlock();
+        return result;
+    }
+
+    bool compare_exchange_weak(value_type& expected, std::string_view desired,
+                               std::memory_order order =
+                                   std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, desired, order);
+    }
+
+private:
+    value_type m_value;
+    mutable detail::spin_lock m_lock;
+
+};
+
+
+/**
+ * Atomic string of up to `N <= 15` characters, packed into a single word.
+ */
+template <std::size_t N>
+class atomic_string<N, typename std::enable_if<(N <= 15)>::type> {
+    static constexpr std::size_t word_size = (N <= 7) ? 8 : 16;
+    using word_type = typename detail::atomic_word<word_size>::word_type;
+public:
+
+    /// @section Member types
+
+    using value_type = string<N>;
+
+    static constexpr bool is_always_lock_free =
+        detail::atomic_word<word_size>::is_always_lock_free;
+
+    /// @section Member functions
+
+    atomic_string() noexcept = default;
+
+    atomic_string(std::string_view desired) {
+        m_word.store(pack(desired), std::memory_order_relaxed);
+    }
+
+    atomic_string(const atomic_string&) = delete;
+    atomic_string& operator=(const atomic_string&) = delete;
+
+    atomic_string& operator=(std::string_view desired) {
+        store(desired);
+        return *this;
+    }
+
+    bool is_lock_free() const noexcept {
+        return m_word.is_lock_free();
+    }
+
+    void store(std::string_view desired,
+               std::memory_order order = std::memory_order_seq_cst) {
+        m_word.store(pack(desired), order);
+    }
+
+    value_type load(std::memory_order order =
+                        std::memory_order_seq_cst) const noexcept {
+        return unpack(m_word.load(order));
+    }
+
+    operator value_type() const noexcept {
+        return load();
+    }
+
+    value_type exchange(std::string_view desired,
+                        std::memory_order order = std::memory_order_seq_cst) {
+        return unpack(m_word.exchange(pack(desired), order));
+    }
+
+    bool compare_exchange_strong(value_type& expected,
+                                 std::string_view desired,
+                                 std::memory_order order =
+                                     std::memory_order_seq_cst) {
+        word_type expected_word = pack(expected);
+        if (m_word.compare_exchange(expected_word, pack(desired), order)) {
+            return true;
+        }
+        expected = unpack(expected_word);
+        return false;
+    }
+
+    bool compare_exchange_weak(value_type& expected, std::string_view desired,
+                               std::memory_order order =
+                                   std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, desired, order);
+    }
+
+private:
+    /// Length goes to the first byte, characters follow, unused bytes are
+    /// zero, so that equal strings have equal words
+    static word_type pack(std::string_view s) {
+        if (s.length() > N) {
+            throw std::length_error("rttl::atomic_string");
+        }
+        unsigned char bytes[word_size] = {};
+        bytes[0] = static_cast<unsigned char>(s.length());
+        std::memcpy(bytes + 1, s.data(), s.length());
+        word_type result;
+        std::memcpy(&result, bytes, word_size);
+        return result;
+    }
+
+    static value_type unpack(const word_type& word) noexcept {
+        char bytes[word_size];
+        std::memcpy(bytes, &word, word_size);
+        return value_type(bytes + 1,
+                          static_cast<unsigned char>(bytes[0]));
+    }
+
+    detail::atomic_word<word_size> m_word;
+
+};
+
+}
+
+#endif // RTTL_ATOMIC_STRING_H_
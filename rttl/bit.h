@@ -0,0 +1,138 @@
+/**
+ * @file rttl/bit.h
+ *
+ * Bit manipulation functions of C++20 `<bit>` header available in C++17.
+ *
+ * Functions are defined for unsigned integer types of up to 64 bits and use
+ * compiler intrinsics where those are known to exist, so they compile to a
+ * single instruction on targets that have one.
+ *
+ * Also provides loads and stores of integers in big- and little-endian byte
+ * order, shared by serialization code of other headers.
+ *
+ */
+#ifndef RTTL_BIT_H_
+#define RTTL_BIT_H_
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace rttl {
+
+/**
+ * Number of consecutive zero bits, starting from the most significant bit.
+ */
+template <typename T>
+constexpr int countl_zero(T x) noexcept {
+    static_assert(std::is_unsigned<T>::value && sizeof(T) <= 8,
+                  "Unsigned integer of up to 64 bits expected");
+    constexpr int digits = std::numeric_limits<T>::digits;
+    if (x == 0) {
+        return digits;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x) - (64 - digits);
+#else
+    int n = 0;
+    for (T mask = T(1) << (digits - 1); (x & mask) == 0; mask >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Number of consecutive zero bits, starting from the least significant bit.
+ */
+template <typename T>
+constexpr int countr_zero(T x) noexcept {
+    static_assert(std::is_unsigned<T>::value && sizeof(T) <= 8,
+                  "Unsigned integer of up to 64 bits expected");
+    if (x == 0) {
+        return std::numeric_limits<T>::digits;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (; (x & 1) == 0; x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * Number of one bits.
+ */
+template <typename T>
+constexpr int popcount(T x) noexcept {
+    static_assert(std::is_unsigned<T>::value && sizeof(T) <= 8,
+                  "Unsigned integer of up to 64 bits expected");
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    std::uint64_t v = x;
+    v = v - ((v >> 1) & 0x5555555555555555u);
+    v = (v & 0x3333333333333333u) + ((v >> 2) & 0x3333333333333333u);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+    return static_cast<int>((v * 0x0101010101010101u) >> 56);
+#endif
+}
+
+/**
+ * Number of bits needed to represent `x`, zero for zero.
+ */
+template <typename T>
+constexpr int bit_width(T x) noexcept {
+    return std::numeric_limits<T>::digits - countl_zero(x);
+}
+
+namespace detail {
+
+template <typename T>
+void store_be(std::uint8_t* p, T value) noexcept {
+    static_assert(std::is_integral<T>::value, "Integral type required");
+    auto v = static_cast<typename std::make_unsigned<T>::type>(value);
+    for (std::size_t i = sizeof(T); i > 0; --i) {
+        p[i - 1] = static_cast<std::uint8_t>(v);
+        v = static_cast<decltype(v)>(v >> 8);
+    }
+}
+
+template <typename T>
+void store_le(std::uint8_t* p, T value) noexcept {
+    static_assert(std::is_integral<T>::value, "Integral type required");
+    auto v = static_cast<typename std::make_unsigned<T>::type>(value);
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        p[i] = static_cast<std::uint8_t>(v);
+        v = static_cast<decltype(v)>(v >> 8);
+    }
+}
+
+template <typename T>
+T load_be(const std::uint8_t* p) noexcept {
+    static_assert(std::is_integral<T>::value, "Integral type required");
+    typename std::make_unsigned<T>::type v = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        v = static_cast<decltype(v)>((v << 8) | p[i]);
+    }
+    return static_cast<T>(v);
+}
+
+template <typename T>
+T load_le(const std::uint8_t* p) noexcept {
+    static_assert(std::is_integral<T>::value, "Integral type required");
+    typename std::make_unsigned<T>::type v = 0;
+    for (std::size_t i = sizeof(T); i > 0; --i) {
+        v = static_cast<decltype(v)>((v << 8) | p[i - 1]);
+    }
+    return static_cast<T>(v);
+}
+
+}
+
+}
+
+#endif // RTTL_BIT_H_
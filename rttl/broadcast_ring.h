@@ -0,0 +1,264 @@
+/**
+ * @file rttl/broadcast_ring.h
+ *
+ * Single-producer, multiple-consumer broadcast ring buffer with statically
+ * allocated storage, in the manner of LMAX Disruptor.
+ *
+ * Every event published into `rttl::broadcast_ring<T, N, MaxConsumers>` is
+ * seen by every subscribed consumer:
+ *  - `N` slots of `T` are stored within the class and reused; `N` must be a
+ *    power of two;
+ *  - producer claims a batch of slots, fills them in place and publishes the
+ *    whole batch with a single release store;
+ *  - each consumer reads published slots in place, without copying, and
+ *    releases them by advancing its own cursor; cursors are placed in separate
+ *    cache lines, so consumers do not contend with each other;
+ *  - producer never overwrites a slot that the slowest consumer has not
+ *    released, so `claim` waits (spins) and `try_claim` fails while the ring
+ *    is full; with no consumers subscribed events are simply dropped.
+ *
+ * Thread safety: all producer operations must be called from one thread at a
+ * time, consumer operations for a given consumer id as well. `subscribe` may
+ * be called from several threads at once, each claiming a distinct id, but
+ * not concurrently with the producer, otherwise the new consumer may miss the
+ * back-pressure of the producer's ongoing claim.
+ *
+ */
+#ifndef RTTL_BROADCAST_RING_H_
+#define RTTL_BROADCAST_RING_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace rttl {
+
+template <typename T, std::size_t N, std::size_t MaxConsumers>
+class broadcast_ring {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(MaxConsumers > 0, "At least one consumer is required");
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    /// Sequence number of an event, never wraps in practice
+    using sequence_type = std::uint64_t;
+
+    /// Size of a cache line assumed for padding
+    static constexpr size_type cache_line_size = 64;
+
+    /// @section Member functions
+
+    broadcast_ring() = default;
+    broadcast_ring(const broadcast_ring&) = delete;
+    broadcast_ring& operator=(const broadcast_ring&) = delete;
+
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+    static constexpr size_type max_consumers() noexcept {
+        return MaxConsumers;
+    }
+
+    /**
+     * @name operator[]
+     *
+     * Slot of event `seq`; the producer writes claimed slots, consumers read
+     * published slots they have not released yet.
+     */
+    ///{
+    reference operator[](sequence_type seq) noexcept {
+        return m_slots[seq & (N - 1)];
+    }
+
+    const_reference operator[](sequence_type seq) const noexcept {
+        return m_slots[seq & (N - 1)];
+    }
+    ///}
+
+    /**
+     * Number of published events, i.e. sequence of the next event to be
+     * published.
+     */
+    sequence_type published() const noexcept {
+        return m_published.value.load(std::memory_order_acquire);
+    }
+
+    /// @subsection Producer
+
+    /**
+     * Claims `count` consecutive slots if the slowest consumer allows; returns
+     * `false` otherwise, or if `count` exceeds the capacity.
+     */
+    bool try_claim(size_type count, sequence_type& first) noexcept {
+        if (count > N) {
+            return false;
+        }
+        sequence_type next = m_producer.claimed + count;
+        if (next - m_producer.gate > N) {
+            m_producer.gate = slowest(m_producer.claimed);
+            if (next - m_producer.gate > N) {
+                return false;
+            }
+        }
+        first = m_producer.claimed;
+        m_producer.claimed = next;
+        return true;
+    }
+
+    /**
+     * Claims `count` consecutive slots, waiting for the slowest consumer if
+     * needed; throws if `count` exceeds the capacity.
+     */
+    sequence_type claim(size_type count) {
+        if (count > N) {
+            throw std::length_error("rttl::broadcast_ring");
+        }
+        sequence_type first;
+        while (!try_claim(count, first)) {
+            std::this_thread::yield();
+        }
+        return first;
+    }
+
+    /**
+     * Makes all claimed slots visible to consumers.
+     */
+    void publish() noexcept {
+        m_published.value.store(m_producer.claimed, std::memory_order_release);
+    }
+
+    /**
+     * Publishes a single event; returns `false` if the ring is full.
+     */
+    bool try_push(const T& value) {
+        sequence_type seq;
+        if (!try_claim(1, seq)) {
+            return false;
+        }
+        (*this)[seq] = value;
+        publish();
+        return true;
+    }
+
+    /**
+     * Publishes a single event, waiting for the slowest consumer if needed.
+     */
+    void push(const T& value) {
+        (*this)[claim(1)] = value;
+        publish();
+    }
+
+    /// @subsection Consumers
+
+    /**
+     * Registers a consumer, which receives events published from now on;
+     * returns its id. Throws if `MaxConsumers` are already subscribed.
+     */
+    size_type subscribe() {
+        for (size_type id = 0; id < MaxConsumers; ++id) {
+            bool taken = false;
+            if (m_consumers[id].taken.compare_exchange_strong(
+                    taken, true, std::memory_order_acquire,
+                    std::memory_order_relaxed)) {
+                m_consumers[id].cursor.store(published(),
+                                             std::memory_order_relaxed);
+                m_consumers[id].active.store(true, std::memory_order_release);
+                return id;
+            }
+        }
+        throw std::length_error("rttl::broadcast_ring");
+    }
+
+    void unsubscribe(size_type id) noexcept {
+        m_consumers[id].active.store(false, std::memory_order_release);
+        m_consumers[id].taken.store(false, std::memory_order_release);
+    }
+
+    /**
+     * Sequence of the next event for consumer `id` to read.
+     */
+    sequence_type position(size_type id) const noexcept {
+        return m_consumers[id].cursor.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of published events consumer `id` has not released yet.
+     */
+    size_type available(size_type id) const noexcept {
+        return published() - position(id);
+    }
+
+    /**
+     * Releases slots before `next` for the producer to reuse.
+     */
+    void release(size_type id, sequence_type next) noexcept {
+        m_consumers[id].cursor.store(next, std::memory_order_release);
+    }
+
+    /**
+     * Calls `f(const T&)` for up to `max_count` published events in place,
+     * then releases them in one step; returns the number of events consumed.
+     */
+    template <typename Function>
+    size_type consume(size_type id, Function f,
+                      size_type max_count = N) {
+        sequence_type first = position(id);
+        sequence_type last = std::min<sequence_type>(published(),
+                                                     first + max_count);
+        for (sequence_type seq = first; seq != last; ++seq) {
+            f((*this)[seq]);
+        }
+        release(id, last);
+        return last - first;
+    }
+
+private:
+    sequence_type slowest(sequence_type limit) const noexcept {
+        sequence_type result = limit;
+        for (const auto& c : m_consumers) {
+            if (c.active.load(std::memory_order_acquire)) {
+                result = std::min(result,
+                                  c.cursor.load(std::memory_order_acquire));
+            }
+        }
+        return result;
+    }
+
+    struct alignas(cache_line_size) consumer_cursor {
+        std::atomic<sequence_type> cursor{0};
+        /// Seen by the producer once the cursor is set
+        std::atomic<bool> active{false};
+        /// Claimed by `subscribe`, before the cursor is set
+        std::atomic<bool> taken{false};
+    };
+
+    struct alignas(cache_line_size) producer_state {
+        /// Sequence of the next slot to be claimed
+        sequence_type claimed = 0;
+        /// Cached cursor of the slowest consumer
+        sequence_type gate = 0;
+    };
+
+    struct alignas(cache_line_size) published_cursor {
+        std::atomic<sequence_type> value{0};
+    };
+
+    producer_state m_producer;
+    published_cursor m_published;
+    std::array<consumer_cursor, MaxConsumers> m_consumers;
+    alignas(cache_line_size) std::array<T, N> m_slots;
+
+};
+
+}
+
+#endif // RTTL_BROADCAST_RING_H_
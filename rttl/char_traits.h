@@ -0,0 +1,169 @@
+/**
+ * @file rttl/char_traits.h
+ *
+ * Character traits with vectorized operations for 16- and 32-bit characters.
+ *
+ * `rttl::char_traits<CharT>` is `std::char_traits<CharT>` with `compare`,
+ * `length` and `find` processing 16 bytes at a time where SSE2 is available;
+ * for `char`, which already has `memcmp`, `strlen` and `memchr` behind it,
+ * and on other targets it is the same as `std::char_traits<CharT>`:
+ *  - operations are not `constexpr`;
+ *  - `length` reads aligned 16-byte blocks, which may extend past the null
+ *    character, but never cross a page boundary.
+ *
+ * `rttl::basic_string` with `std::char_traits` of 16- and 32-bit characters,
+ * i.e. `rttl::wstring`, `rttl::u16string` and `rttl::u32string`, uses these
+ * operations for `find` and `compare` internally, while keeping its traits
+ * type and thereby the compatibility with `std::basic_string_view`.
+ *
+ */
+#ifndef RTTL_CHAR_TRAITS_H_
+#define RTTL_CHAR_TRAITS_H_
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include "rttl/bit.h"
+#include "rttl/simd.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RTTL_NO_SANITIZE_ADDRESS __attribute__((no_sanitize("address")))
+#else
+#define RTTL_NO_SANITIZE_ADDRESS
+#endif
+
+namespace rttl {
+
+template <typename CharT>
+class char_traits : public std::char_traits<CharT> {
+    using base = std::char_traits<CharT>;
+
+    static constexpr bool vectorized = RTTL_HAS_SSE2 &&
+        (sizeof(CharT) == 2 || sizeof(CharT) == 4);
+
+#if RTTL_HAS_SSE2
+    /// Equality of characters of 16-byte blocks
+    static __m128i equal(__m128i a, __m128i b) noexcept {
+        if constexpr (sizeof(CharT) == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        } else {
+            return _mm_cmpeq_epi32(a, b);
+        }
+    }
+
+    static __m128i load(const CharT* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    /// Index of the first character marked in a byte mask
+    static std::size_t first_index(std::uint32_t mask) noexcept {
+        return static_cast<std::size_t>(countr_zero(mask)) / sizeof(CharT);
+    }
+#endif
+
+public:
+    using char_type = CharT;
+
+    /// Number of characters in a 16-byte block
+    static constexpr std::size_t block_size = 16 / sizeof(CharT);
+
+    static int compare(const char_type* s1, const char_type* s2,
+                       std::size_t count) noexcept {
+#if RTTL_HAS_SSE2
+        if constexpr (vectorized) {
+            std::size_t i = 0;
+            for (; i + block_size <= count; i += block_size) {
+                auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(load(s1 + i), load(s2 + i))));
+                if (mask != 0xFFFF) {
+                    std::size_t k = i + first_index(~mask);
+                    return base::lt(s1[k], s2[k]) ? -1 : 1;
+                }
+            }
+            return base::compare(s1 + i, s2 + i, count - i);
+        }
+#endif
+        return base::compare(s1, s2, count);
+    }
+
+    RTTL_NO_SANITIZE_ADDRESS
+    static std::size_t length(const char_type* s) noexcept {
+#if RTTL_HAS_SSE2
+        if constexpr (vectorized) {
+            /// Characters before the first aligned block one by one
+            const char_type* p = s;
+            while (reinterpret_cast<std::uintptr_t>(p) % 16 != 0) {
+                if (*p == char_type()) {
+                    return static_cast<std::size_t>(p - s);
+                }
+                ++p;
+            }
+            const __m128i zero = _mm_setzero_si128();
+            for (;; p += block_size) {
+                __m128i block = _mm_load_si128(
+                    reinterpret_cast<const __m128i*>(p));
+                auto mask = static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(equal(block, zero)));
+                if (mask != 0) {
+                    return static_cast<std::size_t>(p - s) + first_index(mask);
+                }
+            }
+        }
+#endif
+        return base::length(s);
+    }
+
+    static const char_type* find(const char_type* s, std::size_t count,
+                                 const char_type& ch) noexcept {
+#if RTTL_HAS_SSE2
+        if constexpr (vectorized) {
+            __m128i pattern;
+            if constexpr (sizeof(CharT) == 2) {
+                pattern = _mm_set1_epi16(static_cast<short>(ch));
+            } else {
+                pattern = _mm_set1_epi32(static_cast<int>(ch));
+            }
+            std::size_t i = 0;
+            for (; i + block_size <= count; i += block_size) {
+                auto mask = static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(equal(load(s + i), pattern)));
+                if (mask != 0) {
+                    return s + i + first_index(mask);
+                }
+            }
+            return base::find(s + i, count - i, ch);
+        }
+#endif
+        return base::find(s, count, ch);
+    }
+};
+
+namespace detail {
+
+/**
+ * Traits whose operations `rttl::basic_string` uses internally for `Traits`.
+ */
+template <typename Traits>
+struct fast_traits {
+    using type = Traits;
+};
+
+template <>
+struct fast_traits<std::char_traits<wchar_t>> {
+    using type = rttl::char_traits<wchar_t>;
+};
+
+template <>
+struct fast_traits<std::char_traits<char16_t>> {
+    using type = rttl::char_traits<char16_t>;
+};
+
+template <>
+struct fast_traits<std::char_traits<char32_t>> {
+    using type = rttl::char_traits<char32_t>;
+};
+
+}
+
+}
+
+#endif // RTTL_CHAR_TRAITS_H_
@@ -0,0 +1,233 @@
+/**
+ * @file rttl/concurrent_intern_set.h
+ *
+ * Insert-only set of strings with statically allocated storage, for interning
+ * symbols from several threads concurrently.
+ *
+ * `rttl::concurrent_intern_set<TotalChars, MaxEntries>` keeps up to
+ * `MaxEntries` distinct strings of `TotalChars` characters in total within the
+ * class:
+ *  - characters are copied into an arena by bumping an atomic pointer, so the
+ *    `std::string_view` of an interned string stays valid for the lifetime of
+ *    the set, and so does its id, a small integer;
+ *  - the index is an open-addressing hash table with linear probing whose
+ *    slots are claimed with a single CAS, holding the id and a part of the
+ *    hash; there are no locks, `intern` is lock-free and `find` is wait-free;
+ *  - a thread that loses the race to insert the same string concurrently
+ *    gets the id of the winner, the characters and the id it has reserved
+ *    are not reused, so ids are unique but not necessarily contiguous and
+ *    capacity may be consumed somewhat faster under contention;
+ *  - strings are never removed; `intern` throws once the arena or the ids
+ *    are exhausted, leaving the set usable for lookups.
+ *
+ * The set is large, so it is meant to be allocated statically.
+ *
+ */
+#ifndef RTTL_CONCURRENT_INTERN_SET_H_
+#define RTTL_CONCURRENT_INTERN_SET_H_
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace rttl {
+
+template <std::size_t TotalChars, std::size_t MaxEntries>
+class concurrent_intern_set {
+    static_assert(MaxEntries > 0, "Empty sets are not allowed");
+    static_assert(MaxEntries < std::numeric_limits<std::uint32_t>::max(),
+                  "Ids must fit in 32 bits");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+    using id_type = std::uint32_t;
+
+    /// Id returned by `find` for strings that are not interned
+    static constexpr id_type npos = std::numeric_limits<id_type>::max();
+
+    /// @section Member functions
+
+    concurrent_intern_set() noexcept = default;
+    concurrent_intern_set(const concurrent_intern_set&) = delete;
+    concurrent_intern_set& operator=(const concurrent_intern_set&) = delete;
+
+    /// @subsection Lookup
+
+    /**
+     * Id of `str`, or `npos` if it is not interned; wait-free.
+     */
+    id_type find(std::string_view str) const noexcept {
+        std::size_t hash = std::hash<std::string_view>()(str);
+        std::uint64_t tag = tag_of(hash);
+        for (size_type i = 0, pos = hash & mask; i < slot_count;
+             ++i, pos = (pos + 1) & mask) {
+            std::uint64_t slot = m_slots[pos].load(std::memory_order_acquire);
+            if (slot == 0) {
+                return npos;
+            }
+            if (matches(slot, tag, str)) {
+                return id_of(slot);
+            }
+        }
+        return npos;
+    }
+
+    bool contains(std::string_view str) const noexcept {
+        return find(str) != npos;
+    }
+
+    /**
+     * String of id `id` returned by `intern` or `find`.
+     */
+    std::string_view view(id_type id) const noexcept {
+        const entry& e = m_entries[id];
+        return std::string_view(m_chars.data() + e.offset, e.length);
+    }
+
+    std::string_view operator[](id_type id) const noexcept {
+        return view(id);
+    }
+
+    /// @subsection Capacity
+
+    /**
+     * Number of strings interned so far.
+     */
+    size_type size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return MaxEntries;
+    }
+
+    static constexpr size_type max_chars() noexcept {
+        return TotalChars;
+    }
+
+    /**
+     * Number of characters reserved in the arena, including those of lost
+     * races.
+     */
+    size_type chars_used() const noexcept {
+        return std::min(m_chars_used.load(std::memory_order_relaxed),
+                        TotalChars);
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Id of `str`, interning it if necessary; lock-free. Throws
+     * `std::length_error` if `str` is not interned and there is no room for
+     * it.
+     */
+    id_type intern(std::string_view str) {
+        std::size_t hash = std::hash<std::string_view>()(str);
+        std::uint64_t tag = tag_of(hash);
+        /// Slot value reserved for `str`, built on the first empty slot
+        std::uint64_t desired = 0;
+        for (size_type i = 0, pos = hash & mask; i < slot_count;) {
+            std::uint64_t slot = m_slots[pos].load(std::memory_order_acquire);
+            if (slot == 0) {
+                if (desired == 0) {
+                    desired = tag | (std::uint64_t(allocate(str)) + 1);
+                }
+                if (m_slots[pos].compare_exchange_strong(
+                        slot, desired, std::memory_order_acq_rel,
+                        std::memory_order_acquire)) {
+                    m_size.fetch_add(1, std::memory_order_relaxed);
+                    return id_of(desired);
+                }
+                /// Another thread has taken the slot, examine its string
+            }
+            if (matches(slot, tag, str)) {
+                return id_of(slot);
+            }
+            ++i;
+            pos = (pos + 1) & mask;
+        }
+        /// Unreachable: ids run out before slots
+        throw std::length_error("rttl::concurrent_intern_set");
+    }
+
+private:
+    struct entry {
+        size_type offset;
+        size_type length;
+    };
+
+    static constexpr size_type slot_count_for(size_type n) noexcept {
+        size_type result = 1;
+        while (result < n) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    /// Slots, at least twice as many as entries, so that probes stay short
+    static constexpr size_type slot_count = slot_count_for(2 * MaxEntries);
+    static constexpr size_type mask = slot_count - 1;
+
+    /// Upper 32 bits of a slot value, lower ones hold the id plus one
+    static std::uint64_t tag_of(std::size_t hash) noexcept {
+        std::uint64_t bits = hash;
+        return (bits >> (sizeof(hash) * 8 - 32)) << 32;
+    }
+
+    static id_type id_of(std::uint64_t slot) noexcept {
+        return static_cast<id_type>(slot) - 1;
+    }
+
+    bool matches(std::uint64_t slot, std::uint64_t tag,
+                 std::string_view str) const noexcept {
+        return (slot & 0xFFFFFFFF00000000u) == tag && view(id_of(slot)) == str;
+    }
+
+    /**
+     * Reserves an id and characters for `str` and copies it; the entry is
+     * published by the release CAS of its slot.
+     */
+    id_type allocate(std::string_view str) {
+        if (m_next_id.load(std::memory_order_relaxed) >= MaxEntries ||
+            str.size() > TotalChars - chars_used()) {
+            throw std::length_error("rttl::concurrent_intern_set");
+        }
+        size_type id = m_next_id.fetch_add(1, std::memory_order_relaxed);
+        size_type offset = m_chars_used.fetch_add(str.size(),
+                                                  std::memory_order_relaxed);
+        /// Concurrent allocations may have overtaken the checks above
+        if (id >= MaxEntries || offset > TotalChars ||
+            str.size() > TotalChars - offset) {
+            throw std::length_error("rttl::concurrent_intern_set");
+        }
+        if (!str.empty()) {
+            std::memcpy(m_chars.data() + offset, str.data(), str.size());
+        }
+        m_entries[id] = entry{ offset, str.size() };
+        return static_cast<id_type>(id);
+    }
+
+    std::array<std::atomic<std::uint64_t>, slot_count> m_slots = {};
+    std::array<entry, MaxEntries> m_entries;
+    std::array<char, TotalChars> m_chars;
+    std::atomic<size_type> m_next_id = 0;
+    std::atomic<size_type> m_chars_used = 0;
+    std::atomic<size_type> m_size = 0;
+
+};
+
+}
+
+#endif // RTTL_CONCURRENT_INTERN_SET_H_
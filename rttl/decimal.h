@@ -0,0 +1,358 @@
+/**
+ * @file rttl/decimal.h
+ *
+ * Fixed-point decimal numbers with exact parsing and formatting, for prices
+ * and quantities given as decimal text.
+ *
+ * `rttl::decimal<Scale, Rep>` stores a number as a signed integer count of
+ * `10^-Scale` units, `Rep` being `std::int64_t` or, where the compiler
+ * supports it, `rttl::int128`:
+ *  - `parse_decimal` converts text like `-123.4500` directly into the scaled
+ *    integer, without going through floating point, so every value with at
+ *    most `Scale` fractional digits is represented exactly; digits are
+ *    converted 8 at a time with SWAR (SIMD within a register) arithmetic;
+ *  - `format_decimal` writes the integer part without leading zeros and
+ *    exactly `Scale` fractional digits into an `rttl::string`, producing 8
+ *    digits at a time the same way;
+ *  - errors are returned as `rttl::decimal_status` rather than thrown: text
+ *    that is not a decimal number, values out of range of `Rep`, fractional
+ *    digits beyond `Scale` that are not zeros (the value is then truncated),
+ *    and strings too short for the result.
+ *
+ */
+#ifndef RTTL_DECIMAL_H_
+#define RTTL_DECIMAL_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include "rttl/bit.h"
+#include "rttl/string.h"
+
+namespace rttl {
+
+#if defined(__SIZEOF_INT128__)
+#define RTTL_HAS_INT128 1
+__extension__ typedef __int128 int128;
+__extension__ typedef unsigned __int128 uint128;
+#else
+#define RTTL_HAS_INT128 0
+#endif
+
+enum class decimal_status {
+    ok,
+    /// Text is not a decimal number
+    invalid,
+    /// Value is out of range of the representation, or the string is too short
+    overflow,
+    /// Nonzero fractional digits beyond the scale were truncated
+    inexact
+};
+
+namespace detail {
+
+template <typename Rep>
+struct decimal_traits;
+
+template <>
+struct decimal_traits<std::int64_t> {
+    using unsigned_type = std::uint64_t;
+    /// Digits of the largest value, rounded up to a multiple of 8
+    static constexpr unsigned max_digits = 24;
+    static constexpr unsigned max_scale = 18;
+};
+
+#if RTTL_HAS_INT128
+template <>
+struct decimal_traits<int128> {
+    using unsigned_type = uint128;
+    static constexpr unsigned max_digits = 40;
+    static constexpr unsigned max_scale = 38;
+};
+#endif
+
+template <typename T>
+constexpr T pow10(unsigned n) noexcept {
+    T result = 1;
+    for (unsigned i = 0; i < n; ++i) {
+        result *= 10;
+    }
+    return result;
+}
+
+/// Whether all 8 bytes of `chunk` are ASCII digits
+inline bool all_digits(std::uint64_t chunk) noexcept {
+    return (chunk & 0xF0F0F0F0F0F0F0F0u) == 0x3030303030303030u &&
+           ((chunk + 0x0606060606060606u) & 0xF0F0F0F0F0F0F0F0u) ==
+               0x3030303030303030u;
+}
+
+/// Value of 8 ASCII digits, the first one in the lowest byte
+inline std::uint64_t parse_8_digits(std::uint64_t chunk) noexcept {
+    chunk -= 0x3030303030303030u;
+    chunk = (chunk * 10) + (chunk >> 8);
+    return (((chunk & 0x000000FF000000FFu) * (100 + (1000000ull << 32))) +
+            (((chunk >> 16) & 0x000000FF000000FFu) * (1 + (10000ull << 32))))
+           >> 32;
+}
+
+/// ASCII digits of `value < 10^8`, zero-padded, the first one in the lowest byte
+inline std::uint64_t format_8_digits(std::uint32_t value) noexcept {
+    /// Two 4-digit halves in 32-bit lanes, then pairs in 16-bit lanes, then
+    /// digits in bytes
+    std::uint64_t v = (value / 10000) | (std::uint64_t(value % 10000) << 32);
+    std::uint64_t q = ((v * 10486) >> 20) & 0x0000007F0000007Fu;
+    v = q | ((v - q * 100) << 16);
+    q = ((v * 103) >> 10) & 0x000F000F000F000Fu;
+    v = q | ((v - q * 10) << 8);
+    return v + 0x3030303030303030u;
+}
+
+/**
+ * Appends digits `[p, p + n)` to `acc`; returns `false` on a non-digit
+ * character and sets `overflow` if `acc` does not fit in `U`.
+ */
+template <typename U>
+bool accumulate_digits(U& acc, const char* p, std::size_t n,
+                       bool& overflow) noexcept {
+    constexpr U max = std::numeric_limits<U>::max();
+    constexpr U chunk_scale = 100000000u;
+    for (; n >= 8; p += 8, n -= 8) {
+        auto chunk = load_le<std::uint64_t>(reinterpret_cast<const std::uint8_t*>(p));
+        if (!all_digits(chunk)) {
+            return false;
+        }
+        U value = parse_8_digits(chunk);
+        if (acc > max / chunk_scale || acc * chunk_scale > max - value) {
+            overflow = true;
+        } else {
+            acc = acc * chunk_scale + value;
+        }
+    }
+    for (; n > 0; ++p, --n) {
+        auto d = static_cast<unsigned>(*p - '0');
+        if (d > 9) {
+            return false;
+        }
+        if (acc > max / 10 || acc * 10 > max - d) {
+            overflow = true;
+        } else {
+            acc = acc * 10 + d;
+        }
+    }
+    return true;
+}
+
+}
+
+template <unsigned Scale, typename Rep = std::int64_t>
+class decimal {
+    using traits = detail::decimal_traits<Rep>;
+    static_assert(Scale <= traits::max_scale,
+                  "Scale is too large for the representation");
+public:
+
+    /// @section Member types
+
+    using rep = Rep;
+
+    static constexpr unsigned scale = Scale;
+    /// Representation of `1`
+    static constexpr Rep one = detail::pow10<Rep>(Scale);
+
+    /// @section Member functions
+
+    constexpr decimal() noexcept = default;
+
+    /**
+     * Decimal of `units` whole units.
+     */
+    static constexpr decimal from_units(Rep units) noexcept {
+        return from_raw(units * one);
+    }
+
+    /**
+     * Decimal of `raw` units of `10^-Scale`.
+     */
+    static constexpr decimal from_raw(Rep raw) noexcept {
+        decimal result;
+        result.m_raw = raw;
+        return result;
+    }
+
+    constexpr Rep raw() const noexcept {
+        return m_raw;
+    }
+
+    /// @subsection Arithmetic, not checked for overflow
+
+    constexpr decimal operator-() const noexcept {
+        return from_raw(-m_raw);
+    }
+
+    constexpr decimal& operator+=(const decimal& other) noexcept {
+        m_raw += other.m_raw;
+        return *this;
+    }
+
+    constexpr decimal& operator-=(const decimal& other) noexcept {
+        m_raw -= other.m_raw;
+        return *this;
+    }
+
+    friend constexpr decimal operator+(decimal lhs, const decimal& rhs) noexcept {
+        return lhs += rhs;
+    }
+
+    friend constexpr decimal operator-(decimal lhs, const decimal& rhs) noexcept {
+        return lhs -= rhs;
+    }
+
+    /// @subsection Comparison
+
+    friend constexpr bool operator==(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw == rhs.m_raw;
+    }
+
+    friend constexpr bool operator!=(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw != rhs.m_raw;
+    }
+
+    friend constexpr bool operator<(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw < rhs.m_raw;
+    }
+
+    friend constexpr bool operator>(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw > rhs.m_raw;
+    }
+
+    friend constexpr bool operator<=(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw <= rhs.m_raw;
+    }
+
+    friend constexpr bool operator>=(const decimal& lhs, const decimal& rhs) noexcept {
+        return lhs.m_raw >= rhs.m_raw;
+    }
+
+private:
+    Rep m_raw = 0;
+
+};
+
+/**
+ * Parses `str`, an optional sign, digits and optionally a point followed by
+ * digits, into `value`; `value` is modified only with status `ok` or
+ * `inexact`.
+ */
+template <unsigned Scale, typename Rep>
+decimal_status parse_decimal(std::string_view str,
+                             decimal<Scale, Rep>& value) noexcept {
+    using unsigned_type = typename detail::decimal_traits<Rep>::unsigned_type;
+    const char* p = str.data();
+    const char* end = p + str.size();
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    const char* point = p;
+    while (point != end && *point != '.') {
+        ++point;
+    }
+    auto integer_digits = static_cast<std::size_t>(point - p);
+    const char* fraction = (point == end) ? end : point + 1;
+    auto fraction_digits = static_cast<std::size_t>(end - fraction);
+    if (integer_digits + fraction_digits == 0) {
+        return decimal_status::invalid;
+    }
+
+    unsigned_type magnitude = 0;
+    bool overflow = false;
+    std::size_t kept = std::min<std::size_t>(fraction_digits, Scale);
+    if (!detail::accumulate_digits(magnitude, p, integer_digits, overflow) ||
+        !detail::accumulate_digits(magnitude, fraction, kept, overflow)) {
+        return decimal_status::invalid;
+    }
+    /// Digits beyond the scale must be digits, and zeros to be exact
+    bool exact = true;
+    for (const char* q = fraction + kept; q != end; ++q) {
+        if (*q < '0' || *q > '9') {
+            return decimal_status::invalid;
+        }
+        exact = exact && (*q == '0');
+    }
+    constexpr unsigned_type max = std::numeric_limits<unsigned_type>::max();
+    auto padding = detail::pow10<unsigned_type>(
+        static_cast<unsigned>(Scale - kept));
+    if (overflow || magnitude > max / padding) {
+        return decimal_status::overflow;
+    }
+    magnitude *= padding;
+    constexpr auto rep_max = static_cast<unsigned_type>(
+        std::numeric_limits<Rep>::max());
+    if (magnitude > rep_max + (negative ? 1u : 0u)) {
+        return decimal_status::overflow;
+    }
+    value = decimal<Scale, Rep>::from_raw(negative
+        ? static_cast<Rep>(~magnitude + 1)
+        : static_cast<Rep>(magnitude));
+    return exact ? decimal_status::ok : decimal_status::inexact;
+}
+
+/**
+ * Formats `value` into `out` with exactly `Scale` fractional digits; `out`
+ * is modified only with status `ok`.
+ */
+template <std::size_t MaxLength, typename Traits, unsigned Scale, typename Rep>
+decimal_status format_decimal(const decimal<Scale, Rep>& value,
+                              basic_string<MaxLength, char, Traits>& out) noexcept {
+    using traits = detail::decimal_traits<Rep>;
+    using unsigned_type = typename traits::unsigned_type;
+    /// Digits, right-aligned, produced 8 at a time from the least significant
+    std::array<char, traits::max_digits> digits;
+    bool negative = value.raw() < 0;
+    auto magnitude = static_cast<unsigned_type>(value.raw());
+    if (negative) {
+        magnitude = ~magnitude + 1;
+    }
+    /// Leading zeros are dropped down to one integer digit
+    const std::size_t min_first = digits.size() - Scale - 1;
+    std::size_t first = digits.size();
+    do {
+        auto chunk = static_cast<std::uint32_t>(magnitude % 100000000u);
+        magnitude /= 100000000u;
+        first -= 8;
+        detail::store_le(reinterpret_cast<std::uint8_t*>(digits.data() + first),
+                         detail::format_8_digits(chunk));
+    } while (magnitude != 0 || first > min_first);
+    while (first < min_first && digits[first] == '0') {
+        ++first;
+    }
+
+    std::array<char, traits::max_digits + 2> text;
+    std::size_t length = 0;
+    if (negative) {
+        text[length++] = '-';
+    }
+    for (std::size_t i = first; i < digits.size() - Scale; ++i) {
+        text[length++] = digits[i];
+    }
+    if (Scale > 0) {
+        text[length++] = '.';
+        for (std::size_t i = digits.size() - Scale; i < digits.size(); ++i) {
+            text[length++] = digits[i];
+        }
+    }
+    if (length > MaxLength) {
+        return decimal_status::overflow;
+    }
+    out.assign(text.data(), length);
+    return decimal_status::ok;
+}
+
+}
+
+#endif // RTTL_DECIMAL_H_
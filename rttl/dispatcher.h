@@ -0,0 +1,405 @@
+/**
+ * @file rttl/dispatcher.h
+ *
+ * Topic-based publish/subscribe dispatcher with statically allocated storage,
+ * for in-process event routing.
+ *
+ * `rttl::dispatcher<MaxTopics, MaxSubscribers, CallbackBytes, Signature>`
+ * calls subscribers of a topic with arguments of `Signature`, a function
+ * type returning `void`, like `void(const quote&)`, in the order of
+ * subscription:
+ *  - topic names are kept in `rttl::string`s of up to `MaxTopicLength`
+ *    characters in an open-addressing hash table; `topic(name)` hashes the
+ *    name once and returns a handle, so `publish` by handle does no hashing or
+ *    string comparison, and only walks the list of subscribers of the topic;
+ *  - callables are stored in place, within `CallbackBytes` bytes of the
+ *    subscriber entry, like by a small-buffer `std::function` that never
+ *    falls back to the heap: larger callables are rejected at compile time;
+ *  - subscriber entries form a doubly linked list per topic within an array
+ *    of `MaxSubscribers` entries, so `subscribe` and `unsubscribe` are `O(1)`
+ *    apart from the topic lookup, and `publish` is `O(subscribers)`;
+ *  - nothing allocates: a topic or a subscriber beyond the capacity throws
+ *    `std::length_error`; topics are never removed;
+ *  - subscriptions are identified by handles with a generation counter, so
+ *    unsubscribing twice, or with a handle whose entry was reused, does
+ *    nothing.
+ *
+ * The dispatcher is not thread-safe, and callbacks must not subscribe or
+ * unsubscribe during `publish`.
+ *
+ */
+#ifndef RTTL_DISPATCHER_H_
+#define RTTL_DISPATCHER_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "rttl/string.h"
+
+namespace rttl {
+
+namespace detail {
+
+template <std::size_t Bytes, typename Signature>
+class inline_callback;
+
+/**
+ * Callable stored within `Bytes` bytes; neither copied nor moved.
+ */
+template <std::size_t Bytes, typename R, typename... Args>
+class inline_callback<Bytes, R(Args...)> {
+public:
+    inline_callback() noexcept = default;
+    inline_callback(const inline_callback&) = delete;
+    inline_callback& operator=(const inline_callback&) = delete;
+
+    ~inline_callback() {
+        reset();
+    }
+
+    template <typename F>
+    void emplace(F&& f) {
+        using callable = std::decay_t<F>;
+        static_assert(sizeof(callable) <= Bytes,
+                      "Callable does not fit in CallbackBytes");
+        static_assert(alignof(callable) <= alignof(std::max_align_t),
+                      "Callable is over-aligned");
+        static_assert(std::is_invocable_r<R, callable&, Args...>::value,
+                      "Callable does not match the signature");
+        reset();
+        ::new(static_cast<void*>(m_storage.data())) callable(std::forward<F>(f));
+        m_invoke = &invoke<callable>;
+        m_destroy = &destroy<callable>;
+    }
+
+    void reset() noexcept {
+        if (m_destroy != nullptr) {
+            m_destroy(m_storage.data());
+            m_destroy = nullptr;
+            m_invoke = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept {
+        return m_invoke != nullptr;
+    }
+
+    R operator()(Args... args) {
+        return m_invoke(m_storage.data(), std::forward<Args>(args)...);
+    }
+
+private:
+    template <typename T>
+    static R invoke(void* p, Args... args) {
+        return (*static_cast<T*>(p))(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    static void destroy(void* p) noexcept {
+        static_cast<T*>(p)->~T();
+    }
+
+    alignas(std::max_align_t) std::array<unsigned char, Bytes> m_storage;
+    R (*m_invoke)(void*, Args...) = nullptr;
+    void (*m_destroy)(void*) noexcept = nullptr;
+
+};
+
+}
+
+/**
+ * Only signatures returning `void` are supported, as results of several
+ * subscribers could not be returned from `publish`.
+ */
+template <std::size_t MaxTopics, std::size_t MaxSubscribers,
+          std::size_t CallbackBytes = 32,
+          typename Signature = void(std::string_view),
+          std::size_t MaxTopicLength = 64>
+class dispatcher {
+    static_assert(sizeof(Signature*) == 0,
+                  "Signature must be a function type returning void");
+};
+
+template <std::size_t MaxTopics, std::size_t MaxSubscribers,
+          std::size_t CallbackBytes, typename... Args,
+          std::size_t MaxTopicLength>
+class dispatcher<MaxTopics, MaxSubscribers, CallbackBytes, void(Args...),
+                 MaxTopicLength> {
+    static_assert(MaxTopics > 0 && MaxSubscribers > 0,
+                  "Empty dispatchers are not allowed");
+    static_assert(MaxSubscribers < std::numeric_limits<std::uint32_t>::max(),
+                  "Subscriber numbers must fit in 32 bits");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+    using callback_type = detail::inline_callback<CallbackBytes, void(Args...)>;
+
+    /// Handle of a topic, valid for the lifetime of the dispatcher
+    class topic_handle {
+    public:
+        constexpr topic_handle() noexcept = default;
+
+        explicit operator bool() const noexcept {
+            return m_index != npos;
+        }
+
+        friend bool operator==(topic_handle lhs, topic_handle rhs) noexcept {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend bool operator!=(topic_handle lhs, topic_handle rhs) noexcept {
+            return lhs.m_index != rhs.m_index;
+        }
+
+    private:
+        friend class dispatcher;
+        constexpr explicit topic_handle(std::uint32_t index) noexcept : m_index(index) {}
+        std::uint32_t m_index = npos;
+    };
+
+    /// Handle of a subscription
+    class subscription {
+    public:
+        constexpr subscription() noexcept = default;
+
+    private:
+        friend class dispatcher;
+        constexpr subscription(std::uint32_t slot, std::uint32_t generation) noexcept
+            : m_slot(slot), m_generation(generation) {}
+        std::uint32_t m_slot = npos;
+        std::uint32_t m_generation = 0;
+    };
+
+    static constexpr size_type max_topics = MaxTopics;
+    static constexpr size_type max_subscribers = MaxSubscribers;
+    static constexpr size_type max_topic_length = MaxTopicLength;
+
+    /// @section Member functions
+
+    dispatcher() noexcept = default;
+    dispatcher(const dispatcher&) = delete;
+    dispatcher& operator=(const dispatcher&) = delete;
+
+    /// @subsection Topics
+
+    /**
+     * Handle of topic `name`, which is created if it does not exist; throws
+     * `std::length_error` if the name is too long or there are `MaxTopics`
+     * topics.
+     */
+    topic_handle topic(std::string_view name) {
+        if (name.size() > MaxTopicLength) {
+            throw std::length_error("rttl::dispatcher");
+        }
+        size_type pos = probe(name);
+        if (m_slots[pos] != 0) {
+            return topic_handle(m_slots[pos] - 1);
+        }
+        if (m_topic_count == MaxTopics) {
+            throw std::length_error("rttl::dispatcher");
+        }
+        topic_entry& t = m_topics[m_topic_count];
+        t.name.assign(name.data(), name.size());
+        t.head = npos;
+        t.tail = npos;
+        t.count = 0;
+        m_slots[pos] = static_cast<std::uint32_t>(++m_topic_count);
+        return topic_handle(m_slots[pos] - 1);
+    }
+
+    /**
+     * Handle of topic `name`, or an empty handle if it does not exist.
+     */
+    topic_handle find_topic(std::string_view name) const noexcept {
+        if (name.size() > MaxTopicLength) {
+            return topic_handle();
+        }
+        std::uint32_t slot = m_slots[probe(name)];
+        return (slot != 0) ? topic_handle(slot - 1) : topic_handle();
+    }
+
+    std::string_view topic_name(topic_handle topic) const noexcept {
+        return m_topics[topic.m_index].name;
+    }
+
+    size_type topic_count() const noexcept {
+        return m_topic_count;
+    }
+
+    /// @subsection Subscriptions
+
+    /**
+     * @name subscribe
+     *
+     * Subscribes callable `f` to a topic; throws `std::length_error` if there
+     * are `MaxSubscribers` subscriptions, or if the topic is given by name and
+     * cannot be created.
+     */
+    ///{
+    template <typename F>
+    subscription subscribe(topic_handle topic, F&& f) {
+        std::uint32_t slot = free_slot();
+        subscriber& s = m_subscribers[slot];
+        /// The slot is taken only once the callable is constructed, so it is
+        /// not lost if construction throws
+        m_callbacks[slot].emplace(std::forward<F>(f));
+        take(slot);
+        topic_entry& t = m_topics[topic.m_index];
+        s.topic = topic.m_index;
+        s.prev = t.tail;
+        s.next = npos;
+        (t.tail != npos ? m_subscribers[t.tail].next : t.head) = slot;
+        t.tail = slot;
+        ++t.count;
+        ++m_subscriber_count;
+        return subscription(slot, s.generation);
+    }
+
+    template <typename F>
+    subscription subscribe(std::string_view name, F&& f) {
+        return subscribe(topic(name), std::forward<F>(f));
+    }
+    ///}
+
+    /**
+     * Removes a subscription; returns `false` if it has already been removed.
+     */
+    bool unsubscribe(subscription sub) noexcept {
+        if (sub.m_slot >= m_used) {
+            return false;
+        }
+        subscriber& s = m_subscribers[sub.m_slot];
+        if (s.topic == npos || s.generation != sub.m_generation) {
+            return false;
+        }
+        topic_entry& t = m_topics[s.topic];
+        (s.prev != npos ? m_subscribers[s.prev].next : t.head) = s.next;
+        (s.next != npos ? m_subscribers[s.next].prev : t.tail) = s.prev;
+        --t.count;
+        --m_subscriber_count;
+        m_callbacks[sub.m_slot].reset();
+        s.topic = npos;
+        ++s.generation;
+        s.next = m_free;
+        m_free = sub.m_slot;
+        return true;
+    }
+
+    size_type subscriber_count() const noexcept {
+        return m_subscriber_count;
+    }
+
+    size_type subscriber_count(topic_handle topic) const noexcept {
+        return m_topics[topic.m_index].count;
+    }
+
+    /// @subsection Publishing
+
+    /**
+     * @name publish
+     *
+     * Calls subscribers of a topic with `args`; returns the number of
+     * subscribers called. Publishing by name to a topic that does not exist
+     * calls nobody.
+     */
+    ///{
+    size_type publish(topic_handle topic, Args... args) {
+        const topic_entry& t = m_topics[topic.m_index];
+        for (std::uint32_t i = t.head; i != npos; i = m_subscribers[i].next) {
+            m_callbacks[i](args...);
+        }
+        return t.count;
+    }
+
+    size_type publish(std::string_view name, Args... args) {
+        topic_handle topic = find_topic(name);
+        return topic ? publish(topic, args...) : 0;
+    }
+    ///}
+
+private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    struct topic_entry {
+        string<MaxTopicLength> name;
+        std::uint32_t head;
+        std::uint32_t tail;
+        std::uint32_t count;
+    };
+
+    /// Links of a subscriber entry, apart from its callable so that walking a
+    /// list touches 16 bytes per subscriber
+    struct subscriber {
+        /// Topic index, `npos` for free entries
+        std::uint32_t topic = npos;
+        std::uint32_t prev = npos;
+        /// Next subscriber of the topic, or next free entry
+        std::uint32_t next = npos;
+        std::uint32_t generation = 0;
+    };
+
+    static constexpr size_type slot_count_for(size_type n) noexcept {
+        size_type result = 1;
+        while (result < n) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    /// Slots, at least twice as many as topics, so that probes stay short
+    static constexpr size_type slot_count = slot_count_for(2 * MaxTopics);
+    static constexpr size_type mask = slot_count - 1;
+
+    /// Slot of topic `name`, or the empty slot where it would be inserted
+    size_type probe(std::string_view name) const noexcept {
+        size_type pos = std::hash<std::string_view>()(name) & mask;
+        while (m_slots[pos] != 0 && m_topics[m_slots[pos] - 1].name != name) {
+            pos = (pos + 1) & mask;
+        }
+        return pos;
+    }
+
+    /// Entry for a new subscriber, left free until `take`
+    std::uint32_t free_slot() const {
+        if (m_free != npos) {
+            return m_free;
+        }
+        if (m_used == MaxSubscribers) {
+            throw std::length_error("rttl::dispatcher");
+        }
+        return static_cast<std::uint32_t>(m_used);
+    }
+
+    void take(std::uint32_t slot) noexcept {
+        if (slot == m_free) {
+            m_free = m_subscribers[slot].next;
+        } else {
+            ++m_used;
+        }
+    }
+
+    /// Topic index plus one, zero for empty slots
+    std::array<std::uint32_t, slot_count> m_slots = {};
+    std::array<topic_entry, MaxTopics> m_topics;
+    size_type m_topic_count = 0;
+    std::array<subscriber, MaxSubscribers> m_subscribers;
+    std::array<callback_type, MaxSubscribers> m_callbacks;
+    /// Head of the list of free entries, and the number of entries ever used
+    std::uint32_t m_free = npos;
+    size_type m_used = 0;
+    size_type m_subscriber_count = 0;
+
+};
+
+}
+
+#endif // RTTL_DISPATCHER_H_
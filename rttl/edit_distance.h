@@ -0,0 +1,256 @@
+/**
+ * @file rttl/edit_distance.h
+ *
+ * Bounded edit (Levenshtein) distance of strings, for fuzzy matching.
+ *
+ * `rttl::edit_distance(a, b, max_k)` uses the bit-parallel algorithm of Myers,
+ * in the formulation of Hyyrö for global distance:
+ *  - the shorter string is the pattern, its columns of the dynamic programming
+ *    matrix are encoded as vertical deltas in bits of 64-bit words, so a
+ *    character of the other string is processed in `O(m / 64)` word operations
+ *    instead of `O(m)`;
+ *  - patterns of up to 64 characters take one word, longer ones up to
+ *    `MaxLength` characters take several words with carries between them;
+ *    the table of character masks is on the stack, `MaxLength` bounds its
+ *    size and is deduced from `rttl::string` arguments; characters index it
+ *    through a small table, and only rows of characters of the pattern are
+ *    initialized, so building it costs `O(m)` plus 512 bytes of zeroing;
+ *  - the computation stops as soon as the distance is known to exceed
+ *    `max_k`, in which case `max_k + 1` is returned;
+ *  - `rttl::edit_distances` builds the character masks of a query once and
+ *    scores it against a range of candidates, appending distances to an
+ *    `rttl::vector`.
+ *
+ * Characters are compared as bytes.
+ *
+ */
+#ifndef RTTL_EDIT_DISTANCE_H_
+#define RTTL_EDIT_DISTANCE_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include "rttl/string.h"
+#include "rttl/vector.h"
+
+namespace rttl {
+
+/// Default maximum length of the shorter string for `std::string_view`
+constexpr std::size_t edit_distance_max_length = 256;
+
+/// No bound on edit distance
+constexpr std::size_t edit_distance_unbounded =
+    std::numeric_limits<std::size_t>::max();
+
+namespace detail {
+
+/**
+ * Pattern of up to `64 * Blocks` characters encoded for the bit-parallel
+ * edit distance.
+ */
+template <std::size_t Blocks>
+class myers_pattern {
+public:
+    explicit myers_pattern(std::string_view pattern) {
+        if (pattern.size() > 64 * Blocks) {
+            throw std::length_error("rttl::edit_distance");
+        }
+        m_length = pattern.size();
+        const std::size_t blocks = (m_length + 63) / 64;
+        /// Only rows of characters of the pattern are cleared and filled
+        std::fill_n(m_peq[0].begin(), blocks, 0);
+        std::size_t rows = 1;
+        for (std::size_t i = 0; i < m_length; ++i) {
+            auto& row = m_row[static_cast<unsigned char>(pattern[i])];
+            if (row == 0) {
+                row = static_cast<std::uint16_t>(rows);
+                std::fill_n(m_peq[rows].begin(), blocks, 0);
+                ++rows;
+            }
+            m_peq[row][i / 64] |= std::uint64_t(1) << (i % 64);
+        }
+    }
+
+    myers_pattern(const myers_pattern&) = delete;
+    myers_pattern& operator=(const myers_pattern&) = delete;
+
+    /**
+     * Edit distance from `text`, or `max_k + 1` if it exceeds `max_k`.
+     */
+    std::size_t distance(std::string_view text, std::size_t max_k) const noexcept {
+        std::size_t m = m_length;
+        std::size_t n = text.size();
+        if ((m > n ? m - n : n - m) > max_k) {
+            return max_k + 1;
+        }
+        if (m == 0) {
+            return n;
+        }
+        return (m <= 64) ? distance_word(text, max_k)
+                         : distance_blocks(text, max_k);
+    }
+
+private:
+    using mask_row = std::array<std::uint64_t, Blocks>;
+
+    /// Distinct characters of a pattern, plus the row of all others
+    static constexpr std::size_t row_count = std::min<std::size_t>(64 * Blocks, 256) + 1;
+
+    const mask_row& masks(char c) const noexcept {
+        return m_peq[m_row[static_cast<unsigned char>(c)]];
+    }
+
+    /// Whether `score` after `j` of `n` characters can no longer fall to `max_k`
+    static bool exceeds(std::size_t score, std::size_t max_k, std::size_t j,
+                        std::size_t n) noexcept {
+        return score > max_k && score - max_k > n - j;
+    }
+
+    std::size_t distance_word(std::string_view text,
+                              std::size_t max_k) const noexcept {
+        const std::uint64_t high = std::uint64_t(1) << (m_length - 1);
+        std::uint64_t pv = ~std::uint64_t(0);
+        std::uint64_t mv = 0;
+        std::size_t score = m_length;
+        for (std::size_t j = 0; j < text.size(); ++j) {
+            std::uint64_t eq = masks(text[j])[0];
+            std::uint64_t xv = eq | mv;
+            std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            std::uint64_t ph = mv | ~(xh | pv);
+            std::uint64_t mh = pv & xh;
+            if (ph & high) {
+                ++score;
+            } else if (mh & high) {
+                --score;
+            }
+            /// The first row of the matrix increases by one per column
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            if (exceeds(score, max_k, j + 1, text.size())) {
+                return max_k + 1;
+            }
+        }
+        return (score > max_k) ? max_k + 1 : score;
+    }
+
+    std::size_t distance_blocks(std::string_view text,
+                                std::size_t max_k) const noexcept {
+        const std::size_t blocks = (m_length + 63) / 64;
+        const std::uint64_t high = std::uint64_t(1) << ((m_length - 1) % 64);
+        std::array<std::uint64_t, Blocks> pv;
+        std::array<std::uint64_t, Blocks> mv;
+        std::fill_n(pv.begin(), blocks, ~std::uint64_t(0));
+        std::fill_n(mv.begin(), blocks, 0);
+        std::size_t score = m_length;
+        for (std::size_t j = 0; j < text.size(); ++j) {
+            const auto& peq = masks(text[j]);
+            /// Horizontal delta entering the block from above: -1, 0 or +1
+            int h = 1;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                std::uint64_t eq = peq[b];
+                std::uint64_t xv = eq | mv[b];
+                if (h < 0) {
+                    eq |= 1;
+                }
+                std::uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+                std::uint64_t ph = mv[b] | ~(xh | pv[b]);
+                std::uint64_t mh = pv[b] & xh;
+                std::uint64_t out_bit = (b + 1 == blocks) ? high
+                                                          : std::uint64_t(1) << 63;
+                int h_out = (ph & out_bit) ? 1 : ((mh & out_bit) ? -1 : 0);
+                ph <<= 1;
+                mh <<= 1;
+                if (h < 0) {
+                    mh |= 1;
+                } else if (h > 0) {
+                    ph |= 1;
+                }
+                pv[b] = mh | ~(xv | ph);
+                mv[b] = ph & xv;
+                h = h_out;
+            }
+            score = static_cast<std::size_t>(
+                static_cast<std::ptrdiff_t>(score) + h);
+            if (exceeds(score, max_k, j + 1, text.size())) {
+                return max_k + 1;
+            }
+        }
+        return (score > max_k) ? max_k + 1 : score;
+    }
+
+    /// Row of masks of every character, zero for characters not in the
+    /// pattern; a small index instead of a row per character, so that only
+    /// rows used are initialized
+    std::array<std::uint16_t, 256> m_row = {};
+    /// Masks of positions of characters, uninitialized beyond those used
+    std::array<mask_row, row_count> m_peq;
+    std::size_t m_length;
+
+};
+
+constexpr std::size_t edit_distance_blocks(std::size_t max_length) noexcept {
+    return (max_length + 63) / 64;
+}
+
+}
+
+/**
+ * @name edit_distance
+ *
+ * Edit distance of `a` and `b` if it does not exceed `max_k`, otherwise
+ * `max_k + 1`; throws `std::length_error` if the shorter string is longer
+ * than `MaxLength`.
+ */
+///{
+template <std::size_t MaxLength = edit_distance_max_length>
+std::size_t edit_distance(std::string_view a, std::string_view b,
+                          std::size_t max_k = edit_distance_unbounded) {
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    detail::myers_pattern<detail::edit_distance_blocks(MaxLength)> pattern(a);
+    return pattern.distance(b, max_k);
+}
+
+template <std::size_t MaxLength1, std::size_t MaxLength2, typename Traits>
+std::size_t edit_distance(const basic_string<MaxLength1, char, Traits>& a,
+                          const basic_string<MaxLength2, char, Traits>& b,
+                          std::size_t max_k = edit_distance_unbounded) {
+    return edit_distance<std::min(MaxLength1, MaxLength2)>(
+        std::string_view(a.data(), a.size()),
+        std::string_view(b.data(), b.size()), max_k);
+}
+///}
+
+/**
+ * Appends to `out` the edit distance of `query` to every string of
+ * `candidates`, as `edit_distance` does; throws `std::length_error` before
+ * modifying `out` if `query` is longer than `MaxLength` or the distances do
+ * not fit.
+ */
+template <std::size_t MaxLength = edit_distance_max_length, typename Range,
+          std::size_t MaxSize>
+void edit_distances(std::string_view query, const Range& candidates,
+                    std::size_t max_k, vector<std::size_t, MaxSize>& out) {
+    detail::myers_pattern<detail::edit_distance_blocks(MaxLength)>
+        pattern(query);
+    auto count = static_cast<std::size_t>(
+        std::distance(std::begin(candidates), std::end(candidates)));
+    out.append_uninitialized(count, [&](std::size_t* d_first, std::size_t) {
+        for (const auto& candidate : candidates) {
+            std::string_view text(std::data(candidate), std::size(candidate));
+            *d_first++ = pattern.distance(text, max_k);
+        }
+        return count;
+    });
+}
+
+}
+
+#endif // RTTL_EDIT_DISTANCE_H_
@@ -0,0 +1,385 @@
+/**
+ * @file rttl/group_by.h
+ *
+ * Group-by aggregation of ranges without dynamic allocation, for analytics
+ * over batches of records.
+ *
+ * `rttl::group_by(input, key_fn, out, aggregators...)` groups elements of
+ * `input` by `Key(key_fn(element))` into `out`, an
+ * `rttl::vector<rttl::group_row<Key, Results...>, MaxGroups>` owned by the
+ * caller, with a row per group, in the order of first appearance, holding
+ * the key and a tuple of results of `aggregators`, converted to `Results`:
+ *  - groups are found with an open-addressing hash table with linear probing,
+ *    of twice as many slots as groups, keyed by `std::hash<Key>` mixed by a
+ *    multiplicative hash; the state of every aggregator is stored inline with
+ *    the key of its group;
+ *  - the table has static storage, one per thread and instantiation, and is
+ *    reset per call only at the slots of groups used, so calls do not touch
+ *    memory proportional to `MaxGroups`; calls of the same instantiation must
+ *    not be nested within aggregators;
+ *  - `rttl::group_by_sorted` is the fast path for input where equal keys are
+ *    adjacent, e.g. sorted by key: it needs no table and compares keys of
+ *    consecutive elements only;
+ *  - more than `MaxGroups` groups throw `std::length_error`.
+ *
+ * Important note: the table is `thread_local`, so every thread holds one of
+ * about `MaxGroups` times the size of a key and the aggregator states. Calls
+ * check a guard of its initialization unless it is constant-initialized, and
+ * in a shared library the runtime may allocate the thread-local block lazily,
+ * on the first call in each thread; calls do not allocate otherwise. Output
+ * rows are best kept in static storage as well for large `MaxGroups`.
+ *
+ * Aggregators of `rttl::aggregate` are `count()`, `sum(f)`, `min(f)`, `max(f)`,
+ * `mean(f)` and `weighted_mean(f, w)`, the latter computing e.g. VWAP as
+ * `weighted_mean(price, quantity)`; `f` and `w` take an element of `input`.
+ * Custom aggregators provide member templates of an element type `Row`:
+ * `state<Row>`, value-initialized for a new group, `result_type<Row>`, the
+ * natural type of the result, `add(state&, const Row&)` and
+ * `result<Row>(const state&)`.
+ *
+ */
+#ifndef RTTL_GROUP_BY_H_
+#define RTTL_GROUP_BY_H_
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "rttl/algorithm.h"
+#include "rttl/bit.h"
+#include "rttl/vector.h"
+
+namespace rttl {
+
+template <typename Key, typename... Results>
+struct group_row {
+    Key key;
+    std::tuple<Results...> values;
+};
+
+namespace detail {
+
+template <typename Function, typename Row>
+using aggregate_value_t = std::decay_t<std::invoke_result_t<const Function&, const Row&>>;
+
+struct count_aggregator {
+    template <typename Row> using state = std::size_t;
+    template <typename Row> using result_type = std::size_t;
+
+    template <typename Row>
+    void add(std::size_t& count, const Row&) const noexcept {
+        ++count;
+    }
+
+    template <typename Row>
+    std::size_t result(std::size_t count) const noexcept {
+        return count;
+    }
+};
+
+template <typename Function>
+struct sum_aggregator {
+    Function f;
+
+    template <typename Row> using state = aggregate_value_t<Function, Row>;
+    template <typename Row> using result_type = aggregate_value_t<Function, Row>;
+
+    template <typename Row>
+    void add(state<Row>& sum, const Row& row) const {
+        sum += f(row);
+    }
+
+    template <typename Row>
+    result_type<Row> result(const state<Row>& sum) const {
+        return sum;
+    }
+};
+
+template <typename Function, typename Compare>
+struct extremum_aggregator {
+    Function f;
+
+    template <typename Row>
+    struct state {
+        aggregate_value_t<Function, Row> value;
+        bool set;
+    };
+
+    template <typename Row> using result_type = aggregate_value_t<Function, Row>;
+
+    template <typename Row>
+    void add(state<Row>& s, const Row& row) const {
+        auto value = f(row);
+        if (!s.set || Compare()(value, s.value)) {
+            s.value = value;
+            s.set = true;
+        }
+    }
+
+    template <typename Row>
+    result_type<Row> result(const state<Row>& s) const {
+        return s.value;
+    }
+};
+
+template <typename Function>
+struct mean_aggregator {
+    Function f;
+
+    template <typename Row>
+    struct state {
+        aggregate_value_t<Function, Row> sum;
+        std::size_t count;
+    };
+
+    template <typename Row> using result_type = double;
+
+    template <typename Row>
+    void add(state<Row>& s, const Row& row) const {
+        s.sum += f(row);
+        ++s.count;
+    }
+
+    template <typename Row>
+    double result(const state<Row>& s) const {
+        return static_cast<double>(s.sum) / static_cast<double>(s.count);
+    }
+};
+
+template <typename Function, typename Weight>
+struct weighted_mean_aggregator {
+    Function f;
+    Weight w;
+
+    struct sums {
+        double weighted;
+        double weights;
+    };
+
+    template <typename Row> using state = sums;
+    template <typename Row> using result_type = double;
+
+    template <typename Row>
+    void add(sums& s, const Row& row) const {
+        auto weight = static_cast<double>(w(row));
+        s.weighted += static_cast<double>(f(row)) * weight;
+        s.weights += weight;
+    }
+
+    template <typename Row>
+    double result(const sums& s) const noexcept {
+        return (s.weights < 0 || s.weights > 0) ? s.weighted / s.weights : 0.0;
+    }
+};
+
+}
+
+namespace aggregate {
+
+/// Number of elements
+inline detail::count_aggregator count() noexcept {
+    return {};
+}
+
+/// Sum of `f(element)`, in the type of `f(element)`
+template <typename Function>
+detail::sum_aggregator<Function> sum(Function f) {
+    return { std::move(f) };
+}
+
+template <typename Function>
+detail::extremum_aggregator<Function, std::less<>> min(Function f) {
+    return { std::move(f) };
+}
+
+template <typename Function>
+detail::extremum_aggregator<Function, std::greater<>> max(Function f) {
+    return { std::move(f) };
+}
+
+/// Arithmetic mean of `f(element)` as `double`
+template <typename Function>
+detail::mean_aggregator<Function> mean(Function f) {
+    return { std::move(f) };
+}
+
+/// Mean of `f(element)` weighted by `w(element)` as `double`, zero if weights
+/// sum up to zero
+template <typename Function, typename Weight>
+detail::weighted_mean_aggregator<Function, Weight> weighted_mean(Function f, Weight w) {
+    return { std::move(f), std::move(w) };
+}
+
+}
+
+namespace detail {
+
+/**
+ * Open-addressing table of groups, with entries in the order of insertion.
+ */
+template <typename Key, std::size_t MaxGroups, typename State>
+class group_index {
+    static_assert(MaxGroups > 0, "MaxGroups must be positive");
+    static_assert(MaxGroups < std::numeric_limits<std::uint32_t>::max(),
+                  "Group numbers must fit in 32 bits");
+public:
+    using size_type = std::size_t;
+
+    struct entry {
+        Key key;
+        State state;
+        /// Position of the slot holding this entry
+        std::uint32_t slot;
+    };
+
+    /**
+     * State of the group of `key`, value-initialized for a new group; throws
+     * `std::length_error` if a new group does not fit.
+     */
+    State& find_or_insert(const Key& key) {
+        std::uint64_t hash = std::hash<Key>()(key);
+        size_type pos = (hash * 0x9E3779B97F4A7C15u) >> shift;
+        for (;; pos = (pos + 1) & mask) {
+            std::uint32_t slot = m_slots[pos];
+            if (slot == 0) {
+                break;
+            }
+            if (m_entries[slot - 1].key == key) {
+                return m_entries[slot - 1].state;
+            }
+        }
+        if (m_size == MaxGroups) {
+            throw std::length_error("rttl::group_by");
+        }
+        m_entries[m_size] = entry{ key, State(), static_cast<std::uint32_t>(pos) };
+        m_slots[pos] = static_cast<std::uint32_t>(++m_size);
+        return m_entries[m_size - 1].state;
+    }
+
+    void clear() noexcept {
+        for (size_type i = 0; i < m_size; ++i) {
+            m_slots[m_entries[i].slot] = 0;
+        }
+        m_size = 0;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    const entry& operator[](size_type i) const noexcept {
+        return m_entries[i];
+    }
+
+private:
+    static constexpr size_type slot_count_for(size_type n) noexcept {
+        size_type result = 2;
+        while (result < n) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    static constexpr size_type slot_count = slot_count_for(2 * MaxGroups);
+    static constexpr size_type mask = slot_count - 1;
+    /// Shift leaving the upper bits of the hash that index slots
+    static constexpr int shift = 64 - bit_width(mask);
+
+    /// Group number plus one, zero for empty slots
+    std::array<std::uint32_t, slot_count> m_slots = {};
+    std::array<entry, MaxGroups> m_entries;
+    size_type m_size = 0;
+
+};
+
+template <typename Row, typename... Aggregators>
+using group_state_t = std::tuple<typename Aggregators::template state<Row>...>;
+
+template <typename Row, typename State, typename Tuple, std::size_t... I>
+void aggregate_row(State& state, const Row& row, const Tuple& aggregators,
+                   std::index_sequence<I...>) {
+    (std::get<I>(aggregators).add(std::get<I>(state), row), ...);
+}
+
+template <typename OutRow, typename Row, typename Key, typename State,
+          typename Tuple, std::size_t... I>
+OutRow make_group_row(const Key& key, const State& state, const Tuple& aggregators,
+                      std::index_sequence<I...>) {
+    return OutRow{ key,
+        { std::get<I>(aggregators).template result<Row>(std::get<I>(state))... } };
+}
+
+}
+
+/**
+ * Replaces contents of `out` with rows of groups of `input` by `key_fn`, in
+ * the order of first appearance; throws `std::length_error` if there are
+ * more groups than `out` holds, leaving `out` empty.
+ */
+template <typename Range, typename KeyFunction, typename Key, typename... Results,
+          std::size_t MaxGroups, typename... Aggregators>
+void group_by(const Range& input, KeyFunction key_fn,
+              vector<group_row<Key, Results...>, MaxGroups>& out,
+              Aggregators... aggregators) {
+    static_assert(sizeof...(Results) == sizeof...(Aggregators),
+                  "A result per aggregator is required");
+    using row_type = typename detail::range_value<Range>::type;
+    using out_row = group_row<Key, Results...>;
+    using state_type = detail::group_state_t<row_type, Aggregators...>;
+    using sequence = std::index_sequence_for<Aggregators...>;
+    static thread_local detail::group_index<Key, MaxGroups, state_type> index;
+    /// Cleared before use, as a previous call may have thrown
+    index.clear();
+    out.clear();
+    std::tuple<Aggregators...> aggs(std::move(aggregators)...);
+    for (const auto& row : input) {
+        detail::aggregate_row(index.find_or_insert(Key(key_fn(row))), row, aggs,
+                              sequence());
+    }
+    for (std::size_t i = 0; i < index.size(); ++i) {
+        out.push_back(detail::make_group_row<out_row, row_type>(
+            index[i].key, index[i].state, aggs, sequence()));
+    }
+}
+
+/**
+ * Replaces contents of `out` with rows of groups of `input` by `key_fn`,
+ * where elements with equal keys must be adjacent; rows of non-adjacent
+ * elements with equal keys are separate. Throws `std::length_error` if
+ * there are more groups than `out` holds, leaving the rows that fit.
+ */
+template <typename Range, typename KeyFunction, typename Key, typename... Results,
+          std::size_t MaxGroups, typename... Aggregators>
+void group_by_sorted(const Range& input, KeyFunction key_fn,
+                     vector<group_row<Key, Results...>, MaxGroups>& out,
+                     Aggregators... aggregators) {
+    static_assert(sizeof...(Results) == sizeof...(Aggregators),
+                  "A result per aggregator is required");
+    using row_type = typename detail::range_value<Range>::type;
+    using out_row = group_row<Key, Results...>;
+    using state_type = detail::group_state_t<row_type, Aggregators...>;
+    using sequence = std::index_sequence_for<Aggregators...>;
+    std::tuple<Aggregators...> aggs(std::move(aggregators)...);
+    out.clear();
+    auto first = std::begin(input);
+    auto last = std::end(input);
+    while (first != last) {
+        Key key(key_fn(*first));
+        state_type state{};
+        do {
+            detail::aggregate_row(state, *first, aggs, sequence());
+            ++first;
+        } while (first != last && Key(key_fn(*first)) == key);
+        out.push_back(detail::make_group_row<out_row, row_type>(
+            key, state, aggs, sequence()));
+    }
+}
+
+}
+
+#endif // RTTL_GROUP_BY_H_
@@ -0,0 +1,504 @@
+/**
+ * @file rttl/hdr_histogram.h
+ *
+ * High dynamic range (HDR) histogram with statically allocated buckets.
+ *
+ * Records integer values in range `[0, MaxValue]` keeping `SignificantDigits`
+ * decimal digits of precision, i.e. values are counted in buckets whose width
+ * is proportional to the magnitude of the value. Values below `MinValue` are
+ * counted with `MinValue` resolution. Bucket layout is the same as that of
+ * the HdrHistogram library:
+ *  - the bucket array is a class member, its size is computed at compile time
+ *    from the template arguments;
+ *  - `record` is wait-free and `O(1)`: a few shifts and one increment; it does
+ *    not track total count, minimum or maximum, those are computed by queries;
+ *  - `rttl::atomic_hdr_histogram` counts with relaxed atomic increments and
+ *    may be recorded into by multiple threads; queries running concurrently
+ *    with recording see a consistent value of every single bucket only;
+ *  - queries (`value_at_percentile`, `total_count`, `min`, `max`, `mean`) are
+ *    linear in number of buckets, not in number of recorded values;
+ *  - histograms of the same parameters are merged with `add`;
+ *  - `serialize` writes a compact form, in which counts are ZigZag LEB128
+ *    varints and runs of empty buckets take one varint.
+ *
+ * Important note: Be careful with placing histograms on the stack, the bucket
+ * array takes `8 * bucket_count()` bytes.
+ *
+ */
+#ifndef RTTL_HDR_HISTOGRAM_H_
+#define RTTL_HDR_HISTOGRAM_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+#include "rttl/bit.h"
+#include "rttl/vector.h"
+
+namespace rttl {
+
+namespace detail {
+
+constexpr int hdr_sub_bucket_count_magnitude(int significant_digits) noexcept {
+    std::int64_t largest_single_unit = 2;
+    for (int i = 0; i < significant_digits; ++i) {
+        largest_single_unit *= 10;
+    }
+    int magnitude = 0;
+    while ((std::int64_t(1) << magnitude) < largest_single_unit) {
+        ++magnitude;
+    }
+    return magnitude;
+}
+
+constexpr int hdr_unit_magnitude(std::int64_t min_value) noexcept {
+    int magnitude = 0;
+    while ((min_value >> (magnitude + 1)) != 0) {
+        ++magnitude;
+    }
+    return magnitude;
+}
+
+constexpr int hdr_buckets_needed(std::int64_t max_value, int unit_magnitude,
+                                 int sub_bucket_count_magnitude) noexcept {
+    std::int64_t smallest_untrackable = std::int64_t(1)
+        << (unit_magnitude + sub_bucket_count_magnitude);
+    int buckets_needed = 1;
+    while (smallest_untrackable <= max_value) {
+        if (smallest_untrackable > INT64_MAX / 2) {
+            return buckets_needed + 1;
+        }
+        smallest_untrackable <<= 1;
+        ++buckets_needed;
+    }
+    return buckets_needed;
+}
+
+template <typename Counter>
+std::int64_t load_counter(const Counter& c) noexcept {
+    if constexpr(std::is_integral<Counter>::value) {
+        return c;
+    } else {
+        return c.load(std::memory_order_relaxed);
+    }
+}
+
+template <typename Counter>
+void add_counter(Counter& c, std::int64_t n) noexcept {
+    if constexpr(std::is_integral<Counter>::value) {
+        c += n;
+    } else {
+        c.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+template <typename Counter>
+void store_counter(Counter& c, std::int64_t n) noexcept {
+    if constexpr(std::is_integral<Counter>::value) {
+        c = n;
+    } else {
+        c.store(n, std::memory_order_relaxed);
+    }
+}
+
+}
+
+
+template <std::int64_t MinValue, std::int64_t MaxValue, int SignificantDigits,
+          typename Counter = std::int64_t>
+class hdr_histogram {
+    static_assert(MinValue >= 1, "MinValue must be positive");
+    static_assert(MaxValue >= 2 * MinValue,
+                  "MaxValue must be at least twice the MinValue");
+    static_assert(SignificantDigits >= 1 && SignificantDigits <= 5,
+                  "SignificantDigits must be in range 1..5");
+    static_assert(std::is_same<Counter, std::int64_t>::value ||
+                  std::is_same<Counter, std::atomic<std::int64_t>>::value,
+                  "Counter must be std::int64_t or std::atomic<std::int64_t>");
+
+    static constexpr int sub_bucket_count_magnitude =
+        detail::hdr_sub_bucket_count_magnitude(SignificantDigits);
+    static constexpr int sub_bucket_half_count_magnitude =
+        sub_bucket_count_magnitude - 1;
+    static constexpr int unit_magnitude = detail::hdr_unit_magnitude(MinValue);
+    static constexpr std::int64_t sub_bucket_count =
+        std::int64_t(1) << sub_bucket_count_magnitude;
+    static constexpr std::int64_t sub_bucket_half_count = sub_bucket_count / 2;
+    static constexpr std::uint64_t sub_bucket_mask =
+        static_cast<std::uint64_t>(sub_bucket_count - 1) << unit_magnitude;
+    static constexpr int buckets_count = detail::hdr_buckets_needed(
+        MaxValue, unit_magnitude, sub_bucket_count_magnitude);
+    static constexpr std::size_t counts_length =
+        static_cast<std::size_t>((buckets_count + 1) * sub_bucket_half_count);
+
+public:
+
+    /// @section Member types
+
+    using value_type = std::int64_t;
+    using count_type = std::int64_t;
+    using size_type = std::size_t;
+
+    /// @section Member functions
+
+    hdr_histogram() noexcept = default;
+
+    hdr_histogram(const hdr_histogram& other) noexcept {
+        *this = other;
+    }
+
+    hdr_histogram& operator=(const hdr_histogram& other) noexcept {
+        for (size_type i = 0; i < counts_length; ++i) {
+            detail::store_counter(m_counts[i],
+                                  detail::load_counter(other.m_counts[i]));
+        }
+        return *this;
+    }
+
+    static constexpr value_type min_value() noexcept {
+        return MinValue;
+    }
+
+    static constexpr value_type max_value() noexcept {
+        return MaxValue;
+    }
+
+    static constexpr int significant_digits() noexcept {
+        return SignificantDigits;
+    }
+
+    /**
+     * Number of buckets, i.e. size of the bucket array.
+     */
+    static constexpr size_type bucket_count() noexcept {
+        return counts_length;
+    }
+
+    /// @subsection Recording
+
+    /**
+     * Counts `value` `count` times; returns `false` leaving the histogram
+     * intact if the value is out of range `[0, MaxValue]` or the count is
+     * negative.
+     */
+    bool record(value_type value, count_type count = 1) noexcept {
+        if (value < 0 || value > MaxValue || count < 0) {
+            return false;
+        }
+        detail::add_counter(m_counts[index_of(value)], count);
+        return true;
+    }
+
+    /**
+     * Adds counts of `other` histogram of the same parameters.
+     */
+    template <typename Counter2>
+    void add(const hdr_histogram<MinValue, MaxValue, SignificantDigits,
+                                 Counter2>& other) noexcept {
+        for (size_type i = 0; i < counts_length; ++i) {
+            std::int64_t n = detail::load_counter(other.m_counts[i]);
+            if (n != 0) {
+                detail::add_counter(m_counts[i], n);
+            }
+        }
+    }
+
+    void reset() noexcept {
+        for (auto& c : m_counts) {
+            detail::store_counter(c, 0);
+        }
+    }
+
+    /// @subsection Queries
+
+    count_type total_count() const noexcept {
+        count_type result = 0;
+        for (const auto& c : m_counts) {
+            result += detail::load_counter(c);
+        }
+        return result;
+    }
+
+    /**
+     * Number of recorded values equivalent to `value`.
+     */
+    count_type count_at(value_type value) const noexcept {
+        if (value < 0 || value > MaxValue) {
+            return 0;
+        }
+        return detail::load_counter(m_counts[index_of(value)]);
+    }
+
+    /**
+     * Least recorded value (rounded down to its bucket); zero if empty.
+     */
+    value_type min() const noexcept {
+        for (size_type i = 0; i < counts_length; ++i) {
+            if (detail::load_counter(m_counts[i]) != 0) {
+                return lowest_equivalent(value_at_index(i));
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Greatest recorded value (rounded up to its bucket); zero if empty.
+     */
+    value_type max() const noexcept {
+        for (size_type i = counts_length; i > 0; --i) {
+            if (detail::load_counter(m_counts[i - 1]) != 0) {
+                return highest_equivalent(value_at_index(i - 1));
+            }
+        }
+        return 0;
+    }
+
+    double mean() const noexcept {
+        count_type total = 0;
+        double sum = 0.0;
+        for (size_type i = 0; i < counts_length; ++i) {
+            count_type n = detail::load_counter(m_counts[i]);
+            if (n != 0) {
+                total += n;
+                sum += static_cast<double>(median_equivalent(value_at_index(i)))
+                     * static_cast<double>(n);
+            }
+        }
+        return (total == 0) ? 0.0 : sum / static_cast<double>(total);
+    }
+
+    /**
+     * Value that `percentile` (in range `[0, 100]`) of recorded values are
+     * less than or equivalent to; zero if empty.
+     */
+    value_type value_at_percentile(double percentile) const noexcept {
+        count_type total = total_count();
+        if (total == 0) {
+            return 0;
+        }
+        percentile = std::min(std::max(percentile, 0.0), 100.0);
+        auto target = static_cast<count_type>(
+            percentile / 100.0 * static_cast<double>(total) + 0.5);
+        target = std::max(target, count_type(1));
+        count_type running = 0;
+        for (size_type i = 0; i < counts_length; ++i) {
+            running += detail::load_counter(m_counts[i]);
+            if (running >= target) {
+                return highest_equivalent(value_at_index(i));
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @name Equivalent values
+     *
+     * Values counted in the same bucket as `value` are equivalent to it.
+     */
+    ///{
+    static constexpr value_type lowest_equivalent(value_type value) noexcept {
+        int bucket = bucket_index(value);
+        return value_from(bucket, sub_bucket_index(value, bucket));
+    }
+
+    static constexpr value_type equivalent_range(value_type value) noexcept {
+        int bucket = bucket_index(value);
+        std::int64_t sub_bucket = sub_bucket_index(value, bucket);
+        int adjusted = (sub_bucket >= sub_bucket_count) ? bucket + 1 : bucket;
+        return value_type(1) << (unit_magnitude + adjusted);
+    }
+
+    static constexpr value_type highest_equivalent(value_type value) noexcept {
+        return lowest_equivalent(value) + equivalent_range(value) - 1;
+    }
+
+    static constexpr value_type median_equivalent(value_type value) noexcept {
+        return lowest_equivalent(value) + (equivalent_range(value) >> 1);
+    }
+    ///}
+
+    /// @subsection Serialization
+
+    /**
+     * Maximum number of bytes `serialize` writes.
+     */
+    static constexpr size_type max_serialized_size() noexcept {
+        return counts_length * 10;
+    }
+
+    /**
+     * Number of bytes `serialize` writes for the current counts.
+     */
+    size_type serialized_size() const noexcept {
+        size_type size = 0;
+        encode([&size](count_type n) { size += varint_size(n); });
+        return size;
+    }
+
+    /**
+     * Appends the compact form of bucket counts to `out`; throws
+     * `std::length_error` leaving `out` intact if it does not fit, also if
+     * counts recorded concurrently make it longer than computed up front.
+     */
+    template <std::size_t MaxSize>
+    void serialize(vector<std::uint8_t, MaxSize>& out) const {
+        const size_type first = out.size();
+        if (serialized_size() > out.max_size() - first) {
+            throw std::length_error("rttl::hdr_histogram");
+        }
+        try {
+            encode([&out](count_type n) { write_varint(out, n); });
+        } catch (...) {
+            out.resize(first);
+            throw;
+        }
+    }
+
+    /**
+     * Replaces bucket counts with ones read from the compact form; throws
+     * `std::invalid_argument` if the data is malformed, leaving the histogram
+     * in a valid but unspecified state.
+     */
+    void deserialize(const std::uint8_t* data, size_type size) {
+        const std::uint8_t* end = data + size;
+        size_type i = 0;
+        while (data != end) {
+            count_type n = read_varint(data, end);
+            if (n < 0) {
+                /// Compared without negating `n`, which may be the minimum
+                if (n < -static_cast<count_type>(counts_length - i)) {
+                    throw std::invalid_argument("rttl::hdr_histogram");
+                }
+                for (count_type k = n; k < 0; ++k) {
+                    detail::store_counter(m_counts[i++], 0);
+                }
+            } else {
+                if (i >= counts_length) {
+                    throw std::invalid_argument("rttl::hdr_histogram");
+                }
+                detail::store_counter(m_counts[i++], n);
+            }
+        }
+        if (i != counts_length) {
+            throw std::invalid_argument("rttl::hdr_histogram");
+        }
+    }
+
+private:
+    static constexpr int bucket_index(value_type value) noexcept {
+        int pow2ceiling = 64 - countl_zero(static_cast<std::uint64_t>(value) |
+                                           sub_bucket_mask);
+        return pow2ceiling - unit_magnitude -
+               (sub_bucket_half_count_magnitude + 1);
+    }
+
+    static constexpr std::int64_t sub_bucket_index(value_type value,
+                                                   int bucket) noexcept {
+        return value >> (bucket + unit_magnitude);
+    }
+
+    static constexpr value_type value_from(int bucket,
+                                           std::int64_t sub_bucket) noexcept {
+        return sub_bucket << (bucket + unit_magnitude);
+    }
+
+    static constexpr size_type index_of(value_type value) noexcept {
+        int bucket = bucket_index(value);
+        std::int64_t sub_bucket = sub_bucket_index(value, bucket);
+        return static_cast<size_type>(
+            (std::int64_t(bucket + 1) << sub_bucket_half_count_magnitude) +
+            (sub_bucket - sub_bucket_half_count));
+    }
+
+    static constexpr value_type value_at_index(size_type index) noexcept {
+        auto i = static_cast<std::int64_t>(index);
+        int bucket = static_cast<int>(i >> sub_bucket_half_count_magnitude) - 1;
+        std::int64_t sub_bucket = (i & (sub_bucket_half_count - 1)) +
+                                  sub_bucket_half_count;
+        if (bucket < 0) {
+            sub_bucket -= sub_bucket_half_count;
+            bucket = 0;
+        }
+        return value_from(bucket, sub_bucket);
+    }
+
+    /**
+     * Calls `emit` with every number of the compact form: a count of a
+     * bucket, or a run of empty buckets as a negative number.
+     */
+    template <typename Emit>
+    void encode(Emit emit) const {
+        size_type i = 0;
+        while (i < counts_length) {
+            count_type n = detail::load_counter(m_counts[i]);
+            ++i;
+            if (n == 0) {
+                count_type zeros = 1;
+                while (i < counts_length &&
+                       detail::load_counter(m_counts[i]) == 0) {
+                    ++zeros;
+                    ++i;
+                }
+                n = -zeros;
+            }
+            emit(n);
+        }
+    }
+
+    static size_type varint_size(count_type n) noexcept {
+        std::uint64_t v = (static_cast<std::uint64_t>(n) << 1) ^
+                          static_cast<std::uint64_t>(n >> 63);
+        size_type size = 1;
+        for (; v >= 0x80; v >>= 7) {
+            ++size;
+        }
+        return size;
+    }
+
+    template <std::size_t MaxSize>
+    static void write_varint(vector<std::uint8_t, MaxSize>& out,
+                             count_type n) {
+        /// ZigZag encoding maps small negative numbers to small codes
+        std::uint64_t v = (static_cast<std::uint64_t>(n) << 1) ^
+                          static_cast<std::uint64_t>(n >> 63);
+        while (v >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    static count_type read_varint(const std::uint8_t*& data,
+                                  const std::uint8_t* end) {
+        std::uint64_t v = 0;
+        for (int shift = 0; ; shift += 7) {
+            if (data == end || shift > 63) {
+                throw std::invalid_argument("rttl::hdr_histogram");
+            }
+            std::uint8_t byte = *data++;
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        return static_cast<count_type>(v >> 1) ^ -static_cast<count_type>(v & 1);
+    }
+
+    std::array<Counter, counts_length> m_counts = {};
+
+    /// Friend declaration to allow `add` of histograms with other counters
+    template <std::int64_t, std::int64_t, int, typename>
+    friend class hdr_histogram;
+
+};
+
+
+template <std::int64_t MinValue, std::int64_t MaxValue, int SignificantDigits>
+using atomic_hdr_histogram = hdr_histogram<MinValue, MaxValue,
+    SignificantDigits, std::atomic<std::int64_t>>;
+
+}
+
+#endif // RTTL_HDR_HISTOGRAM_H_
@@ -0,0 +1,749 @@
+/**
+ * @file rttl/intrusive.h
+ *
+ * Intrusive containers with link hooks as members of elements, for objects
+ * stored elsewhere, e.g. in an `rttl::vector` or a pool, that must be in
+ * several lookup structures at once.
+ *
+ * Containers link elements in place instead of holding copies or pointers,
+ * so they neither allocate nor add indirections:
+ *  - `rttl::intrusive_list<T, &T::hook>` is a doubly linked list of elements
+ *    with a member `rttl::intrusive_list_hook hook`;
+ *  - `rttl::intrusive_hash_set<T, &T::hook, BucketCount, KeyOf, Hash>` is a
+ *    hash set of elements with a member `rttl::intrusive_hash_hook hook`,
+ *    keyed by `KeyOf()(element)`, with a fixed array of `BucketCount`
+ *    buckets chained through the hooks;
+ *  - an element has a hook per container it may be in, and is in at most one
+ *    container per hook; linking and unlinking are `O(1)`, apart from the
+ *    lookup of duplicate keys of a hash set;
+ *  - hooks are safe: linking an element that is already linked throws
+ *    `std::invalid_argument`, and hooks unlink themselves when elements are
+ *    destroyed, so containers never refer to destroyed elements; since
+ *    elements may leave containers unnoticed, `size()` counts elements in
+ *    linear time.
+ *
+ * Elements must be standard-layout types, so that a hook and its element
+ * are at a fixed offset from each other.
+ *
+ * Important note: links belong to the storage of an element, not its value:
+ * copying or assigning elements neither copies nor changes links of hooks,
+ * so elements should be unlinked before operations that shift values of
+ * others, such as `rttl::vector::erase`. Containers are neither copyable nor
+ * movable, and unlink all elements when destroyed.
+ *
+ */
+#ifndef RTTL_INTRUSIVE_H_
+#define RTTL_INTRUSIVE_H_
+#include <cstddef>
+#include <cstdlib>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rttl {
+
+/**
+ * Hook of `rttl::intrusive_list`.
+ */
+class intrusive_list_hook {
+public:
+    intrusive_list_hook() noexcept = default;
+
+    /// Copies are not linked
+    intrusive_list_hook(const intrusive_list_hook&) noexcept {}
+
+    /// Links are not assigned
+    intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept {
+        return *this;
+    }
+
+    ~intrusive_list_hook() {
+        unlink();
+    }
+
+    bool is_linked() const noexcept {
+        return m_next != nullptr;
+    }
+
+    /**
+     * Removes the element from its list, if any.
+     */
+    void unlink() noexcept {
+        if (m_next != nullptr) {
+            m_prev->m_next = m_next;
+            m_next->m_prev = m_prev;
+            m_prev = nullptr;
+            m_next = nullptr;
+        }
+    }
+
+private:
+    template <typename T, intrusive_list_hook T::*Hook>
+    friend class intrusive_list;
+
+    /// Links `this` before `pos`
+    void link_before(intrusive_list_hook* pos) noexcept {
+        m_next = pos;
+        m_prev = pos->m_prev;
+        m_prev->m_next = this;
+        pos->m_prev = this;
+    }
+
+    intrusive_list_hook* m_prev = nullptr;
+    intrusive_list_hook* m_next = nullptr;
+
+};
+
+/**
+ * Hook of `rttl::intrusive_hash_set`.
+ */
+class intrusive_hash_hook {
+public:
+    intrusive_hash_hook() noexcept = default;
+
+    /// Copies are not linked
+    intrusive_hash_hook(const intrusive_hash_hook&) noexcept {}
+
+    /// Links are not assigned
+    intrusive_hash_hook& operator=(const intrusive_hash_hook&) noexcept {
+        return *this;
+    }
+
+    ~intrusive_hash_hook() {
+        unlink();
+    }
+
+    bool is_linked() const noexcept {
+        return m_pprev != nullptr;
+    }
+
+    /**
+     * Removes the element from its set, if any.
+     */
+    void unlink() noexcept {
+        if (m_pprev != nullptr) {
+            *m_pprev = m_next;
+            if (m_next != nullptr) {
+                m_next->m_pprev = m_pprev;
+            }
+            m_next = nullptr;
+            m_pprev = nullptr;
+        }
+    }
+
+private:
+    template <typename T, intrusive_hash_hook T::*Hook, std::size_t BucketCount,
+              typename KeyOf, typename Hash, typename KeyEqual>
+    friend class intrusive_hash_set;
+
+    /// Links `this` at the head of a chain
+    void link_front(intrusive_hash_hook** head) noexcept {
+        m_next = *head;
+        m_pprev = head;
+        if (m_next != nullptr) {
+            m_next->m_pprev = &m_next;
+        }
+        *head = this;
+    }
+
+    intrusive_hash_hook* m_next = nullptr;
+    /// Link pointing at this hook: a bucket or `m_next` of the previous hook
+    intrusive_hash_hook** m_pprev = nullptr;
+
+};
+
+/**
+ * Conversions between elements of type `T` and their hooks `Member`.
+ */
+template <typename T, typename Hook, Hook T::*Member>
+struct intrusive_member {
+    static_assert((std::is_standard_layout<T>::value),
+                  "Element type of intrusive containers must be standard-layout");
+
+    static Hook& hook(T& object) noexcept {
+        return object.*Member;
+    }
+
+    static T& owner(Hook& hook) noexcept {
+        return *reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(&hook) - offset());
+    }
+
+    static const T& owner(const Hook& hook) noexcept {
+        return owner(const_cast<Hook&>(hook));
+    }
+
+private:
+    /// Storage of an element that is never constructed
+    union storage {
+        storage() noexcept {}
+        ~storage() {}
+        T object;
+    };
+
+    /**
+     * Offset of the hook in an element, as `offsetof` would give for a member
+     * name: only addresses of members of unconstructed storage are taken,
+     * which a standard-layout `T` shares with the union. Folded into a
+     * constant by compilers.
+     */
+    static std::ptrdiff_t offset() noexcept {
+        storage s;
+        return reinterpret_cast<unsigned char*>(&(s.object.*Member)) -
+               reinterpret_cast<unsigned char*>(&s);
+    }
+};
+
+template <typename T, intrusive_list_hook T::*Hook>
+class intrusive_list {
+    using member = intrusive_member<T, intrusive_list_hook, Hook>;
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() noexcept = default;
+
+        /// Conversion of iterators to const iterators
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept : m_node(other.m_node) {}
+
+        reference operator*() const noexcept {
+            return member::owner(*m_node);
+        }
+
+        pointer operator->() const noexcept {
+            return &member::owner(*m_node);
+        }
+
+        basic_iterator& operator++() noexcept {
+            m_node = m_node->m_next;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        basic_iterator& operator--() noexcept {
+            m_node = m_node->m_prev;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            basic_iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.m_node == rhs.m_node;
+        }
+
+        friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.m_node != rhs.m_node;
+        }
+
+    private:
+        friend class intrusive_list;
+        friend class basic_iterator<true>;
+
+        explicit basic_iterator(intrusive_list_hook* node) noexcept : m_node(node) {}
+
+        intrusive_list_hook* m_node = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// @section Member functions
+
+    intrusive_list() noexcept {
+        m_root.m_prev = &m_root;
+        m_root.m_next = &m_root;
+    }
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    ~intrusive_list() {
+        clear();
+        m_root.m_prev = nullptr;
+        m_root.m_next = nullptr;
+    }
+
+    /// @subsection Element access
+
+    reference front() noexcept {
+        return member::owner(*m_root.m_next);
+    }
+
+    const_reference front() const noexcept {
+        return member::owner(*m_root.m_next);
+    }
+
+    reference back() noexcept {
+        return member::owner(*m_root.m_prev);
+    }
+
+    const_reference back() const noexcept {
+        return member::owner(*m_root.m_prev);
+    }
+
+    /// @subsection Iterators
+
+    iterator begin() noexcept {
+        return iterator(m_root.m_next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(m_root.m_next);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(&m_root);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<intrusive_list_hook*>(&m_root));
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * Iterator to `value`, which must be in this list.
+     */
+    iterator iterator_to(reference value) noexcept {
+        return iterator(&member::hook(value));
+    }
+
+    /// @subsection Capacity
+
+    bool empty() const noexcept {
+        return m_root.m_next == &m_root;
+    }
+
+    /**
+     * Number of elements, counted in linear time.
+     */
+    size_type size() const noexcept {
+        return static_cast<size_type>(std::distance(begin(), end()));
+    }
+
+    /// @subsection Modifiers
+
+    void push_front(reference value) {
+        insert(begin(), value);
+    }
+
+    void push_back(reference value) {
+        insert(end(), value);
+    }
+
+    /**
+     * Links `value` before `pos`; throws `std::invalid_argument` if `value` is
+     * already linked.
+     */
+    iterator insert(const_iterator pos, reference value) {
+        intrusive_list_hook& hook = member::hook(value);
+        if (hook.is_linked()) {
+            throw std::invalid_argument("rttl::intrusive_list");
+        }
+        hook.link_before(pos.m_node);
+        return iterator(&hook);
+    }
+
+    void pop_front() noexcept {
+        m_root.m_next->unlink();
+    }
+
+    void pop_back() noexcept {
+        m_root.m_prev->unlink();
+    }
+
+    /**
+     * Unlinks the element at `pos`; returns the iterator following it.
+     */
+    iterator erase(const_iterator pos) noexcept {
+        iterator next(pos.m_node->m_next);
+        pos.m_node->unlink();
+        return next;
+    }
+
+    /**
+     * Unlinks all elements.
+     */
+    void clear() noexcept {
+        while (!empty()) {
+            m_root.m_next->unlink();
+        }
+    }
+
+    /**
+     * Moves `value`, which must be in this list, before `pos`.
+     */
+    void move(const_iterator pos, reference value) noexcept {
+        intrusive_list_hook& hook = member::hook(value);
+        if (&hook != pos.m_node) {
+            hook.unlink();
+            hook.link_before(pos.m_node);
+        }
+    }
+
+    /**
+     * Moves all elements of `other` before `pos`.
+     */
+    void splice(const_iterator pos, intrusive_list& other) noexcept {
+        if (&other == this || other.empty()) {
+            return;
+        }
+        intrusive_list_hook* first = other.m_root.m_next;
+        intrusive_list_hook* last = other.m_root.m_prev;
+        other.m_root.m_next = &other.m_root;
+        other.m_root.m_prev = &other.m_root;
+        first->m_prev = pos.m_node->m_prev;
+        first->m_prev->m_next = first;
+        last->m_next = pos.m_node;
+        pos.m_node->m_prev = last;
+    }
+
+private:
+    /// Sentinel linking the back to the front
+    intrusive_list_hook m_root;
+
+};
+
+namespace detail {
+
+struct intrusive_identity {
+    template <typename T>
+    const T& operator()(const T& value) const noexcept {
+        return value;
+    }
+};
+
+}
+
+template <typename T, intrusive_hash_hook T::*Hook, std::size_t BucketCount,
+          typename KeyOf = detail::intrusive_identity,
+          typename Hash = std::hash<std::decay_t<std::invoke_result_t<KeyOf, const T&>>>,
+          typename KeyEqual = std::equal_to<>>
+class intrusive_hash_set {
+    static_assert(BucketCount > 0, "BucketCount must be positive");
+    using member = intrusive_member<T, intrusive_hash_hook, Hook>;
+public:
+
+    /// @section Member types
+
+    using key_type = std::decay_t<std::invoke_result_t<KeyOf, const T&>>;
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() noexcept = default;
+
+        /// Conversion of iterators to const iterators
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept
+            : m_owner(other.m_owner), m_bucket(other.m_bucket), m_node(other.m_node) {}
+
+        reference operator*() const noexcept {
+            return member::owner(*m_node);
+        }
+
+        pointer operator->() const noexcept {
+            return &member::owner(*m_node);
+        }
+
+        basic_iterator& operator++() noexcept {
+            m_node = m_node->m_next;
+            if (m_node == nullptr) {
+                ++m_bucket;
+                start();
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.m_node == rhs.m_node;
+        }
+
+        friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept {
+            return lhs.m_node != rhs.m_node;
+        }
+
+    private:
+        friend class intrusive_hash_set;
+        friend class basic_iterator<true>;
+
+        basic_iterator(const intrusive_hash_set* owner, size_type bucket,
+                       intrusive_hash_hook* node) noexcept
+            : m_owner(owner), m_bucket(bucket), m_node(node) {}
+
+        /// Moves to the first element from `m_bucket` on, or to the end
+        void start() noexcept {
+            for (; m_bucket < BucketCount; ++m_bucket) {
+                if (m_owner->m_buckets[m_bucket] != nullptr) {
+                    m_node = m_owner->m_buckets[m_bucket];
+                    return;
+                }
+            }
+            m_node = nullptr;
+        }
+
+        const intrusive_hash_set* m_owner = nullptr;
+        size_type m_bucket = 0;
+        intrusive_hash_hook* m_node = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static constexpr size_type bucket_count = BucketCount;
+
+    /// @section Member functions
+
+    intrusive_hash_set() noexcept = default;
+    intrusive_hash_set(const intrusive_hash_set&) = delete;
+    intrusive_hash_set& operator=(const intrusive_hash_set&) = delete;
+
+    ~intrusive_hash_set() {
+        clear();
+    }
+
+    /// @subsection Iterators
+
+    iterator begin() noexcept {
+        iterator it(this, 0, nullptr);
+        it.start();
+        return it;
+    }
+
+    const_iterator begin() const noexcept {
+        const_iterator it(this, 0, nullptr);
+        it.start();
+        return it;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this, BucketCount, nullptr);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, BucketCount, nullptr);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /// @subsection Capacity
+
+    /**
+     * @name empty, size
+     *
+     * Scan all buckets, in time linear in `BucketCount` and the size.
+     */
+    ///{
+    bool empty() const noexcept {
+        return begin() == end();
+    }
+
+    size_type size() const noexcept {
+        return static_cast<size_type>(std::distance(begin(), end()));
+    }
+    ///}
+
+    /// @subsection Modifiers
+
+    /**
+     * Links `value` unless an element of an equal key is linked; returns an
+     * iterator to the element of the key and whether `value` was linked.
+     * Throws `std::invalid_argument` if `value` is already linked.
+     */
+    std::pair<iterator, bool> insert(reference value) {
+        intrusive_hash_hook& hook = member::hook(value);
+        if (hook.is_linked()) {
+            throw std::invalid_argument("rttl::intrusive_hash_set");
+        }
+        const auto& key = KeyOf()(value);
+        size_type bucket = bucket_of(key);
+        intrusive_hash_hook* node = find_in(bucket, key);
+        if (node != nullptr) {
+            return { iterator(this, bucket, node), false };
+        }
+        hook.link_front(&m_buckets[bucket]);
+        return { iterator(this, bucket, &hook), true };
+    }
+
+    /**
+     * Unlinks the element at `pos`; returns the iterator following it.
+     */
+    iterator erase(const_iterator pos) noexcept {
+        iterator next(this, pos.m_bucket, pos.m_node);
+        ++next;
+        pos.m_node->unlink();
+        return next;
+    }
+
+    /**
+     * Unlinks the element of `key`, if any; returns the number of elements
+     * unlinked.
+     */
+    template <typename Key>
+    std::enable_if_t<!std::is_convertible<const Key&, const_iterator>::value, size_type>
+    erase(const Key& key) noexcept {
+        intrusive_hash_hook* node = find_in(bucket_of(key), key);
+        if (node == nullptr) {
+            return 0;
+        }
+        node->unlink();
+        return 1;
+    }
+
+    /**
+     * Unlinks all elements.
+     */
+    void clear() noexcept {
+        for (intrusive_hash_hook*& head : m_buckets) {
+            while (head != nullptr) {
+                head->unlink();
+            }
+        }
+    }
+
+    /// @subsection Lookup
+
+    /**
+     * @name find
+     *
+     * Element of a key equal to `key` by `KeyEqual`, hashed by `Hash`, so
+     * transparent functors find elements by keys of other types.
+     */
+    ///{
+    template <typename Key>
+    iterator find(const Key& key) noexcept {
+        size_type bucket = bucket_of(key);
+        intrusive_hash_hook* node = find_in(bucket, key);
+        return (node != nullptr) ? iterator(this, bucket, node) : end();
+    }
+
+    template <typename Key>
+    const_iterator find(const Key& key) const noexcept {
+        size_type bucket = bucket_of(key);
+        intrusive_hash_hook* node = find_in(bucket, key);
+        return (node != nullptr) ? const_iterator(this, bucket, node) : end();
+    }
+    ///}
+
+    template <typename Key>
+    bool contains(const Key& key) const noexcept {
+        return find_in(bucket_of(key), key) != nullptr;
+    }
+
+    template <typename Key>
+    size_type count(const Key& key) const noexcept {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * Iterator to `value`, which must be in this set.
+     */
+    iterator iterator_to(reference value) noexcept {
+        return iterator(this, bucket_of(KeyOf()(value)), &member::hook(value));
+    }
+
+private:
+    template <typename Key>
+    static size_type bucket_of(const Key& key) noexcept {
+        return Hash()(key) % BucketCount;
+    }
+
+    template <typename Key>
+    intrusive_hash_hook* find_in(size_type bucket, const Key& key) const noexcept {
+        for (intrusive_hash_hook* node = m_buckets[bucket]; node != nullptr;
+             node = node->m_next) {
+            if (KeyEqual()(KeyOf()(member::owner(*node)), key)) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Heads of chains of hooks
+    std::array<intrusive_hash_hook*, BucketCount> m_buckets = {};
+
+};
+
+}
+
+#endif // RTTL_INTRUSIVE_H_
@@ -0,0 +1,527 @@
+/**
+ * @file rttl/journal.h
+ *
+ * Append-only journal of records with group commit, and its recovery reader.
+ *
+ * `rttl::journal_writer<BufferSize>` makes records durable in batches:
+ *  - `append` copies a record into one of two staging buffers of `BufferSize`
+ *    bytes stored within the class and returns its sequence number; it does
+ *    not wait for I/O unless the active buffer is full;
+ *  - a background thread swaps the buffers once the active one holds at least
+ *    `commit_bytes` bytes or its first record has waited `commit_interval`,
+ *    writes the batch with a single `pwritev` and makes it durable with a
+ *    single `fdatasync`, while appends continue into the other buffer;
+ *  - `wait(seq)` blocks until the record with sequence number `seq` and all
+ *    records before it are durable, `flush` commits everything appended so
+ *    far without waiting for the window;
+ *  - an I/O error stops the commit thread: it is reported by
+ *    `std::system_error` from all following appends, and from `wait` and
+ *    `flush` for every record not made durable before the error, i.e. those
+ *    of the failed batch and all later ones.
+ *
+ * Every record is stored as its length and CRC-32C of the length and the
+ * payload, both 32-bit little-endian, followed by the payload.
+ * `rttl::journal_reader` reads records back in order and stops at the first
+ * record that is truncated or fails the check, i.e. at the tail torn by a
+ * crash; the writer opening an existing journal truncates such a tail and
+ * continues sequence numbers from the number of records kept.
+ *
+ * Requires POSIX.
+ *
+ */
+#ifndef RTTL_JOURNAL_H_
+#define RTTL_JOURNAL_H_
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "rttl/bit.h"
+#include "rttl/string.h"
+
+namespace rttl {
+
+namespace detail {
+
+constexpr std::array<std::uint32_t, 256> make_crc32c_table() noexcept {
+    std::array<std::uint32_t, 256> table = {};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<std::uint32_t, 256> crc32c_table = make_crc32c_table();
+
+/**
+ * CRC-32C (Castagnoli) of `size` bytes continuing from `crc`, which is `0`
+ * for the first chunk.
+ */
+inline std::uint32_t crc32c(std::uint32_t crc, const void* data,
+                            std::size_t size) noexcept {
+    auto p = static_cast<const std::uint8_t*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = crc32c_table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+[[noreturn]] inline void throw_journal_error(int error, const char* what) {
+    throw std::system_error(error, std::generic_category(), what);
+}
+
+}
+
+/// Size of the length and the CRC preceding every record
+constexpr std::size_t journal_header_size = 8;
+
+/**
+ * Reads records of a journal in order.
+ */
+class journal_reader {
+public:
+    using sequence_type = std::uint64_t;
+
+    explicit journal_reader(const char* path) {
+        m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0) {
+            detail::throw_journal_error(errno, "rttl::journal_reader");
+        }
+    }
+
+    journal_reader(const journal_reader&) = delete;
+    journal_reader& operator=(const journal_reader&) = delete;
+
+    ~journal_reader() {
+        ::close(m_fd);
+    }
+
+    /**
+     * @name next
+     *
+     * Reads the next record into `data`, returning `false` at the end of the
+     * journal or at a record that is truncated or corrupt; throws
+     * `std::length_error` if the record is valid but longer than `capacity`,
+     * leaving it to be read again or skipped.
+     */
+    ///{
+    bool next(void* data, std::size_t capacity, std::size_t& size) {
+        return advance(data, capacity, size);
+    }
+
+    template <std::size_t MaxLength>
+    bool next(string<MaxLength>& record) {
+        std::size_t size = 0;
+        record.resize(MaxLength);
+        bool result = advance(record.data(), MaxLength, size);
+        record.resize(result ? size : 0);
+        return result;
+    }
+    ///}
+
+    /**
+     * Skips the next record, verifying it as `next` does.
+     */
+    bool skip() {
+        std::size_t size = 0;
+        return advance(nullptr, 0, size);
+    }
+
+    /**
+     * Offset of the end of the last record read, i.e. the size of the valid
+     * part of the journal once `next` has returned `false`.
+     */
+    std::uint64_t offset() const noexcept {
+        return m_offset;
+    }
+
+    /**
+     * Number of records read, i.e. the sequence number of the last one.
+     */
+    sequence_type count() const noexcept {
+        return m_count;
+    }
+
+private:
+    /// Reads `size` bytes at `offset`, `false` if the file ends before
+    bool read_at(void* data, std::size_t size, std::uint64_t offset) {
+        auto p = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t n = ::pread(m_fd, p, size, static_cast<off_t>(offset));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                detail::throw_journal_error(errno, "rttl::journal_reader");
+            }
+            if (n == 0) {
+                return false;
+            }
+            p += n;
+            size -= static_cast<std::size_t>(n);
+            offset += static_cast<std::uint64_t>(n);
+        }
+        return true;
+    }
+
+    /// Size of the journal, refreshed once it seems to end before `end`
+    bool within_file(std::uint64_t end) {
+        if (end > m_file_size) {
+            struct stat st;
+            if (::fstat(m_fd, &st) != 0) {
+                detail::throw_journal_error(errno, "rttl::journal_reader");
+            }
+            m_file_size = static_cast<std::uint64_t>(st.st_size);
+        }
+        return end <= m_file_size;
+    }
+
+    /// Reads and verifies a record, discarding the payload if `data` is null
+    bool advance(void* data, std::size_t capacity, std::size_t& size) {
+        std::array<std::uint8_t, journal_header_size> header;
+        if (!read_at(header.data(), header.size(), m_offset)) {
+            return false;
+        }
+        auto length = detail::load_le<std::uint32_t>(header.data());
+        auto crc = detail::load_le<std::uint32_t>(header.data() + 4);
+        std::uint32_t actual = detail::crc32c(0, header.data(), 4);
+        std::uint64_t pos = m_offset + journal_header_size;
+        /// A torn or corrupt length may point past the end of the file
+        if (!within_file(pos + length)) {
+            return false;
+        }
+        if (data != nullptr && length <= capacity) {
+            if (!read_at(data, length, pos)) {
+                return false;
+            }
+            actual = detail::crc32c(actual, data, length);
+        } else {
+            std::array<char, 4096> chunk;
+            for (std::size_t left = length; left > 0;) {
+                std::size_t n = std::min(left, chunk.size());
+                if (!read_at(chunk.data(), n, pos + length - left)) {
+                    return false;
+                }
+                actual = detail::crc32c(actual, chunk.data(), n);
+                left -= n;
+            }
+        }
+        if (actual != crc) {
+            return false;
+        }
+        /// Only a valid record is too long, and it is not consumed
+        if (data != nullptr && length > capacity) {
+            throw std::length_error("rttl::journal_reader");
+        }
+        size = length;
+        m_offset = pos + length;
+        ++m_count;
+        return true;
+    }
+
+    int m_fd;
+    std::uint64_t m_file_size = 0;
+    std::uint64_t m_offset = 0;
+    sequence_type m_count = 0;
+
+};
+
+/**
+ * Group commit settings of `rttl::journal_writer`.
+ */
+struct journal_options {
+    /// Bytes staged that trigger a commit; capped at the buffer size
+    std::size_t commit_bytes = 64 * 1024;
+    /// Longest time a record waits for its commit to start
+    std::chrono::microseconds commit_interval{1000};
+};
+
+template <std::size_t BufferSize>
+class journal_writer {
+    static_assert(BufferSize > journal_header_size,
+                  "Buffer must hold at least one record");
+public:
+
+    /// @section Member types
+
+    using sequence_type = std::uint64_t;
+    using clock = std::chrono::steady_clock;
+
+    /// @section Member functions
+
+    /**
+     * Opens or creates the journal at `path`, truncating a torn tail, and
+     * starts the commit thread; throws `std::system_error` on failure.
+     */
+    explicit journal_writer(const char* path,
+                            const journal_options& options = {})
+        : m_options(options) {
+        m_options.commit_bytes = std::clamp<std::size_t>(
+            m_options.commit_bytes, 1, BufferSize);
+        open(path);
+        try {
+            m_thread = std::thread([this]() { run(); });
+        } catch (...) {
+            ::close(m_fd);
+            throw;
+        }
+    }
+
+    journal_writer(const journal_writer&) = delete;
+    journal_writer& operator=(const journal_writer&) = delete;
+
+    /**
+     * Commits records appended so far and closes the journal.
+     */
+    ~journal_writer() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_commit_cv.notify_one();
+        m_thread.join();
+        ::close(m_fd);
+    }
+
+    /**
+     * @name append
+     *
+     * Stages a record and returns its sequence number; waits only while both
+     * buffers are occupied. Throws `std::length_error` if the record with its
+     * header does not fit in a buffer.
+     */
+    ///{
+    sequence_type append(const void* data, std::size_t size) {
+        std::size_t total = journal_header_size + size;
+        if (total > BufferSize) {
+            throw std::length_error("rttl::journal_writer");
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        check_error();
+        while (m_used[m_active] + total > BufferSize) {
+            m_flush_requested = true;
+            m_commit_cv.notify_one();
+            m_durable_cv.wait(lock);
+            check_error();
+        }
+        std::uint8_t* p = m_buffers[m_active].data() + m_used[m_active];
+        detail::store_le(p, static_cast<std::uint32_t>(size));
+        std::uint32_t crc = detail::crc32c(0, p, 4);
+        detail::store_le(p + 4, detail::crc32c(crc, data, size));
+        if (size > 0) {
+            std::memcpy(p + journal_header_size, data, size);
+        }
+        if (m_used[m_active] == 0) {
+            m_first_append = clock::now();
+        }
+        m_used[m_active] += total;
+        sequence_type seq = ++m_appended;
+        if (m_used[m_active] >= m_options.commit_bytes ||
+            m_used[m_active] == total) {
+            /// Wake up for the size threshold or to start the time window
+            m_commit_cv.notify_one();
+        }
+        return seq;
+    }
+
+    sequence_type append(std::string_view record) {
+        return append(record.data(), record.size());
+    }
+    ///}
+
+    /**
+     * Blocks until records up to `seq` are durable.
+     */
+    void wait(sequence_type seq) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_durable_cv.wait(lock, [this, seq]() {
+            return m_durable >= seq || m_error != 0;
+        });
+        if (m_durable < seq) {
+            check_error();
+        }
+    }
+
+    /**
+     * Commits records appended so far without waiting for the window and
+     * blocks until they are durable; returns the last sequence number.
+     */
+    sequence_type flush() {
+        sequence_type seq;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            seq = m_appended;
+            m_flush_requested = true;
+        }
+        m_commit_cv.notify_one();
+        wait(seq);
+        return seq;
+    }
+
+    /**
+     * Sequence number of the last durable record.
+     */
+    sequence_type durable() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_durable;
+    }
+
+    /**
+     * Sequence number of the last appended record.
+     */
+    sequence_type appended() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_appended;
+    }
+
+private:
+    /// Opens the journal and truncates it after the last valid record
+    void open(const char* path) {
+        m_fd = ::open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd < 0) {
+            detail::throw_journal_error(errno, "rttl::journal_writer");
+        }
+        try {
+            journal_reader reader(path);
+            while (reader.skip()) {}
+            m_offset = reader.offset();
+            m_appended = reader.count();
+            m_durable = reader.count();
+        } catch (...) {
+            ::close(m_fd);
+            throw;
+        }
+        if (::ftruncate(m_fd, static_cast<off_t>(m_offset)) != 0) {
+            int error = errno;
+            ::close(m_fd);
+            detail::throw_journal_error(error, "rttl::journal_writer");
+        }
+    }
+
+    void check_error() const {
+        if (m_error != 0) {
+            detail::throw_journal_error(m_error, "rttl::journal_writer");
+        }
+    }
+
+    /// Whether the active buffer is due for a commit
+    bool due() const noexcept {
+        return m_used[m_active] > 0 &&
+               (m_stop || m_flush_requested ||
+                m_used[m_active] >= m_options.commit_bytes ||
+                clock::now() >= m_first_append + m_options.commit_interval);
+    }
+
+    /// Commit thread
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            while (m_error == 0 && !due()) {
+                if (m_stop && m_used[m_active] == 0) {
+                    return;
+                }
+                if (m_used[m_active] == 0) {
+                    m_flush_requested = false;
+                    m_commit_cv.wait(lock);
+                } else {
+                    m_commit_cv.wait_until(
+                        lock, m_first_append + m_options.commit_interval);
+                }
+            }
+            if (m_error != 0) {
+                /// The next batch would be written over the failed one and
+                /// report records of both durable, so nothing is committed
+                /// any more and records staged meanwhile are dropped
+                m_used[m_active] = 0;
+                m_durable_cv.notify_all();
+                if (m_stop) {
+                    return;
+                }
+                m_commit_cv.wait(lock);
+                continue;
+            }
+            std::size_t batch = m_active;
+            std::size_t size = m_used[batch];
+            sequence_type seq = m_appended;
+            m_active ^= 1;
+            m_flush_requested = false;
+            /// Appends waiting for space may continue into the other buffer
+            m_durable_cv.notify_all();
+            lock.unlock();
+            int error = write(m_buffers[batch].data(), size);
+            lock.lock();
+            m_used[batch] = 0;
+            if (error == 0) {
+                m_offset += size;
+                m_durable = seq;
+            } else if (m_error == 0) {
+                m_error = error;
+            }
+            m_durable_cv.notify_all();
+        }
+    }
+
+    /// Writes a batch at the end of the journal and syncs it, returns `errno`
+    int write(const std::uint8_t* data, std::size_t size) noexcept {
+        std::uint64_t offset = m_offset;
+        while (size > 0) {
+            iovec iov = { const_cast<std::uint8_t*>(data), size };
+            ssize_t n = ::pwritev(m_fd, &iov, 1, static_cast<off_t>(offset));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            data += n;
+            size -= static_cast<std::size_t>(n);
+            offset += static_cast<std::uint64_t>(n);
+        }
+#if defined(__APPLE__)
+        return (::fsync(m_fd) == 0) ? 0 : errno;
+#else
+        return (::fdatasync(m_fd) == 0) ? 0 : errno;
+#endif
+    }
+
+    std::array<std::array<std::uint8_t, BufferSize>, 2> m_buffers;
+    std::array<std::size_t, 2> m_used = {};
+    /// Buffer that appends go to, the other one may be being written
+    std::size_t m_active = 0;
+    clock::time_point m_first_append;
+    journal_options m_options;
+    int m_fd = -1;
+    /// End of durable records, accessed by the commit thread only
+    std::uint64_t m_offset = 0;
+    sequence_type m_appended = 0;
+    sequence_type m_durable = 0;
+    int m_error = 0;
+    bool m_flush_requested = false;
+    bool m_stop = false;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_commit_cv;
+    std::condition_variable m_durable_cv;
+    std::thread m_thread;
+
+};
+
+}
+
+#endif // RTTL_JOURNAL_H_
@@ -0,0 +1,246 @@
+/**
+ * @file rttl/memory.h
+ *
+ * Prefaulting and locking of memory of statically allocated containers.
+ *
+ * Containers of rttl keep their elements within the object, so a large
+ * `rttl::vector` or `rttl::string` placed in static storage is backed by
+ * pages that are mapped on the first touch, which may happen at the worst
+ * moment. Functions of `rttl::memory` move this cost to the startup:
+ *  - `prefault` writes to every page of a container or memory region, so
+ *    that all of them are mapped; regions of at least `huge_page_size` bytes
+ *    are advised to be backed by transparent huge pages before that, where
+ *    `MADV_HUGEPAGE` is supported;
+ *  - `lock` keeps pages in RAM with `mlock`; it fails without throwing when
+ *    the process is not permitted to lock that much memory;
+ *  - containers may be registered once, e.g. next to their definitions, and
+ *    prefaulted all together with `prefault_registered` when the program is
+ *    ready to do so; the registry holds up to `max_registered` regions and
+ *    does not allocate;
+ *  - registration and prefaulting are not thread-safe, they are meant for
+ *    program startup.
+ *
+ * Prefaulting writes the values the pages already contain, so it does not
+ * change the contents of containers, but must not race with their use.
+ *
+ */
+#ifndef RTTL_MEMORY_H_
+#define RTTL_MEMORY_H_
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define RTTL_HAS_MMAN 1
+#else
+#define RTTL_HAS_MMAN 0
+#endif
+
+namespace rttl {
+
+namespace memory {
+
+/// Size of a huge page assumed for advising
+constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+/// Maximal number of registered regions
+constexpr std::size_t max_registered = 256;
+
+/**
+ * Outcome of prefaulting or locking.
+ */
+struct report {
+    /// Number of pages written to
+    std::size_t pages_touched = 0;
+    /// Number of bytes advised to be backed by huge pages
+    std::size_t huge_page_bytes = 0;
+    /// Number of bytes locked in RAM
+    std::size_t locked_bytes = 0;
+
+    report& operator+=(const report& other) noexcept {
+        pages_touched += other.pages_touched;
+        huge_page_bytes += other.huge_page_bytes;
+        locked_bytes += other.locked_bytes;
+        return *this;
+    }
+};
+
+inline std::size_t page_size() noexcept {
+#if RTTL_HAS_MMAN
+    static const std::size_t result =
+        static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return result;
+#else
+    return 4096;
+#endif
+}
+
+namespace detail {
+
+struct region {
+    void* data;
+    std::size_t size;
+};
+
+inline std::uintptr_t align_down(std::uintptr_t p, std::size_t alignment) noexcept {
+    return p & ~(alignment - 1);
+}
+
+inline std::uintptr_t align_up(std::uintptr_t p, std::size_t alignment) noexcept {
+    return align_down(p + alignment - 1, alignment);
+}
+
+struct registry {
+    std::array<region, max_registered> regions;
+    std::size_t count = 0;
+};
+
+inline registry& global_registry() noexcept {
+    static registry instance;
+    return instance;
+}
+
+}
+
+/**
+ * Advises huge pages for the whole pages of the region, if it is large
+ * enough; returns the number of bytes advised.
+ */
+inline std::size_t advise_huge_pages(void* data, std::size_t size) noexcept {
+#if RTTL_HAS_MMAN && defined(MADV_HUGEPAGE)
+    if (size < huge_page_size) {
+        return 0;
+    }
+    auto first = detail::align_up(reinterpret_cast<std::uintptr_t>(data),
+                                  page_size());
+    auto last = detail::align_down(reinterpret_cast<std::uintptr_t>(data) +
+                                   size, page_size());
+    if (last <= first ||
+        madvise(reinterpret_cast<void*>(first), last - first,
+                MADV_HUGEPAGE) != 0) {
+        return 0;
+    }
+    return last - first;
+#else
+    (void)data;
+    (void)size;
+    return 0;
+#endif
+}
+
+/**
+ * @name prefault
+ *
+ * Maps every page of a memory region or a container by writing to it.
+ */
+///{
+inline report prefault(void* data, std::size_t size) noexcept {
+    report result;
+    if (size == 0) {
+        return result;
+    }
+    result.huge_page_bytes = advise_huge_pages(data, size);
+    auto p = reinterpret_cast<std::uintptr_t>(data);
+    auto first = detail::align_down(p, page_size());
+    auto last = p + size;
+    for (auto page = first; page < last; page += page_size()) {
+        /// The first byte of the page, unless it precedes the region
+        volatile char* c = reinterpret_cast<volatile char*>(page < p ? p : page);
+        *c = *c;
+        ++result.pages_touched;
+    }
+    return result;
+}
+
+template <typename Container>
+report prefault(Container& c) noexcept {
+    return prefault(&c, sizeof(c));
+}
+///}
+
+/**
+ * @name lock
+ *
+ * Locks pages of a memory region or a container in RAM; returns `false` if
+ * not permitted or not supported.
+ */
+///{
+inline bool lock(const void* data, std::size_t size) noexcept {
+#if RTTL_HAS_MMAN
+    return mlock(data, size) == 0;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+template <typename Container>
+bool lock(const Container& c) noexcept {
+    return lock(&c, sizeof(c));
+}
+///}
+
+/**
+ * @name register_region
+ *
+ * Registers a memory region or a container for `prefault_registered`;
+ * throws if `max_registered` regions are already registered.
+ */
+///{
+inline void register_region(void* data, std::size_t size) {
+    auto& r = detail::global_registry();
+    if (r.count == max_registered) {
+        throw std::length_error("rttl::memory::register_region");
+    }
+    r.regions[r.count++] = { data, size };
+}
+
+template <typename Container>
+void register_container(Container& c) {
+    register_region(&c, sizeof(c));
+}
+///}
+
+/**
+ * Removes all registrations of a memory region.
+ */
+inline void unregister_region(const void* data) noexcept {
+    auto& r = detail::global_registry();
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < r.count; ++i) {
+        if (r.regions[i].data != data) {
+            r.regions[n++] = r.regions[i];
+        }
+    }
+    r.count = n;
+}
+
+inline std::size_t registered_count() noexcept {
+    return detail::global_registry().count;
+}
+
+/**
+ * Prefaults all registered regions and, if `lock_pages` is set, locks them;
+ * returns the summary of all regions.
+ */
+inline report prefault_registered(bool lock_pages = false) noexcept {
+    report result;
+    auto& r = detail::global_registry();
+    for (std::size_t i = 0; i < r.count; ++i) {
+        result += prefault(r.regions[i].data, r.regions[i].size);
+        if (lock_pages && lock(r.regions[i].data, r.regions[i].size)) {
+            result.locked_bytes += r.regions[i].size;
+        }
+    }
+    return result;
+}
+
+}
+
+}
+
+#endif // RTTL_MEMORY_H_
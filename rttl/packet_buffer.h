@@ -0,0 +1,352 @@
+/**
+ * @file rttl/packet_buffer.h
+ *
+ * Byte buffer with statically allocated storage and reserved headroom, for
+ * framing protocol messages without copying.
+ *
+ * Data of `rttl::packet_buffer<Headroom, Capacity>` is a contiguous region of
+ * `Headroom + Capacity` bytes stored within the class; the region is empty
+ * and starts at offset `Headroom` initially, so that:
+ *  - headers of outer protocol layers are prepended in `O(header size)`,
+ *    without shifting the payload, while there is headroom left;
+ *  - payload and trailers are appended while there is tailroom left;
+ *  - `trim_front` and `trim_back` strip headers and trailers in `O(1)`;
+ *  - operations that would exceed headroom, tailroom or data size throw and
+ *    leave the buffer intact;
+ *  - typed cursors, `writer` and `reader`, put and get integers in big-endian
+ *    (network) or little-endian byte order; bounds are checked once, when a
+ *    cursor is obtained for a range of bytes, and accesses beyond the range
+ *    only by `assert`, i.e. in debug builds; cursors of ranges of unknown
+ *    size, e.g. of parsed lengths, should check `remaining()` first.
+ *
+ */
+#ifndef RTTL_PACKET_BUFFER_H_
+#define RTTL_PACKET_BUFFER_H_
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include "rttl/bit.h"
+
+namespace rttl {
+
+template <std::size_t Headroom, std::size_t Capacity>
+class packet_buffer {
+public:
+
+    /// @section Member types
+
+    using value_type = std::uint8_t;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = pointer;
+    using const_iterator = const_pointer;
+
+    /**
+     * Cursor writing to a range of bytes checked on construction.
+     */
+    class writer {
+    public:
+        writer(pointer first, size_type count) noexcept
+            : m_pos(first), m_end(first + count) {}
+
+        size_type remaining() const noexcept {
+            return static_cast<size_type>(m_end - m_pos);
+        }
+
+        template <typename T>
+        writer& put_be(T value) noexcept {
+            assert(sizeof(T) <= remaining());
+            detail::store_be(m_pos, value);
+            m_pos += sizeof(T);
+            return *this;
+        }
+
+        template <typename T>
+        writer& put_le(T value) noexcept {
+            assert(sizeof(T) <= remaining());
+            detail::store_le(m_pos, value);
+            m_pos += sizeof(T);
+            return *this;
+        }
+
+        writer& put(const void* data, size_type count) noexcept {
+            assert(count <= remaining());
+            if (count > 0) {
+                std::memcpy(m_pos, data, count);
+            }
+            m_pos += count;
+            return *this;
+        }
+
+    private:
+        pointer m_pos;
+        pointer m_end;
+    };
+
+    /**
+     * Cursor reading from a range of bytes checked on construction.
+     */
+    class reader {
+    public:
+        reader(const_pointer first, size_type count) noexcept
+            : m_pos(first), m_end(first + count) {}
+
+        size_type remaining() const noexcept {
+            return static_cast<size_type>(m_end - m_pos);
+        }
+
+        template <typename T>
+        T get_be() noexcept {
+            assert(sizeof(T) <= remaining());
+            T result = detail::load_be<T>(m_pos);
+            m_pos += sizeof(T);
+            return result;
+        }
+
+        template <typename T>
+        T get_le() noexcept {
+            assert(sizeof(T) <= remaining());
+            T result = detail::load_le<T>(m_pos);
+            m_pos += sizeof(T);
+            return result;
+        }
+
+        reader& get(void* data, size_type count) noexcept {
+            assert(count <= remaining());
+            if (count > 0) {
+                std::memcpy(data, m_pos, count);
+            }
+            m_pos += count;
+            return *this;
+        }
+
+        reader& skip(size_type count) noexcept {
+            assert(count <= remaining());
+            m_pos += count;
+            return *this;
+        }
+
+    private:
+        const_pointer m_pos;
+        const_pointer m_end;
+    };
+
+    /// @section Member functions
+
+    packet_buffer() noexcept = default;
+
+    /// @subsection Element access
+
+    reference operator[](size_type pos) noexcept {
+        return data()[pos];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return data()[pos];
+    }
+
+    pointer data() noexcept {
+        return m_bytes.data() + m_first;
+    }
+
+    const_pointer data() const noexcept {
+        return m_bytes.data() + m_first;
+    }
+
+    /// @subsection Iterators
+
+    iterator begin() noexcept {
+        return data();
+    }
+
+    const_iterator begin() const noexcept {
+        return data();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return data();
+    }
+
+    iterator end() noexcept {
+        return m_bytes.data() + m_last;
+    }
+
+    const_iterator end() const noexcept {
+        return m_bytes.data() + m_last;
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /// @subsection Capacity
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_first == m_last;
+    }
+
+    size_type size() const noexcept {
+        return m_last - m_first;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return Headroom + Capacity;
+    }
+
+    /**
+     * Number of bytes that may be prepended.
+     */
+    size_type headroom() const noexcept {
+        return m_first;
+    }
+
+    /**
+     * Number of bytes that may be appended.
+     */
+    size_type tailroom() const noexcept {
+        return max_size() - m_last;
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Empties the buffer and restores the initial headroom.
+     */
+    void clear() noexcept {
+        m_first = Headroom;
+        m_last = Headroom;
+    }
+
+    /**
+     * @name prepend
+     *
+     * Extends data at the front by `count` bytes, either left uninitialized
+     * and returned, or copied from `src`; throws if headroom is insufficient.
+     */
+    ///{
+    pointer prepend(size_type count) {
+        if (count > headroom()) {
+            throw std::length_error("rttl::packet_buffer");
+        }
+        m_first -= count;
+        return data();
+    }
+
+    void prepend(const void* src, size_type count) {
+        pointer dest = prepend(count);
+        if (count > 0) {
+            std::memcpy(dest, src, count);
+        }
+    }
+    ///}
+
+    /**
+     * @name append
+     *
+     * Extends data at the back by `count` bytes, either left uninitialized
+     * and returned, or copied from `src`; throws if tailroom is insufficient.
+     */
+    ///{
+    pointer append(size_type count) {
+        if (count > tailroom()) {
+            throw std::length_error("rttl::packet_buffer");
+        }
+        pointer result = end();
+        m_last += count;
+        return result;
+    }
+
+    void append(const void* src, size_type count) {
+        pointer dest = append(count);
+        if (count > 0) {
+            std::memcpy(dest, src, count);
+        }
+    }
+    ///}
+
+    /**
+     * Prepends a header of `count` bytes and returns a cursor to fill it.
+     */
+    writer push_header(size_type count) {
+        return writer(prepend(count), count);
+    }
+
+    /**
+     * Appends `count` bytes and returns a cursor to fill them.
+     */
+    writer push_trailer(size_type count) {
+        return writer(append(count), count);
+    }
+
+    /**
+     * Removes `count` bytes from the front, e.g. a parsed header; throws if
+     * there is less data.
+     */
+    void trim_front(size_type count) {
+        if (count > size()) {
+            throw std::length_error("rttl::packet_buffer");
+        }
+        m_first += count;
+    }
+
+    /**
+     * Removes `count` bytes from the back; throws if there is less data.
+     */
+    void trim_back(size_type count) {
+        if (count > size()) {
+            throw std::length_error("rttl::packet_buffer");
+        }
+        m_last -= count;
+    }
+
+    /// @subsection Cursors
+
+    /**
+     * Cursor to overwrite `count` bytes of data starting at `pos`; throws if
+     * the range exceeds data.
+     */
+    writer write(size_type pos, size_type count) {
+        check_range(pos, count);
+        return writer(data() + pos, count);
+    }
+
+    /**
+     * Cursor to read `count` bytes of data starting at `pos`; throws if the
+     * range exceeds data.
+     */
+    reader read(size_type pos, size_type count) const {
+        check_range(pos, count);
+        return reader(data() + pos, count);
+    }
+
+    /**
+     * Cursor to read all data.
+     */
+    reader read() const noexcept {
+        return reader(data(), size());
+    }
+
+private:
+    void check_range(size_type pos, size_type count) const {
+        if (pos > size() || count > size() - pos) {
+            throw std::out_of_range("rttl::packet_buffer");
+        }
+    }
+
+    std::array<value_type, Headroom + Capacity> m_bytes;
+    size_type m_first = Headroom;
+    size_type m_last = Headroom;
+
+};
+
+}
+
+#endif // RTTL_PACKET_BUFFER_H_
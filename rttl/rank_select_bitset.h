@@ -0,0 +1,282 @@
+/**
+ * @file rttl/rank_select_bitset.h
+ *
+ * Bitset with statically allocated storage, constant time rank queries and
+ * logarithmic time select queries, for succinct indexes.
+ *
+ * `rttl::rank_select_bitset<Bits>` stores `Bits` bits in 64-bit words within
+ * the class, along with a directory that takes about a quarter of the bits:
+ *  - cumulative counts of set bits before every superblock of 512 bits (1/16
+ *    of the bits), and counts before words 1..7 within their superblock,
+ *    packed by 9 bits into one 64-bit word per superblock (1/8 of the bits);
+ *    `rank(pos)` reads one entry of each and counts bits of one word in
+ *    `O(1)`;
+ *  - superblocks containing every 512th set bit (up to 1/16 of the bits),
+ *    which narrow the search of `select(k)` to the superblocks between two
+ *    samples: a few for dense bitsets, found in `O(1)`, but up to all of them
+ *    for sparse ones, found by binary search in `O(log(Bits / 512))`; the bit
+ *    within a word is selected with `pdep` where BMI2 is available, otherwise
+ *    with broadword byte counts;
+ *  - modifications (`set`, `reset`, `flip`, access to words) do not update the
+ *    directory; `rebuild` must be called after a batch of modifications and
+ *    before the next queries.
+ *
+ */
+#ifndef RTTL_RANK_SELECT_BITSET_H_
+#define RTTL_RANK_SELECT_BITSET_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include "rttl/bit.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace rttl {
+
+namespace detail {
+
+/**
+ * Position of the one bit of `x` that has `r` one bits below it; `r` must be
+ * less than `popcount(x)`.
+ */
+inline int select_in_word(std::uint64_t x, int r) noexcept {
+#if defined(__BMI2__)
+    return countr_zero(static_cast<std::uint64_t>(
+        _pdep_u64(std::uint64_t(1) << r, x)));
+#else
+    constexpr std::uint64_t ones = 0x0101010101010101u;
+    /// Counts of bits in bytes, then cumulative counts up to every byte
+    std::uint64_t s = x - ((x >> 1) & 0x5555555555555555u);
+    s = (s & 0x3333333333333333u) + ((s >> 2) & 0x3333333333333333u);
+    s = (s + (s >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+    std::uint64_t sums = s * ones;
+    /// Bytes whose cumulative count does not exceed `r` precede the target
+    std::uint64_t below = ((static_cast<std::uint64_t>(r) * ones |
+                            0x8080808080808080u) - sums) & 0x8080808080808080u;
+    int byte = popcount(below);
+    int shift = byte * 8;
+    if (byte > 0) {
+        r -= static_cast<int>((sums >> (shift - 8)) & 0xFF);
+    }
+    unsigned bits = static_cast<unsigned>(x >> shift) & 0xFF;
+    for (; r > 0; --r) {
+        bits &= bits - 1;
+    }
+    return shift + countr_zero(bits);
+#endif
+}
+
+}
+
+template <std::size_t Bits>
+class rank_select_bitset {
+    static_assert(Bits > 0, "Empty bitsets are not allowed");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    static constexpr size_type word_bits = 64;
+    static constexpr size_type word_count = (Bits + word_bits - 1) / word_bits;
+    /// Number of bits per superblock and per select sample
+    static constexpr size_type superblock_bits = 512;
+
+    /// @section Member functions
+
+    rank_select_bitset() noexcept = default;
+
+    /// @subsection Element access
+
+    bool operator[](size_type pos) const noexcept {
+        return (m_words[pos / word_bits] >> (pos % word_bits)) & 1;
+    }
+
+    bool test(size_type pos) const {
+        check(pos);
+        return (*this)[pos];
+    }
+
+    /**
+     * @name words
+     *
+     * Words of bits, bit `i` being bit `i % 64` of word `i / 64`; bits past
+     * `Bits` in the last word must stay zero.
+     */
+    ///{
+    word_type* words() noexcept {
+        return m_words.data();
+    }
+
+    const word_type* words() const noexcept {
+        return m_words.data();
+    }
+    ///}
+
+    /// @subsection Capacity
+
+    static constexpr size_type size() noexcept {
+        return Bits;
+    }
+
+    /// @subsection Modifiers
+
+    rank_select_bitset& set(size_type pos, bool value = true) {
+        check(pos);
+        word_type mask = word_type(1) << (pos % word_bits);
+        if (value) {
+            m_words[pos / word_bits] |= mask;
+        } else {
+            m_words[pos / word_bits] &= ~mask;
+        }
+        return *this;
+    }
+
+    rank_select_bitset& reset(size_type pos) {
+        return set(pos, false);
+    }
+
+    rank_select_bitset& flip(size_type pos) {
+        check(pos);
+        m_words[pos / word_bits] ^= word_type(1) << (pos % word_bits);
+        return *this;
+    }
+
+    /**
+     * Clears all bits, the directory stays valid.
+     */
+    void reset() noexcept {
+        m_words = {};
+        m_super = {};
+        m_blocks = {};
+        m_sample_count = 0;
+    }
+
+    /**
+     * Recomputes the directory after modifications, in `O(Bits / 64)`.
+     */
+    void rebuild() noexcept {
+        size_type total = 0;
+        size_type in_super = 0;
+        m_sample_count = 0;
+        for (size_type w = 0; w < word_count; ++w) {
+            size_type j = w % words_per_superblock;
+            if (j == 0) {
+                total += in_super;
+                in_super = 0;
+                m_super[w / words_per_superblock] = static_cast<count_type>(total);
+                m_blocks[w / words_per_superblock] = 0;
+            } else {
+                word_type before = in_super;
+                m_blocks[w / words_per_superblock] |= before << (block_bits * (j - 1));
+            }
+            auto ones = static_cast<size_type>(popcount(m_words[w]));
+            /// Superblocks where samples of every 512th one fall
+            while (m_sample_count * superblock_bits < total + in_super + ones) {
+                m_samples[m_sample_count++] = static_cast<count_type>(w / words_per_superblock);
+            }
+            in_super += ones;
+        }
+        m_super[superblock_count] = static_cast<count_type>(total + in_super);
+    }
+
+    /// @subsection Queries
+
+    /**
+     * Number of set bits, as of the last `rebuild`.
+     */
+    size_type count() const noexcept {
+        return m_super[superblock_count];
+    }
+
+    /**
+     * Number of set bits before `pos`, `pos <= Bits`.
+     */
+    size_type rank(size_type pos) const noexcept {
+        size_type w = pos / word_bits;
+        if (w == word_count) {
+            return count();
+        }
+        word_type mask = (word_type(1) << (pos % word_bits)) - 1;
+        return m_super[w / words_per_superblock] + block(w) +
+               static_cast<size_type>(popcount(m_words[w] & mask));
+    }
+
+    /**
+     * Position of the set bit that has `k` set bits before it; `Bits` if
+     * `k >= count()`.
+     */
+    size_type select(size_type k) const noexcept {
+        if (k >= count()) {
+            return Bits;
+        }
+        /// The last superblock that starts with at most `k` ones
+        size_type sample = k / superblock_bits;
+        size_type lo = m_samples[sample];
+        size_type hi = (sample + 1 < m_sample_count) ? m_samples[sample + 1] + 1
+                                                      : superblock_count;
+        auto it = std::upper_bound(m_super.begin() + static_cast<std::ptrdiff_t>(lo) + 1,
+                                   m_super.begin() + static_cast<std::ptrdiff_t>(hi),
+                                   static_cast<count_type>(k));
+        auto s = static_cast<size_type>(it - m_super.begin()) - 1;
+        size_type r = k - m_super[s];
+        size_type w = s * words_per_superblock;
+        size_type last = std::min(w + words_per_superblock, word_count);
+        while (w + 1 < last && block(w + 1) <= r) {
+            ++w;
+        }
+        r -= block(w);
+        return w * word_bits + static_cast<size_type>(
+            detail::select_in_word(m_words[w], static_cast<int>(r)));
+    }
+
+private:
+    static constexpr size_type words_per_superblock = superblock_bits / word_bits;
+    static constexpr size_type superblock_count =
+        (word_count + words_per_superblock - 1) / words_per_superblock;
+    using count_type = typename std::conditional<(Bits <= 0xFFFFFFFFu),
+                                                 std::uint32_t,
+                                                 std::uint64_t>::type;
+
+    /// Width of a count of ones within a superblock, up to 448
+    static constexpr size_type block_bits = 9;
+
+    /**
+     * Ones before word `w` within its superblock.
+     */
+    size_type block(size_type w) const noexcept {
+        size_type j = w % words_per_superblock;
+        if (j == 0) {
+            return 0;
+        }
+        return static_cast<size_type>(m_blocks[w / words_per_superblock] >>
+                                      (block_bits * (j - 1))) &
+               ((size_type(1) << block_bits) - 1);
+    }
+
+    static void check(size_type pos) {
+        if (pos >= Bits) {
+            throw std::out_of_range("rttl::rank_select_bitset");
+        }
+    }
+
+    std::array<word_type, word_count> m_words = {};
+    /// Ones before every superblock, and the total
+    std::array<count_type, superblock_count + 1> m_super = {};
+    /// Ones before words 1..7 within every superblock, `block_bits` each
+    std::array<word_type, superblock_count> m_blocks = {};
+    /// Superblock of every 512th one
+    std::array<count_type, Bits / superblock_bits + 1> m_samples = {};
+    size_type m_sample_count = 0;
+
+};
+
+}
+
+#endif // RTTL_RANK_SELECT_BITSET_H_
@@ -0,0 +1,1113 @@
+/**
+ * @file rttl/roaring_bitmap.h
+ *
+ * Compressed bitmap of 32-bit values, for sparse sets over a large ID space.
+ *
+ * `rttl::roaring_bitmap<MaxContainers>` follows the Roaring layout: values
+ * are partitioned by their upper 16 bits into chunks, and the lower 16 bits
+ * of values of a chunk are kept in a container of one of three kinds:
+ *  - an array of up to 4096 sorted values;
+ *  - a bitmap of 65536 bits, for chunks of more than 4096 values;
+ *  - an array of runs of consecutive values, which `run_optimize` chooses
+ *    where it is smaller than both other kinds; a run container is converted
+ *    back to an array or a bitmap when modified, and combined as an array if
+ *    it holds at most 4096 values.
+ *
+ * Up to `MaxContainers` containers are allocated from a pool within the class,
+ * each taking 8 KiB whatever its kind, so large bitmaps are meant to be static
+ * (see `rttl::static_slot`) rather than placed on the stack. Operations that
+ * need more containers throw `std::length_error`.
+ *
+ * Set operations `&=`, `|=` and `-=` work per pair of containers with equal
+ * keys: arrays are intersected, merged and subtracted with the algorithms of
+ * `rttl::set_intersect` and friends, arrays are filtered through bitmaps, and
+ * bitmaps are combined word by word, with SSE2 where available.
+ *
+ * Serialization writes a compact little-endian format of this library (not
+ * the portable Roaring format): the number of containers as 32 bits, then for
+ * every container its key as 16 bits, kind as 8 bits, number of values or runs
+ * as 32 bits, and values as 16 bits, bitmap words as 64 bits, or runs as
+ * 16-bit first values and 16-bit lengths.
+ *
+ */
+#ifndef RTTL_ROARING_BITMAP_H_
+#define RTTL_ROARING_BITMAP_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include "rttl/algorithm.h"
+#include "rttl/bit.h"
+#include "rttl/simd.h"
+
+namespace rttl {
+
+namespace detail {
+
+enum class roaring_kind : std::uint8_t {
+    array,
+    bitmap,
+    run
+};
+
+enum class roaring_op {
+    intersect,
+    unite,
+    subtract
+};
+
+/// Number of 64-bit words of a bitmap container
+constexpr std::size_t roaring_words = 1024;
+
+/**
+ * Combines bitmaps `a` and `b` into `out`; returns the number of set bits.
+ */
+template <roaring_op Op>
+std::uint32_t combine_words(std::uint64_t* out, const std::uint64_t* a,
+                            const std::uint64_t* b) noexcept {
+    std::size_t i = 0;
+#if RTTL_HAS_SSE2
+    for (; i < roaring_words; i += 2) {
+        __m128i va = _mm_load_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_load_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i r;
+        if constexpr (Op == roaring_op::intersect) {
+            r = _mm_and_si128(va, vb);
+        } else if constexpr (Op == roaring_op::unite) {
+            r = _mm_or_si128(va, vb);
+        } else {
+            r = _mm_andnot_si128(vb, va);
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + i), r);
+    }
+#endif
+    for (; i < roaring_words; ++i) {
+        if constexpr (Op == roaring_op::intersect) {
+            out[i] = a[i] & b[i];
+        } else if constexpr (Op == roaring_op::unite) {
+            out[i] = a[i] | b[i];
+        } else {
+            out[i] = a[i] & ~b[i];
+        }
+    }
+    std::uint32_t count = 0;
+    for (i = 0; i < roaring_words; ++i) {
+        count += static_cast<std::uint32_t>(popcount(out[i]));
+    }
+    return count;
+}
+
+/// Sets bits `[first, last]`
+inline void set_word_range(std::uint64_t* words, std::uint32_t first,
+                           std::uint32_t last) noexcept {
+    std::size_t i = first / 64;
+    std::size_t j = last / 64;
+    std::uint64_t head = ~std::uint64_t(0) << (first % 64);
+    std::uint64_t tail = ~std::uint64_t(0) >> (63 - last % 64);
+    if (i == j) {
+        words[i] |= head & tail;
+        return;
+    }
+    words[i] |= head;
+    for (++i; i < j; ++i) {
+        words[i] = ~std::uint64_t(0);
+    }
+    words[j] |= tail;
+}
+
+struct roaring_run {
+    std::uint16_t start;
+    /// Number of values following `start`
+    std::uint16_t length;
+
+    friend bool operator==(const roaring_run& lhs, const roaring_run& rhs) noexcept {
+        return lhs.start == rhs.start && lhs.length == rhs.length;
+    }
+};
+
+/**
+ * Container of the lower 16 bits of values of one chunk.
+ */
+struct roaring_container {
+    static constexpr std::uint32_t universe = 65536;
+    static constexpr std::uint32_t max_array = 4096;
+    static constexpr std::uint32_t max_runs = 2048;
+
+    using words_type = std::array<std::uint64_t, roaring_words>;
+    using values_type = std::array<std::uint16_t, max_array>;
+    using runs_type = std::array<roaring_run, max_runs>;
+
+    roaring_kind kind = roaring_kind::array;
+    /// Number of values of an array or a bitmap, or of runs
+    std::uint32_t count = 0;
+    union {
+        alignas(16) words_type words;
+        values_type values;
+        runs_type runs;
+    };
+
+    std::uint32_t cardinality() const noexcept {
+        if (kind != roaring_kind::run) {
+            return count;
+        }
+        std::uint32_t result = count;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            result += runs[i].length;
+        }
+        return result;
+    }
+
+    bool test(std::uint16_t value) const noexcept {
+        return ((words[value / 64] >> (value % 64)) & 1) != 0;
+    }
+
+    bool contains(std::uint16_t value) const noexcept {
+        switch (kind) {
+        case roaring_kind::array:
+            return std::binary_search(values.begin(), values.begin() + count, value);
+        case roaring_kind::bitmap:
+            return test(value);
+        case roaring_kind::run: {
+            auto it = std::upper_bound(runs.begin(), runs.begin() + count, value,
+                [](std::uint16_t v, const roaring_run& r) { return v < r.start; });
+            return it != runs.begin() &&
+                   value - std::prev(it)->start <= std::prev(it)->length;
+        }
+        }
+        return false;
+    }
+
+    /// The first set bit at or after `from` of a bitmap, `universe` if none
+    std::uint32_t next_set(std::uint32_t from) const noexcept {
+        return next_bit(from, 0);
+    }
+
+    std::uint32_t next_clear(std::uint32_t from) const noexcept {
+        return next_bit(from, ~std::uint64_t(0));
+    }
+
+    /// Writes values as a bitmap to `out`, which must not be own storage
+    void to_words(std::uint64_t* out) const noexcept {
+        if (kind == roaring_kind::bitmap) {
+            std::copy(words.begin(), words.end(), out);
+            return;
+        }
+        std::fill_n(out, roaring_words, 0);
+        if (kind == roaring_kind::array) {
+            for (std::uint32_t i = 0; i < count; ++i) {
+                out[values[i] / 64] |= std::uint64_t(1) << (values[i] % 64);
+            }
+        } else {
+            for (std::uint32_t i = 0; i < count; ++i) {
+                set_word_range(out, runs[i].start,
+                               std::uint32_t(runs[i].start) + runs[i].length);
+            }
+        }
+    }
+
+    /**
+     * Replaces values with `count` bits set in `in`, which must not be own
+     * storage, as an array or a bitmap.
+     */
+    void from_words(const std::uint64_t* in, std::uint32_t bits) noexcept {
+        count = bits;
+        if (bits > max_array) {
+            kind = roaring_kind::bitmap;
+            std::copy_n(in, roaring_words, words.begin());
+            return;
+        }
+        kind = roaring_kind::array;
+        std::uint32_t n = 0;
+        for (std::size_t i = 0; i < roaring_words; ++i) {
+            for (std::uint64_t w = in[i]; w != 0; w &= w - 1) {
+                values[n++] = static_cast<std::uint16_t>(i * 64 +
+                    static_cast<std::size_t>(countr_zero(w)));
+            }
+        }
+    }
+
+    /// Converts a run container of at most `max_array` values to an array
+    void runs_to_array() noexcept {
+        values_type scratch;
+        std::uint32_t n = 0;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::uint32_t last = std::uint32_t(runs[i].start) + runs[i].length;
+            for (std::uint32_t v = runs[i].start; v <= last; ++v) {
+                scratch[n++] = static_cast<std::uint16_t>(v);
+            }
+        }
+        kind = roaring_kind::array;
+        count = n;
+        std::copy_n(scratch.begin(), n, values.begin());
+    }
+
+    /// Converts a run container to an array or a bitmap
+    void canonicalize() noexcept {
+        if (kind == roaring_kind::run) {
+            alignas(16) words_type scratch;
+            to_words(scratch.data());
+            from_words(scratch.data(), cardinality());
+        }
+    }
+
+    std::uint32_t run_count() const noexcept {
+        std::uint32_t result = 0;
+        switch (kind) {
+        case roaring_kind::array:
+            for (std::uint32_t i = 0; i < count; ++i) {
+                result += (i == 0 || values[i] != values[i - 1] + 1) ? 1 : 0;
+            }
+            break;
+        case roaring_kind::bitmap: {
+            std::uint64_t prev = 0;
+            for (std::uint64_t w : words) {
+                result += static_cast<std::uint32_t>(
+                    popcount(w & ~((w << 1) | (prev >> 63))));
+                prev = w;
+            }
+            break;
+        }
+        case roaring_kind::run:
+            result = count;
+            break;
+        }
+        return result;
+    }
+
+    /**
+     * Converts to the kind taking the least storage.
+     */
+    void optimize() noexcept {
+        std::uint32_t values_count = cardinality();
+        std::size_t size = (values_count > max_array) ? sizeof(words_type)
+                                                      : 2 * std::size_t(values_count);
+        if (4 * std::size_t(run_count()) >= size) {
+            canonicalize();
+            return;
+        }
+        if (kind == roaring_kind::run) {
+            return;
+        }
+        alignas(16) runs_type scratch;
+        std::uint32_t n = 0;
+        if (kind == roaring_kind::array) {
+            for (std::uint32_t i = 0; i < count; ++i) {
+                if (n > 0 && values[i] == scratch[n - 1].start + scratch[n - 1].length + 1) {
+                    ++scratch[n - 1].length;
+                } else {
+                    scratch[n++] = { values[i], 0 };
+                }
+            }
+        } else {
+            for (std::uint32_t pos = next_set(0); pos < universe;) {
+                std::uint32_t end = next_clear(pos);
+                scratch[n++] = { static_cast<std::uint16_t>(pos),
+                                 static_cast<std::uint16_t>(end - 1 - pos) };
+                pos = next_set(end);
+            }
+        }
+        kind = roaring_kind::run;
+        count = n;
+        std::copy_n(scratch.begin(), n, runs.begin());
+    }
+
+    bool add(std::uint16_t value) noexcept {
+        if (kind == roaring_kind::run) {
+            if (contains(value)) {
+                return false;
+            }
+            canonicalize();
+        }
+        if (kind == roaring_kind::array) {
+            std::uint16_t* first = values.data();
+            std::uint16_t* last = first + count;
+            std::uint16_t* pos = std::lower_bound(first, last, value);
+            if (pos != last && *pos == value) {
+                return false;
+            }
+            if (count < max_array) {
+                std::copy_backward(pos, last, last + 1);
+                *pos = value;
+                ++count;
+                return true;
+            }
+            alignas(16) words_type scratch;
+            to_words(scratch.data());
+            kind = roaring_kind::bitmap;
+            words = scratch;
+        }
+        std::uint64_t bit = std::uint64_t(1) << (value % 64);
+        if ((words[value / 64] & bit) != 0) {
+            return false;
+        }
+        words[value / 64] |= bit;
+        ++count;
+        return true;
+    }
+
+    bool remove(std::uint16_t value) noexcept {
+        if (kind == roaring_kind::run) {
+            if (!contains(value)) {
+                return false;
+            }
+            canonicalize();
+        }
+        if (kind == roaring_kind::array) {
+            std::uint16_t* first = values.data();
+            std::uint16_t* last = first + count;
+            std::uint16_t* pos = std::lower_bound(first, last, value);
+            if (pos == last || *pos != value) {
+                return false;
+            }
+            std::copy(pos + 1, last, pos);
+            --count;
+            return true;
+        }
+        std::uint64_t bit = std::uint64_t(1) << (value % 64);
+        if ((words[value / 64] & bit) == 0) {
+            return false;
+        }
+        words[value / 64] &= ~bit;
+        --count;
+        shrink();
+        return true;
+    }
+
+    /// Converts a bitmap of few enough values to an array
+    void shrink() noexcept {
+        if (kind == roaring_kind::bitmap && count <= max_array) {
+            alignas(16) words_type scratch = words;
+            from_words(scratch.data(), count);
+        }
+    }
+
+    template <roaring_op Op>
+    void combine(const roaring_container& other) noexcept {
+        /// Runs of few values take the array paths rather than bitmaps
+        if (kind == roaring_kind::run && cardinality() <= max_array) {
+            runs_to_array();
+        }
+        if (other.kind == roaring_kind::run && other.cardinality() <= max_array) {
+            roaring_container expanded;
+            expanded.assign(other);
+            expanded.runs_to_array();
+            combine<Op>(expanded);
+            return;
+        }
+        if (kind == roaring_kind::array && other.kind == roaring_kind::array &&
+            (Op != roaring_op::unite || count + other.count <= max_array)) {
+            values_type out;
+            set_writer<std::uint16_t> sink{ out.data() };
+            if constexpr (Op == roaring_op::intersect) {
+                set_intersect(values.data(), count, other.values.data(), other.count, sink);
+            } else if constexpr (Op == roaring_op::unite) {
+                set_union(values.data(), count, other.values.data(), other.count, sink);
+            } else {
+                set_difference(values.data(), count, other.values.data(), other.count, sink);
+            }
+            count = static_cast<std::uint32_t>(sink.out - out.data());
+            std::copy_n(out.begin(), count, values.begin());
+            return;
+        }
+        if (kind == roaring_kind::array && other.kind == roaring_kind::bitmap &&
+            Op != roaring_op::unite) {
+            std::uint32_t n = 0;
+            for (std::uint32_t i = 0; i < count; ++i) {
+                if (other.test(values[i]) == (Op == roaring_op::intersect)) {
+                    values[n++] = values[i];
+                }
+            }
+            count = n;
+            return;
+        }
+        if (kind == roaring_kind::bitmap && other.kind == roaring_kind::array) {
+            if constexpr (Op == roaring_op::intersect) {
+                values_type out;
+                std::uint32_t n = 0;
+                for (std::uint32_t i = 0; i < other.count; ++i) {
+                    if (test(other.values[i])) {
+                        out[n++] = other.values[i];
+                    }
+                }
+                kind = roaring_kind::array;
+                count = n;
+                std::copy_n(out.begin(), n, values.begin());
+            } else {
+                for (std::uint32_t i = 0; i < other.count; ++i) {
+                    std::uint16_t value = other.values[i];
+                    std::uint64_t bit = std::uint64_t(1) << (value % 64);
+                    bool present = (words[value / 64] & bit) != 0;
+                    if constexpr (Op == roaring_op::unite) {
+                        words[value / 64] |= bit;
+                        count += present ? 0 : 1;
+                    } else {
+                        words[value / 64] &= ~bit;
+                        count -= present ? 1 : 0;
+                    }
+                }
+                shrink();
+            }
+            return;
+        }
+        alignas(16) words_type a;
+        alignas(16) words_type b;
+        alignas(16) words_type out;
+        const std::uint64_t* pa = words.data();
+        const std::uint64_t* pb = other.words.data();
+        if (kind != roaring_kind::bitmap) {
+            to_words(a.data());
+            pa = a.data();
+        }
+        if (other.kind != roaring_kind::bitmap) {
+            other.to_words(b.data());
+            pb = b.data();
+        }
+        from_words(out.data(), combine_words<Op>(out.data(), pa, pb));
+    }
+
+    void assign(const roaring_container& other) noexcept {
+        kind = other.kind;
+        count = other.count;
+        switch (kind) {
+        case roaring_kind::array:
+            std::copy_n(other.values.begin(), count, values.begin());
+            break;
+        case roaring_kind::bitmap:
+            words = other.words;
+            break;
+        case roaring_kind::run:
+            std::copy_n(other.runs.begin(), count, runs.begin());
+            break;
+        }
+    }
+
+    bool equals(const roaring_container& other) const noexcept {
+        if (kind == other.kind) {
+            switch (kind) {
+            case roaring_kind::array:
+                return count == other.count &&
+                       std::equal(values.begin(), values.begin() + count,
+                                  other.values.begin());
+            case roaring_kind::bitmap:
+                return count == other.count && words == other.words;
+            case roaring_kind::run:
+                return count == other.count &&
+                       std::equal(runs.begin(), runs.begin() + count,
+                                  other.runs.begin());
+            }
+        }
+        if (cardinality() != other.cardinality()) {
+            return false;
+        }
+        alignas(16) words_type a;
+        alignas(16) words_type b;
+        to_words(a.data());
+        other.to_words(b.data());
+        return a == b;
+    }
+
+    /// @subsection Iteration by position: index of a value, bit or run, and offset in a run
+
+    std::uint32_t first() const noexcept {
+        return (kind == roaring_kind::bitmap) ? next_set(0) : 0;
+    }
+
+    bool advance(std::uint32_t& pos, std::uint32_t& offset) const noexcept {
+        switch (kind) {
+        case roaring_kind::array:
+            return ++pos < count;
+        case roaring_kind::bitmap:
+            pos = next_set(pos + 1);
+            return pos < universe;
+        case roaring_kind::run:
+            if (offset < runs[pos].length) {
+                ++offset;
+                return true;
+            }
+            offset = 0;
+            return ++pos < count;
+        }
+        return false;
+    }
+
+    std::uint32_t value_at(std::uint32_t pos, std::uint32_t offset) const noexcept {
+        switch (kind) {
+        case roaring_kind::array:
+            return values[pos];
+        case roaring_kind::bitmap:
+            return pos;
+        case roaring_kind::run:
+            return runs[pos].start + offset;
+        }
+        return 0;
+    }
+
+    template <typename Function>
+    void for_each(std::uint32_t base, Function& f) const {
+        switch (kind) {
+        case roaring_kind::array:
+            for (std::uint32_t i = 0; i < count; ++i) {
+                f(base | values[i]);
+            }
+            break;
+        case roaring_kind::bitmap:
+            for (std::size_t i = 0; i < roaring_words; ++i) {
+                for (std::uint64_t w = words[i]; w != 0; w &= w - 1) {
+                    f(base | static_cast<std::uint32_t>(
+                        i * 64 + static_cast<std::size_t>(countr_zero(w))));
+                }
+            }
+            break;
+        case roaring_kind::run:
+            for (std::uint32_t i = 0; i < count; ++i) {
+                std::uint32_t last = std::uint32_t(runs[i].start) + runs[i].length;
+                for (std::uint32_t v = runs[i].start; v <= last; ++v) {
+                    f(base | v);
+                }
+            }
+            break;
+        }
+    }
+
+    /// Size of values in the serialized form
+    std::size_t payload_size() const noexcept {
+        switch (kind) {
+        case roaring_kind::array:
+            return 2 * std::size_t(count);
+        case roaring_kind::bitmap:
+            return sizeof(words_type);
+        case roaring_kind::run:
+            return 4 * std::size_t(count);
+        }
+        return 0;
+    }
+
+private:
+    std::uint32_t next_bit(std::uint32_t from, std::uint64_t flip) const noexcept {
+        if (from >= universe) {
+            return universe;
+        }
+        std::size_t i = from / 64;
+        std::uint64_t w = (words[i] ^ flip) & (~std::uint64_t(0) << (from % 64));
+        while (w == 0) {
+            if (++i == roaring_words) {
+                return universe;
+            }
+            w = words[i] ^ flip;
+        }
+        return static_cast<std::uint32_t>(i * 64 +
+            static_cast<std::size_t>(countr_zero(w)));
+    }
+};
+
+}
+
+template <std::size_t MaxContainers>
+class roaring_bitmap {
+    static_assert(MaxContainers > 0 && MaxContainers <= 65536,
+                  "MaxContainers must be within 1 to 65536");
+    using container = detail::roaring_container;
+    using kind = detail::roaring_kind;
+    using op = detail::roaring_op;
+public:
+
+    /// @section Member types
+
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        const_iterator() noexcept = default;
+
+        value_type operator*() const noexcept {
+            return (value_type(m_owner->m_keys[m_index]) << 16) |
+                   m_owner->at(m_index).value_at(m_pos, m_offset);
+        }
+
+        const_iterator& operator++() noexcept {
+            if (!m_owner->at(m_index).advance(m_pos, m_offset)) {
+                ++m_index;
+                m_pos = 0;
+                m_offset = 0;
+                start();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return lhs.m_index == rhs.m_index && lhs.m_pos == rhs.m_pos &&
+                   lhs.m_offset == rhs.m_offset;
+        }
+
+        friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class roaring_bitmap;
+
+        const_iterator(const roaring_bitmap* owner, size_type index) noexcept
+            : m_owner(owner), m_index(index) {
+            start();
+        }
+
+        void start() noexcept {
+            if (m_index < m_owner->m_size) {
+                m_pos = m_owner->at(m_index).first();
+            }
+        }
+
+        const roaring_bitmap* m_owner = nullptr;
+        size_type m_index = 0;
+        std::uint32_t m_pos = 0;
+        std::uint32_t m_offset = 0;
+    };
+
+    using iterator = const_iterator;
+
+    static constexpr size_type max_containers = MaxContainers;
+
+    /// @section Member functions
+
+    roaring_bitmap() = default;
+
+    /// @subsection Iterators
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, m_size);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * Calls `f(value)` for all values in ascending order, faster than
+     * iterators do.
+     */
+    template <typename Function>
+    void for_each(Function f) const {
+        for (size_type i = 0; i < m_size; ++i) {
+            at(i).for_each(value_type(m_keys[i]) << 16, f);
+        }
+    }
+
+    /// @subsection Capacity
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    /**
+     * Number of values.
+     */
+    size_type cardinality() const noexcept {
+        size_type result = 0;
+        for (size_type i = 0; i < m_size; ++i) {
+            result += at(i).cardinality();
+        }
+        return result;
+    }
+
+    size_type container_count() const noexcept {
+        return m_size;
+    }
+
+    /// @subsection Lookup
+
+    bool contains(value_type value) const noexcept {
+        size_type pos = find(high(value));
+        return pos < m_size && m_keys[pos] == high(value) &&
+               at(pos).contains(low(value));
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Adds `value`; returns whether it was absent. Throws
+     * `std::length_error` if it needs a container and none is left.
+     */
+    bool add(value_type value) {
+        size_type pos = find(high(value));
+        if (pos == m_size || m_keys[pos] != high(value)) {
+            insert(pos, high(value)).kind = kind::array;
+        }
+        return at(pos).add(low(value));
+    }
+
+    /**
+     * Removes `value`; returns whether it was present.
+     */
+    bool remove(value_type value) noexcept {
+        size_type pos = find(high(value));
+        if (pos == m_size || m_keys[pos] != high(value) ||
+            !at(pos).remove(low(value))) {
+            return false;
+        }
+        if (at(pos).count == 0) {
+            erase(pos);
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        m_size = 0;
+        m_used = 0;
+        m_free_count = 0;
+    }
+
+    /**
+     * Converts every container to the kind taking the least storage,
+     * introducing run containers where they do.
+     */
+    void run_optimize() noexcept {
+        for (size_type i = 0; i < m_size; ++i) {
+            at(i).optimize();
+        }
+    }
+
+    /// @subsection Set operations
+
+    roaring_bitmap& operator&=(const roaring_bitmap& other) noexcept {
+        if (this != &other) {
+            combine_matching<op::intersect, false>(other);
+        }
+        return *this;
+    }
+
+    roaring_bitmap& operator-=(const roaring_bitmap& other) noexcept {
+        if (this == &other) {
+            clear();
+        } else {
+            combine_matching<op::subtract, true>(other);
+        }
+        return *this;
+    }
+
+    /**
+     * Adds values of `other`; throws `std::length_error` before modifying
+     * the bitmap if the result needs more than `MaxContainers` containers.
+     */
+    roaring_bitmap& operator|=(const roaring_bitmap& other) {
+        if (this == &other) {
+            return *this;
+        }
+        size_type total = m_size;
+        for (size_type i = 0, j = 0; j < other.m_size; ++j) {
+            while (i < m_size && m_keys[i] < other.m_keys[j]) {
+                ++i;
+            }
+            total += (i == m_size || m_keys[i] != other.m_keys[j]) ? 1 : 0;
+        }
+        if (total > MaxContainers) {
+            throw std::length_error("rttl::roaring_bitmap");
+        }
+        /// Merges keys from the end, so containers are moved at most once
+        size_type i = m_size;
+        size_type j = other.m_size;
+        for (size_type k = total; j > 0; --k) {
+            if (i > 0 && m_keys[i - 1] > other.m_keys[j - 1]) {
+                --i;
+            } else if (i > 0 && m_keys[i - 1] == other.m_keys[j - 1]) {
+                --i;
+                --j;
+                at(i).template combine<op::unite>(other.at(j));
+            } else {
+                --j;
+                m_keys[k - 1] = other.m_keys[j];
+                m_slots[k - 1] = allocate();
+                at(k - 1).assign(other.at(j));
+                continue;
+            }
+            m_keys[k - 1] = m_keys[i];
+            m_slots[k - 1] = m_slots[i];
+        }
+        m_size = total;
+        return *this;
+    }
+
+    /// @subsection Serialization
+
+    size_type serialized_size() const noexcept {
+        size_type result = 4;
+        for (size_type i = 0; i < m_size; ++i) {
+            result += container_header + at(i).payload_size();
+        }
+        return result;
+    }
+
+    /**
+     * Writes the bitmap to `out`; returns the number of bytes written.
+     * Throws `std::length_error` if `capacity` is less than
+     * `serialized_size()`.
+     */
+    size_type serialize(void* out, size_type capacity) const {
+        size_type size = serialized_size();
+        if (capacity < size) {
+            throw std::length_error("rttl::roaring_bitmap");
+        }
+        auto* p = static_cast<std::uint8_t*>(out);
+        detail::store_le(p, static_cast<std::uint32_t>(m_size));
+        p += 4;
+        for (size_type i = 0; i < m_size; ++i) {
+            const container& c = at(i);
+            detail::store_le(p, m_keys[i]);
+            p[2] = static_cast<std::uint8_t>(c.kind);
+            detail::store_le(p + 3, c.count);
+            p += container_header;
+            switch (c.kind) {
+            case kind::array:
+                for (std::uint32_t k = 0; k < c.count; ++k, p += 2) {
+                    detail::store_le(p, c.values[k]);
+                }
+                break;
+            case kind::bitmap:
+                for (std::uint64_t w : c.words) {
+                    detail::store_le(p, w);
+                    p += 8;
+                }
+                break;
+            case kind::run:
+                for (std::uint32_t k = 0; k < c.count; ++k, p += 4) {
+                    detail::store_le(p, c.runs[k].start);
+                    detail::store_le(p + 2, c.runs[k].length);
+                }
+                break;
+            }
+        }
+        return size;
+    }
+
+    /**
+     * Replaces contents with the bitmap serialized in `size` bytes at `in`.
+     * Throws `std::invalid_argument` if the data is malformed, and
+     * `std::length_error` if it has more than `MaxContainers` containers;
+     * the bitmap is then empty.
+     */
+    void deserialize(const void* in, size_type size) {
+        clear();
+        const auto* p = static_cast<const std::uint8_t*>(in);
+        if (size < 4) {
+            throw std::invalid_argument("rttl::roaring_bitmap");
+        }
+        if (detail::load_le<std::uint32_t>(p) > MaxContainers) {
+            throw std::length_error("rttl::roaring_bitmap");
+        }
+        if (!read(p + 4, p + size, detail::load_le<std::uint32_t>(p))) {
+            clear();
+            throw std::invalid_argument("rttl::roaring_bitmap");
+        }
+    }
+
+    /// @subsection Comparison
+
+    friend bool operator==(const roaring_bitmap& lhs, const roaring_bitmap& rhs) noexcept {
+        if (lhs.m_size != rhs.m_size) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.m_size; ++i) {
+            if (lhs.m_keys[i] != rhs.m_keys[i] || !lhs.at(i).equals(rhs.at(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const roaring_bitmap& lhs, const roaring_bitmap& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    /// Size of the key, kind and count of a serialized container
+    static constexpr size_type container_header = 7;
+
+    static std::uint16_t high(value_type value) noexcept {
+        return static_cast<std::uint16_t>(value >> 16);
+    }
+
+    static std::uint16_t low(value_type value) noexcept {
+        return static_cast<std::uint16_t>(value);
+    }
+
+    container& at(size_type pos) noexcept {
+        return m_pool[m_slots[pos]];
+    }
+
+    const container& at(size_type pos) const noexcept {
+        return m_pool[m_slots[pos]];
+    }
+
+    /// Position of the first key not less than `key`
+    size_type find(std::uint16_t key) const noexcept {
+        return static_cast<size_type>(
+            std::lower_bound(m_keys.begin(), m_keys.begin() + m_size, key) -
+            m_keys.begin());
+    }
+
+    std::uint32_t allocate() {
+        if (m_free_count > 0) {
+            return m_free[--m_free_count];
+        }
+        if (m_used == MaxContainers) {
+            throw std::length_error("rttl::roaring_bitmap");
+        }
+        return static_cast<std::uint32_t>(m_used++);
+    }
+
+    /// Inserts an empty container with `key` at `pos`
+    container& insert(size_type pos, std::uint16_t key) {
+        std::uint32_t slot = allocate();
+        std::copy_backward(m_keys.begin() + pos, m_keys.begin() + m_size,
+                           m_keys.begin() + m_size + 1);
+        std::copy_backward(m_slots.begin() + pos, m_slots.begin() + m_size,
+                           m_slots.begin() + m_size + 1);
+        m_keys[pos] = key;
+        m_slots[pos] = slot;
+        ++m_size;
+        m_pool[slot].count = 0;
+        return m_pool[slot];
+    }
+
+    void erase(size_type pos) noexcept {
+        m_free[m_free_count++] = m_slots[pos];
+        std::copy(m_keys.begin() + pos + 1, m_keys.begin() + m_size,
+                  m_keys.begin() + pos);
+        std::copy(m_slots.begin() + pos + 1, m_slots.begin() + m_size,
+                  m_slots.begin() + pos);
+        --m_size;
+    }
+
+    /**
+     * Combines containers with keys present in `other`, and keeps other
+     * containers if `KeepUnmatched` or removes them otherwise.
+     */
+    template <op Op, bool KeepUnmatched>
+    void combine_matching(const roaring_bitmap& other) noexcept {
+        size_type n = 0;
+        for (size_type i = 0, j = 0; i < m_size; ++i) {
+            while (j < other.m_size && other.m_keys[j] < m_keys[i]) {
+                ++j;
+            }
+            if (j < other.m_size && other.m_keys[j] == m_keys[i]) {
+                at(i).template combine<Op>(other.at(j));
+            } else if (!KeepUnmatched) {
+                at(i).count = 0;
+            }
+            if (at(i).count == 0) {
+                m_free[m_free_count++] = m_slots[i];
+            } else {
+                m_keys[n] = m_keys[i];
+                m_slots[n] = m_slots[i];
+                ++n;
+            }
+        }
+        m_size = n;
+    }
+
+    /// Reads `n` containers from `[p, end)`; returns `false` if malformed
+    bool read(const std::uint8_t* p, const std::uint8_t* end, std::uint32_t n) noexcept {
+        auto remaining = [&p, end]() {
+            return static_cast<size_type>(end - p);
+        };
+        for (std::uint32_t i = 0; i < n; ++i) {
+            if (remaining() < container_header) {
+                return false;
+            }
+            auto key = detail::load_le<std::uint16_t>(p);
+            std::uint8_t type = p[2];
+            auto count = detail::load_le<std::uint32_t>(p + 3);
+            p += container_header;
+            if ((m_size > 0 && key <= m_keys[m_size - 1]) || count == 0) {
+                return false;
+            }
+            container& c = insert(m_size, key);
+            if (type == static_cast<std::uint8_t>(kind::array)) {
+                if (count > container::max_array || remaining() < 2 * size_type(count)) {
+                    return false;
+                }
+                c.kind = kind::array;
+                for (std::uint32_t k = 0; k < count; ++k, p += 2) {
+                    c.values[k] = detail::load_le<std::uint16_t>(p);
+                    if (k > 0 && c.values[k] <= c.values[k - 1]) {
+                        return false;
+                    }
+                }
+                c.count = count;
+            } else if (type == static_cast<std::uint8_t>(kind::bitmap)) {
+                if (remaining() < sizeof(container::words_type)) {
+                    return false;
+                }
+                alignas(16) container::words_type words;
+                std::uint32_t bits = 0;
+                for (std::uint64_t& w : words) {
+                    w = detail::load_le<std::uint64_t>(p);
+                    bits += static_cast<std::uint32_t>(popcount(w));
+                    p += 8;
+                }
+                if (bits != count) {
+                    return false;
+                }
+                c.from_words(words.data(), bits);
+            } else if (type == static_cast<std::uint8_t>(kind::run)) {
+                if (count > container::max_runs || remaining() < 4 * size_type(count)) {
+                    return false;
+                }
+                c.kind = kind::run;
+                std::uint32_t next = 0;
+                for (std::uint32_t k = 0; k < count; ++k, p += 4) {
+                    detail::roaring_run r = { detail::load_le<std::uint16_t>(p),
+                                              detail::load_le<std::uint16_t>(p + 2) };
+                    /// Runs must be ascending and separated by missing values
+                    if (r.start < next || std::uint32_t(r.start) + r.length >=
+                                              container::universe) {
+                        return false;
+                    }
+                    c.runs[k] = r;
+                    next = std::uint32_t(r.start) + r.length + 2;
+                }
+                c.count = count;
+            } else {
+                return false;
+            }
+        }
+        return p == end;
+    }
+
+    std::array<std::uint16_t, MaxContainers> m_keys;
+    /// Pool indices of containers, in the order of keys
+    std::array<std::uint32_t, MaxContainers> m_slots;
+    std::array<container, MaxContainers> m_pool;
+    /// Released pool indices, and the number of pool entries ever used
+    std::array<std::uint32_t, MaxContainers> m_free;
+    size_type m_size = 0;
+    size_type m_used = 0;
+    size_type m_free_count = 0;
+
+};
+
+}
+
+#endif // RTTL_ROARING_BITMAP_H_
@@ -0,0 +1,688 @@
+/**
+ * @file rttl/segmented_vector.h
+ *
+ * Vector container whose elements are stored in fixed-size segments drawn
+ * from a statically allocated pool.
+ *
+ * `rttl::segment_pool<T, SegmentSize, Segments>` stores `Segments` segments of
+ * `SegmentSize` elements within the class and hands them out one at a time;
+ * it is safe to use from several threads without locks: free segments form a
+ * lock-free stack with a tagged head, so `push_back` never blocks, also when
+ * it needs a segment once per `SegmentSize` insertions.
+ *
+ * `rttl::segmented_vector<T, SegmentSize, MaxSegments, PoolSegments>` holds a
+ * table of up to `MaxSegments` segments from a pool and provides similar
+ * behaviour as `rttl::vector` with following differences:
+ *  - instances take space only for the segment table, so a large `max_size()`
+ *    does not bloat every instance; vectors of the same type share the pool of
+ *    `PoolSegments` segments by default, or use the pool given on
+ *    construction; `max_size()` bounds the segment table only, while vectors
+ *    sharing a pool also share its segments, so a vector may hold fewer
+ *    elements once others hold segments;
+ *  - `push_back` and `emplace_back` are `O(1)` and never relocate elements,
+ *    so addresses of elements stay stable until they are removed;
+ *  - `SegmentSize` must be a power of two, indexing is a shift and a mask;
+ *  - elements are not contiguous, there is no `data()`; iterators move along a
+ *    segment by pointer increments, `for_each_segment` visits contiguous runs;
+ *  - only insertion and removal at the end are provided;
+ *  - `clear` and `pop_back` keep segments, `shrink_to_fit` returns unused ones
+ *    to the pool; operations that need a segment throw `std::length_error`
+ *    when the table or the pool is exhausted.
+ *
+ */
+#ifndef RTTL_SEGMENTED_VECTOR_H_
+#define RTTL_SEGMENTED_VECTOR_H_
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "rttl/bit.h"
+
+namespace rttl {
+
+template <typename T, std::size_t SegmentSize, std::size_t Segments>
+class segment_pool {
+    static_assert(Segments > 0, "Empty pools are not allowed");
+    static_assert(Segments < 0xFFFFFFFFu, "Segment numbers must fit in 32 bits");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+
+    /// @section Member functions
+
+    segment_pool() noexcept {
+        for (size_type i = 0; i < Segments; ++i) {
+            m_next[i].store(static_cast<std::uint32_t>(i + 1), std::memory_order_relaxed);
+        }
+        m_next[Segments - 1].store(npos, std::memory_order_relaxed);
+    }
+
+    segment_pool(const segment_pool&) = delete;
+    segment_pool& operator=(const segment_pool&) = delete;
+
+    /**
+     * Storage for `SegmentSize` elements; throws `std::length_error` if all
+     * segments are in use.
+     */
+    T* acquire() {
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        for (;;) {
+            auto index = static_cast<std::uint32_t>(head);
+            if (index == npos) {
+                throw std::length_error("rttl::segment_pool");
+            }
+            /// May be stale if the segment is taken meanwhile, then the tag
+            /// of the head has changed and the exchange fails
+            std::uint32_t next = m_next[index].load(std::memory_order_relaxed);
+            if (m_head.compare_exchange_weak(head, tagged(head, next),
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                m_available.fetch_sub(1, std::memory_order_relaxed);
+                return reinterpret_cast<T*>(&m_segments[index]);
+            }
+        }
+    }
+
+    /**
+     * Returns a segment obtained from `acquire`; its elements must have been
+     * destroyed.
+     */
+    void release(T* segment) noexcept {
+        auto index = static_cast<std::uint32_t>(
+            reinterpret_cast<segment_storage*>(segment) - m_segments.data());
+        std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        do {
+            m_next[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+        } while (!m_head.compare_exchange_weak(head, tagged(head, index),
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+        m_available.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of segments that may be acquired, exact when no other thread
+     * acquires or releases segments meanwhile.
+     */
+    size_type available() const noexcept {
+        return m_available.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_type max_segments() noexcept {
+        return Segments;
+    }
+
+private:
+    using segment_storage = typename std::aligned_storage<
+        sizeof(T) * SegmentSize, alignof(T)>::type;
+
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    /// Head of index `index` with the tag of `head` incremented, so that a
+    /// head popped and pushed back meanwhile does not compare equal
+    static std::uint64_t tagged(std::uint64_t head, std::uint32_t index) noexcept {
+        return ((head >> 32) + 1) << 32 | index;
+    }
+
+    std::array<segment_storage, Segments> m_segments;
+    /// Free list of segments: index of the next free segment of each
+    std::array<std::atomic<std::uint32_t>, Segments> m_next;
+    /// Tag in the upper and index of the first free segment in the lower half
+    std::atomic<std::uint64_t> m_head{0};
+    std::atomic<size_type> m_available{Segments};
+
+};
+
+template <typename T, std::size_t SegmentSize, std::size_t MaxSegments,
+          std::size_t PoolSegments = MaxSegments>
+class segmented_vector {
+    static_assert(std::is_destructible<T>::value,
+                  "T must meet requirements of Erasable");
+    static_assert(SegmentSize > 0 && (SegmentSize & (SegmentSize - 1)) == 0,
+                  "SegmentSize must be a power of two");
+    static_assert(MaxSegments > 0, "At least one segment is required");
+
+    static constexpr std::size_t shift =
+        static_cast<std::size_t>(countr_zero(SegmentSize));
+    static constexpr std::size_t mask = SegmentSize - 1;
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T*, T*>::type;
+        using reference = typename std::conditional<Const, const T&, T&>::type;
+
+        basic_iterator() noexcept = default;
+
+        basic_iterator(T* const* segments, std::size_t pos) noexcept
+            : m_segments(segments), m_pos(pos) {
+            locate();
+        }
+
+        /// Conversion of iterator to const_iterator
+        template <bool OtherConst,
+                  typename = std::enable_if_t<Const && !OtherConst>>
+        basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            : m_segments(other.m_segments), m_pos(other.m_pos),
+              m_ptr(other.m_ptr) {}
+
+        reference operator*() const noexcept {
+            return *m_ptr;
+        }
+
+        pointer operator->() const noexcept {
+            return m_ptr;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        basic_iterator& operator++() noexcept {
+            ++m_pos;
+            if ((m_pos & mask) == 0) {
+                locate();
+            } else {
+                ++m_ptr;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            basic_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        basic_iterator& operator--() noexcept {
+            if ((m_pos & mask) == 0) {
+                --m_pos;
+                locate();
+            } else {
+                --m_pos;
+                --m_ptr;
+            }
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            basic_iterator result = *this;
+            --*this;
+            return result;
+        }
+
+        basic_iterator& operator+=(difference_type n) noexcept {
+            m_pos = static_cast<std::size_t>(
+                static_cast<difference_type>(m_pos) + n);
+            locate();
+            return *this;
+        }
+
+        basic_iterator& operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+
+        friend basic_iterator operator+(basic_iterator it,
+                                        difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend basic_iterator operator+(difference_type n,
+                                        basic_iterator it) noexcept {
+            return it += n;
+        }
+
+        friend basic_iterator operator-(basic_iterator it,
+                                        difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const basic_iterator& lhs,
+                                         const basic_iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.m_pos) -
+                   static_cast<difference_type>(rhs.m_pos);
+        }
+
+        friend bool operator==(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept {
+            return lhs.m_pos == rhs.m_pos;
+        }
+
+        friend bool operator!=(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept {
+            return lhs.m_pos != rhs.m_pos;
+        }
+
+        friend bool operator<(const basic_iterator& lhs,
+                              const basic_iterator& rhs) noexcept {
+            return lhs.m_pos < rhs.m_pos;
+        }
+
+        friend bool operator>(const basic_iterator& lhs,
+                              const basic_iterator& rhs) noexcept {
+            return lhs.m_pos > rhs.m_pos;
+        }
+
+        friend bool operator<=(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept {
+            return lhs.m_pos <= rhs.m_pos;
+        }
+
+        friend bool operator>=(const basic_iterator& lhs,
+                               const basic_iterator& rhs) noexcept {
+            return lhs.m_pos >= rhs.m_pos;
+        }
+
+    private:
+        friend class basic_iterator<!Const>;
+
+        /// Element pointer for the position, null past allocated segments
+        void locate() noexcept {
+            std::size_t segment = m_pos >> shift;
+            m_ptr = (segment < MaxSegments && m_segments[segment] != nullptr)
+                  ? m_segments[segment] + (m_pos & mask) : nullptr;
+        }
+
+        T* const* m_segments = nullptr;
+        std::size_t m_pos = 0;
+        pointer m_ptr = nullptr;
+    };
+
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using pool_type = segment_pool<T, SegmentSize, PoolSegments>;
+
+    /// @section Member functions
+
+    /**
+     * Pool shared by all vectors of this type constructed without one, of
+     * `PoolSegments` segments in total.
+     */
+    static pool_type& default_pool() {
+        static pool_type pool;
+        return pool;
+    }
+
+    /**
+     * @name (constructor)
+     */
+    ///{
+    segmented_vector() : segmented_vector(default_pool()) {}
+
+    explicit segmented_vector(pool_type& pool) noexcept : m_pool(&pool) {}
+
+    segmented_vector(std::initializer_list<T> ilist)
+        : segmented_vector() {
+        construct(ilist.begin(), ilist.end());
+    }
+
+    segmented_vector(const segmented_vector& other)
+        : m_pool(other.m_pool) {
+        construct(other.cbegin(), other.cend());
+    }
+
+    /// Takes over segments of `other`, which is left empty
+    segmented_vector(segmented_vector&& other) noexcept
+        : m_pool(other.m_pool) {
+        steal(other);
+    }
+    ///}
+
+    ~segmented_vector() {
+        clear();
+        shrink_to_fit();
+    }
+
+    /**
+     * @name operator=
+     */
+    ///{
+    segmented_vector& operator=(const segmented_vector& other) {
+        if (this != &other) {
+            assign(other.cbegin(), other.cend());
+        }
+        return *this;
+    }
+
+    /**
+     * Takes over segments of `other` if both use the same pool, otherwise
+     * moves elements.
+     */
+    segmented_vector& operator=(segmented_vector&& other) {
+        if (this == &other) {
+            return *this;
+        }
+        if (m_pool == other.m_pool) {
+            clear();
+            shrink_to_fit();
+            steal(other);
+        } else {
+            assign(std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()));
+            other.clear();
+        }
+        return *this;
+    }
+    ///}
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    /// @subsection Element access
+
+    /**
+     * @name at
+     */
+    ///{
+    reference at(size_type pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("rttl::segmented_vector");
+        }
+        return (*this)[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("rttl::segmented_vector");
+        }
+        return (*this)[pos];
+    }
+    ///}
+
+    /**
+     * @name operator[]
+     */
+    ///{
+    reference operator[](size_type pos) noexcept {
+        return m_segments[pos >> shift][pos & mask];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return m_segments[pos >> shift][pos & mask];
+    }
+    ///}
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[size() - 1];
+    }
+
+    const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    /// @subsection Iterators
+
+    iterator begin() noexcept {
+        return iterator(m_segments.data(), 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return const_iterator(m_segments.data(), 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(m_segments.data(), size());
+    }
+
+    const_iterator end() const noexcept {
+        return cend();
+    }
+
+    const_iterator cend() const noexcept {
+        return const_iterator(m_segments.data(), size());
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(cend());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(cbegin());
+    }
+
+    /**
+     * @name for_each_segment
+     *
+     * Calls `f(first, count)` for every contiguous run of elements, in order.
+     */
+    ///{
+    template <typename Function>
+    void for_each_segment(Function f) {
+        for (size_type pos = 0; pos < size(); pos += SegmentSize) {
+            f(m_segments[pos >> shift], std::min(SegmentSize, size() - pos));
+        }
+    }
+
+    template <typename Function>
+    void for_each_segment(Function f) const {
+        for (size_type pos = 0; pos < size(); pos += SegmentSize) {
+            f(static_cast<const T*>(m_segments[pos >> shift]),
+              std::min(SegmentSize, size() - pos));
+        }
+    }
+    ///}
+
+    /// @subsection Capacity
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_length == 0;
+    }
+
+    size_type size() const noexcept {
+        return m_length;
+    }
+
+    /**
+     * Bound of the segment table; fewer elements fit if the pool is shared
+     * with other vectors.
+     */
+    static constexpr size_type max_size() noexcept {
+        return SegmentSize * MaxSegments;
+    }
+
+    /**
+     * Number of elements that fit in segments held.
+     */
+    size_type capacity() const noexcept {
+        return m_segment_count * SegmentSize;
+    }
+
+    /**
+     * Acquires segments for `count` elements; throws `std::length_error` if
+     * `count > max_size()` or the pool is exhausted.
+     */
+    void reserve(size_type count) {
+        if (count > max_size()) {
+            throw std::length_error("rttl::segmented_vector");
+        }
+        while (capacity() < count) {
+            m_segments[m_segment_count] = m_pool->acquire();
+            ++m_segment_count;
+        }
+    }
+
+    /**
+     * Returns segments not holding elements to the pool.
+     */
+    void shrink_to_fit() noexcept {
+        while (m_segment_count > (m_length + mask) / SegmentSize) {
+            --m_segment_count;
+            m_pool->release(m_segments[m_segment_count]);
+            m_segments[m_segment_count] = nullptr;
+        }
+    }
+
+    pool_type& pool() const noexcept {
+        return *m_pool;
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Destroys all elements, keeping segments.
+     */
+    void clear() noexcept {
+        while (!empty()) {
+            --m_length;
+            (*this)[m_length].~T();
+        }
+    }
+
+    /**
+     * @name push_back
+     */
+    ///{
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+    ///}
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (m_length == capacity()) {
+            reserve(m_length + 1);
+        }
+        T* p = &(*this)[m_length];
+        ::new(static_cast<void*>(p)) T(std::forward<Args>(args)...);
+        ++m_length;
+        return *p;
+    }
+
+    void pop_back() {
+        if (empty()) {
+            throw std::invalid_argument("rttl::segmented_vector");
+        }
+        --m_length;
+        (*this)[m_length].~T();
+    }
+
+    /**
+     * @name resize
+     */
+    ///{
+    void resize(size_type count) {
+        reserve(count);
+        while (m_length < count) {
+            emplace_back();
+        }
+        while (m_length > count) {
+            pop_back();
+        }
+    }
+
+    void resize(size_type count, const value_type& value) {
+        reserve(count);
+        while (m_length < count) {
+            emplace_back(value);
+        }
+        while (m_length > count) {
+            pop_back();
+        }
+    }
+    ///}
+
+    /**
+     * Exchanges contents in `O(MaxSegments)`, without moving elements; the
+     * vectors exchange their pools as well.
+     */
+    void swap(segmented_vector& other) noexcept {
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_segment_count, other.m_segment_count);
+        std::swap(m_length, other.m_length);
+        std::swap(m_pool, other.m_pool);
+    }
+
+private:
+    /// Assignment on construction, releasing segments if it throws
+    template <typename InputIt>
+    void construct(InputIt first, InputIt last) {
+        try {
+            assign(first, last);
+        } catch (...) {
+            clear();
+            shrink_to_fit();
+            throw;
+        }
+    }
+
+    void steal(segmented_vector& other) noexcept {
+        m_segments = other.m_segments;
+        m_segment_count = other.m_segment_count;
+        m_length = other.m_length;
+        other.m_segments = {};
+        other.m_segment_count = 0;
+        other.m_length = 0;
+    }
+
+    std::array<T*, MaxSegments> m_segments = {};
+    size_type m_segment_count = 0;
+    size_type m_length = 0;
+    pool_type* m_pool;
+
+};
+
+template <typename T, std::size_t SegmentSize, std::size_t MaxSegments,
+          std::size_t PoolSegments>
+void swap(segmented_vector<T, SegmentSize, MaxSegments, PoolSegments>& lhs,
+          segmented_vector<T, SegmentSize, MaxSegments, PoolSegments>& rhs)
+          noexcept {
+    lhs.swap(rhs);
+}
+
+}
+
+#endif // RTTL_SEGMENTED_VECTOR_H_
@@ -0,0 +1,21 @@
+/**
+ * @file rttl/simd.h
+ *
+ * Detection of SIMD instruction sets used by rttl.
+ *
+ * `RTTL_HAS_SSE2` is `1` where SSE2 intrinsics of `<emmintrin.h>` may be
+ * used, i.e. on x86-64 and on x86 compiled with SSE2 enabled, `0` otherwise.
+ * Code using them must also provide a portable path.
+ *
+ */
+#ifndef RTTL_SIMD_H_
+#define RTTL_SIMD_H_
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RTTL_HAS_SSE2 1
+#else
+#define RTTL_HAS_SSE2 0
+#endif
+
+#endif // RTTL_SIMD_H_
@@ -0,0 +1,374 @@
+/**
+ * @file rttl/sketch.h
+ *
+ * Probabilistic sketches with statically allocated storage, for distinct
+ * counts and heavy hitters over unbounded streams of keys.
+ *
+ * Keys are `rttl::basic_string`, `std::string_view` or arithmetic values,
+ * hashed once into 64 bits by `rttl::sketch_hash`; every structure also takes
+ * precomputed hashes, so a key hashed once may update several sketches:
+ *  - `rttl::hyperloglog<Precision>` estimates the number of distinct keys
+ *    with `2^Precision` registers of one byte and a relative standard error
+ *    of about `1.04 / sqrt(2^Precision)`; small cardinalities are estimated
+ *    by linear counting;
+ *  - `rttl::count_min<Width, Depth, Counter>` estimates how often a key has
+ *    been added with `Depth` rows of `Width` counters: estimates are never
+ *    below true counts, and exceed them by more than `e / Width` times the
+ *    total count with probability at most `exp(-Depth)`; row positions are
+ *    derived from the single hash by double hashing;
+ *  - `rttl::heavy_hitters<Key, K, Width, Depth>` combines a Count-Min sketch
+ *    with a list of `K` keys of the largest estimates seen;
+ *  - sketches of the same parameters are merged with `merge`, so threads may
+ *    update sketches of their own to be combined by a reader; a single
+ *    sketch is not thread-safe.
+ *
+ * Important note: Count-Min counters take `Width * Depth * sizeof(Counter)`
+ * bytes, which may be too large for the stack.
+ *
+ */
+#ifndef RTTL_SKETCH_H_
+#define RTTL_SKETCH_H_
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include "rttl/bit.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+
+namespace rttl {
+
+namespace detail {
+
+constexpr std::uint64_t sketch_seed = 0x9e3779b97f4a7c15;
+
+/// Finalizer of MurmurHash3, a bijective mix of 64 bits
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+    return x;
+}
+
+}
+
+/**
+ * @name sketch_hash
+ *
+ * 64-bit hash of a key of sketches; strings are hashed by contents, equal
+ * to that of `std::string_view` of the same characters, arithmetic values by
+ * their object representation.
+ */
+///{
+inline std::uint64_t sketch_hash(std::string_view key) noexcept {
+    return detail::hash_bytes(key.data(), key.size(), detail::sketch_seed);
+}
+
+template <std::size_t MaxLength, typename Traits>
+std::uint64_t sketch_hash(const basic_string<MaxLength, char, Traits>& key) noexcept {
+    return detail::hash_bytes(key.data(), key.size(), detail::sketch_seed);
+}
+
+template <typename T>
+std::enable_if_t<std::is_arithmetic<T>::value, std::uint64_t>
+sketch_hash(T key) noexcept {
+    static_assert(sizeof(T) <= 8, "Arithmetic keys of up to 64 bits are supported");
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &key, sizeof(T));
+    return detail::mix64(bits ^ detail::sketch_seed);
+}
+///}
+
+template <unsigned Precision>
+class hyperloglog {
+    static_assert(Precision >= 4 && Precision <= 18,
+                  "Precision must be within 4 to 18");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+
+    static constexpr size_type register_count = size_type(1) << Precision;
+
+    /// @section Member functions
+
+    hyperloglog() noexcept = default;
+
+    /// @subsection Modifiers
+
+    template <typename Key>
+    void add(const Key& key) noexcept {
+        add_hash(sketch_hash(key));
+    }
+
+    /**
+     * Adds a key by its `sketch_hash`.
+     */
+    void add_hash(std::uint64_t hash) noexcept {
+        size_type index = hash >> (64 - Precision);
+        /// Rank of the first one bit of the remaining bits, bounded by a
+        /// sentinel bit
+        std::uint64_t rest = (hash << Precision) |
+                             (std::uint64_t(1) << (Precision - 1));
+        auto rank = static_cast<std::uint8_t>(countl_zero(rest) + 1);
+        m_registers[index] = std::max(m_registers[index], rank);
+    }
+
+    /**
+     * Adds keys added to `other`.
+     */
+    void merge(const hyperloglog& other) noexcept {
+        for (size_type i = 0; i < register_count; ++i) {
+            m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+        }
+    }
+
+    void clear() noexcept {
+        m_registers.fill(0);
+    }
+
+    /// @subsection Queries
+
+    /**
+     * Estimated number of distinct keys added.
+     */
+    double estimate() const noexcept {
+        constexpr auto m = static_cast<double>(register_count);
+        double sum = 0;
+        size_type zeros = 0;
+        for (std::uint8_t r : m_registers) {
+            sum += std::ldexp(1.0, -r);
+            zeros += (r == 0) ? 1 : 0;
+        }
+        double raw = alpha() * m * m / sum;
+        if (raw <= 2.5 * m && zeros > 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+
+    const std::array<std::uint8_t, register_count>& registers() const noexcept {
+        return m_registers;
+    }
+
+private:
+    static constexpr double alpha() noexcept {
+        switch (Precision) {
+        case 4:
+            return 0.673;
+        case 5:
+            return 0.697;
+        case 6:
+            return 0.709;
+        default:
+            return 0.7213 / (1.0 + 1.079 / static_cast<double>(register_count));
+        }
+    }
+
+    std::array<std::uint8_t, register_count> m_registers = {};
+
+};
+
+template <std::size_t Width, std::size_t Depth, typename Counter = std::uint32_t>
+class count_min {
+    static_assert(Width > 0 && Depth > 0, "Empty sketches are not allowed");
+    static_assert(Width <= 0xFFFFFFFFu, "Width must fit in 32 bits");
+    static_assert(std::is_unsigned<Counter>::value, "Counter must be unsigned");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+    using counter_type = Counter;
+
+    static constexpr size_type width = Width;
+    static constexpr size_type depth = Depth;
+
+    /// @section Member functions
+
+    count_min() noexcept = default;
+
+    /// @subsection Modifiers
+
+    template <typename Key>
+    void add(const Key& key, Counter count = 1) noexcept {
+        add_hash(sketch_hash(key), count);
+    }
+
+    void add_hash(std::uint64_t hash, Counter count = 1) noexcept {
+        for (size_type row = 0; row < Depth; ++row) {
+            m_counters[position(hash, row)] += count;
+        }
+        m_total += count;
+    }
+
+    /**
+     * Adds counts of `other`.
+     */
+    void merge(const count_min& other) noexcept {
+        for (size_type i = 0; i < m_counters.size(); ++i) {
+            m_counters[i] += other.m_counters[i];
+        }
+        m_total += other.m_total;
+    }
+
+    void clear() noexcept {
+        m_counters.fill(0);
+        m_total = 0;
+    }
+
+    /// @subsection Queries
+
+    template <typename Key>
+    Counter estimate(const Key& key) const noexcept {
+        return estimate_hash(sketch_hash(key));
+    }
+
+    Counter estimate_hash(std::uint64_t hash) const noexcept {
+        Counter result = m_counters[position(hash, 0)];
+        for (size_type row = 1; row < Depth; ++row) {
+            result = std::min(result, m_counters[position(hash, row)]);
+        }
+        return result;
+    }
+
+    /**
+     * Sum of all counts added.
+     */
+    Counter total() const noexcept {
+        return m_total;
+    }
+
+private:
+    /// Counter of `hash` in `row`: `h1 + row * h2` scaled to the width
+    static size_type position(std::uint64_t hash, size_type row) noexcept {
+        auto h1 = static_cast<std::uint32_t>(hash);
+        auto h2 = static_cast<std::uint32_t>(hash >> 32) | 1;
+        std::uint32_t x = h1 + static_cast<std::uint32_t>(row) * h2;
+        return row * Width + ((std::uint64_t(x) * Width) >> 32);
+    }
+
+    std::array<Counter, Width * Depth> m_counters = {};
+    Counter m_total = 0;
+
+};
+
+template <typename Key, std::size_t K, std::size_t Width, std::size_t Depth,
+          typename Counter = std::uint32_t>
+class heavy_hitters {
+    static_assert(K > 0, "K must be positive");
+public:
+
+    /// @section Member types
+
+    using size_type = std::size_t;
+    using sketch_type = count_min<Width, Depth, Counter>;
+
+    struct entry {
+        Key key;
+        Counter count;
+    };
+
+    /// @section Member functions
+
+    heavy_hitters() = default;
+
+    /// @subsection Modifiers
+
+    /**
+     * Counts `key` and keeps it if its estimate is among the `K` largest.
+     */
+    void add(const Key& key, Counter count = 1) {
+        std::uint64_t hash = sketch_hash(key);
+        m_sketch.add_hash(hash, count);
+        offer(key, m_sketch.estimate_hash(hash));
+    }
+
+    /**
+     * Adds counts of `other` and keeps the keys of both with the `K` largest
+     * estimates of the merged sketch.
+     */
+    void merge(const heavy_hitters& other) {
+        m_sketch.merge(other.m_sketch);
+        std::array<entry, 2 * K> candidates;
+        size_type n = 0;
+        for (size_type i = 0; i < m_size; ++i) {
+            candidates[n++] = m_top[i];
+        }
+        for (size_type i = 0; i < other.m_size; ++i) {
+            const Key& key = other.m_top[i].key;
+            if (std::none_of(candidates.begin(), candidates.begin() + m_size,
+                             [&key](const entry& e) { return e.key == key; })) {
+                candidates[n++] = other.m_top[i];
+            }
+        }
+        for (size_type i = 0; i < n; ++i) {
+            candidates[i].count = m_sketch.estimate(candidates[i].key);
+        }
+        m_size = std::min(n, K);
+        std::partial_sort(candidates.begin(), candidates.begin() + m_size,
+                          candidates.begin() + n, by_count);
+        std::copy_n(candidates.begin(), m_size, m_top.begin());
+    }
+
+    void clear() noexcept {
+        m_sketch.clear();
+        m_size = 0;
+    }
+
+    /// @subsection Queries
+
+    /**
+     * Replaces contents of `out` with keys of the largest estimates, in
+     * descending order of estimates.
+     */
+    template <std::size_t MaxSize>
+    void top(vector<entry, MaxSize>& out) const {
+        static_assert(MaxSize >= K, "Output must hold K entries");
+        out.assign(m_top.begin(), m_top.begin() + m_size);
+        std::sort(out.begin(), out.end(), by_count);
+    }
+
+    const sketch_type& sketch() const noexcept {
+        return m_sketch;
+    }
+
+private:
+    static bool by_count(const entry& lhs, const entry& rhs) noexcept {
+        return lhs.count > rhs.count;
+    }
+
+    void offer(const Key& key, Counter estimate) {
+        for (size_type i = 0; i < m_size; ++i) {
+            if (m_top[i].key == key) {
+                m_top[i].count = estimate;
+                return;
+            }
+        }
+        if (m_size < K) {
+            m_top[m_size++] = entry{ key, estimate };
+            return;
+        }
+        auto min = std::min_element(m_top.begin(), m_top.end(),
+            [](const entry& lhs, const entry& rhs) { return lhs.count < rhs.count; });
+        if (estimate > min->count) {
+            *min = entry{ key, estimate };
+        }
+    }
+
+    sketch_type m_sketch;
+    std::array<entry, K> m_top;
+    size_type m_size = 0;
+
+};
+
+}
+
+#endif // RTTL_SKETCH_H_
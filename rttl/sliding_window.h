@@ -0,0 +1,430 @@
+/**
+ * @file rttl/sliding_window.h
+ *
+ * Rolling aggregates over the last samples with statically allocated storage.
+ *
+ * `rttl::sliding_window<T, N, Ops...>` keeps the last `N` pushed samples in a
+ * ring within the class and maintains the aggregates selected by `Ops`:
+ *  - `rttl::window_min`, `rttl::window_max` - monotonic deque of positions in
+ *    the ring, also stored within the class; `push` is amortized `O(1)`,
+ *    query is `O(1)`;
+ *  - `rttl::window_sum` - running sum, `O(1)` push and query; for floating
+ *    point samples rounding errors accumulate over the lifetime of the window;
+ *  - `rttl::window_kahan_sum` - running sum with Kahan compensation, for
+ *    floating point samples only;
+ *  - `mean()` is available when either of the sums is selected.
+ *
+ * `rttl::timed_sliding_window<T, N, TimePoint, Ops...>` keeps samples not
+ * older than a given time span instead, `N` being the maximum number of
+ * samples within the span; pushing into the full window throws an exception
+ * rather than losing a sample that is still within the span.
+ *
+ * Important note: Be careful with placing windows with large `N` on the stack.
+ *
+ */
+#ifndef RTTL_SLIDING_WINDOW_H_
+#define RTTL_SLIDING_WINDOW_H_
+#include <cstdlib>
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rttl {
+
+/// @section Aggregates
+
+struct window_min {};
+struct window_max {};
+struct window_sum {};
+struct window_kahan_sum {};
+
+
+namespace detail {
+
+/**
+ * Positions of samples in the ring, whose values are monotonic with respect to
+ * `Compare`; the front is the extreme of the window.
+ */
+template <typename T, std::size_t N, typename Compare>
+class monotonic_deque {
+public:
+    void push(const T* samples, std::size_t pos) {
+        while (m_size > 0 && !Compare()(samples[m_index[back_index()]],
+                                        samples[pos])) {
+            --m_size;
+        }
+        ++m_size;
+        m_index[back_index()] = pos;
+    }
+
+    void evict(const T*, std::size_t pos) noexcept {
+        if (m_size > 0 && m_index[m_head] == pos) {
+            m_head = (m_head + 1 == N) ? 0 : m_head + 1;
+            --m_size;
+        }
+    }
+
+    void clear() noexcept {
+        m_head = 0;
+        m_size = 0;
+    }
+
+    const T& value(const T* samples) const noexcept {
+        return samples[m_index[m_head]];
+    }
+
+private:
+    std::size_t back_index() const noexcept {
+        std::size_t i = m_head + m_size - 1;
+        return (i >= N) ? i - N : i;
+    }
+
+    std::array<std::size_t, N> m_index;
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+
+};
+
+template <typename Op, typename T, std::size_t N>
+class window_op;
+
+template <typename T, std::size_t N>
+class window_op<window_min, T, N> : public monotonic_deque<T, N, std::less<T>> {
+};
+
+template <typename T, std::size_t N>
+class window_op<window_max, T, N>
+    : public monotonic_deque<T, N, std::greater<T>> {
+};
+
+template <typename T, std::size_t N>
+class window_op<window_sum, T, N> {
+public:
+    void push(const T* samples, std::size_t pos) noexcept {
+        m_sum += samples[pos];
+    }
+
+    void evict(const T* samples, std::size_t pos) noexcept {
+        m_sum -= samples[pos];
+    }
+
+    void clear() noexcept {
+        m_sum = T();
+    }
+
+    T value(const T*) const noexcept {
+        return m_sum;
+    }
+
+private:
+    T m_sum = T();
+
+};
+
+template <typename T, std::size_t N>
+class window_op<window_kahan_sum, T, N> {
+    static_assert(std::is_floating_point<T>::value,
+                  "Kahan summation applies to floating point samples only");
+public:
+    void push(const T* samples, std::size_t pos) noexcept {
+        add(samples[pos]);
+    }
+
+    void evict(const T* samples, std::size_t pos) noexcept {
+        add(-samples[pos]);
+    }
+
+    void clear() noexcept {
+        m_sum = T();
+        m_compensation = T();
+    }
+
+    T value(const T*) const noexcept {
+        return m_sum;
+    }
+
+private:
+    void add(T x) noexcept {
+        T y = x - m_compensation;
+        T t = m_sum + y;
+        m_compensation = (t - m_sum) - y;
+        m_sum = t;
+    }
+
+    T m_sum = T();
+    T m_compensation = T();
+
+};
+
+}
+
+
+template <typename T, std::size_t N, typename... Ops>
+class sliding_window : private detail::window_op<Ops, T, N>... {
+    static_assert(N > 0, "Empty windows are not allowed");
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using mean_type = typename std::conditional<
+                      std::is_floating_point<T>::value, T, double>::type;
+
+    /// @section Member functions
+
+    /// @subsection Element access
+
+    /**
+     * Returns `pos`-th sample counting from the oldest one.
+     */
+    const_reference operator[](size_type pos) const noexcept {
+        return m_data[ring_index(pos)];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("rttl::sliding_window");
+        }
+        return this->operator[](pos);
+    }
+
+    /**
+     * @name front, back
+     *
+     * The oldest and the newest samples respectively.
+     */
+    ///{
+    const_reference front() const noexcept {
+        return m_data[m_head];
+    }
+
+    const_reference back() const noexcept {
+        return m_data[ring_index(m_size - 1)];
+    }
+    ///}
+
+    /// @subsection Capacity
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    bool full() const noexcept {
+        return m_size == N;
+    }
+
+    size_type size() const noexcept {
+        return m_size;
+    }
+
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Adds a sample, evicting the oldest one when the window is full.
+     */
+    void push(const T& value) {
+        if (full()) {
+            pop();
+        }
+        size_type pos = ring_index(m_size);
+        m_data[pos] = value;
+        ++m_size;
+        (static_cast<detail::window_op<Ops, T, N>&>(*this).push(m_data.data(),
+                                                                pos), ...);
+    }
+
+    /**
+     * Removes the oldest sample; throws when called on empty window.
+     */
+    void pop() {
+        if (empty()) {
+            throw std::invalid_argument("rttl::sliding_window");
+        }
+        (static_cast<detail::window_op<Ops, T, N>&>(*this).evict(m_data.data(),
+                                                                 m_head), ...);
+        m_head = (m_head + 1 == N) ? 0 : m_head + 1;
+        --m_size;
+    }
+
+    void clear() noexcept {
+        (static_cast<detail::window_op<Ops, T, N>&>(*this).clear(), ...);
+        m_head = 0;
+        m_size = 0;
+    }
+
+    /// @subsection Aggregates
+
+    const_reference min() const noexcept {
+        static_assert(has_op<window_min>(), "window_min is not selected");
+        return op<window_min>().value(m_data.data());
+    }
+
+    const_reference max() const noexcept {
+        static_assert(has_op<window_max>(), "window_max is not selected");
+        return op<window_max>().value(m_data.data());
+    }
+
+    T sum() const noexcept {
+        static_assert(has_op<window_sum>() != has_op<window_kahan_sum>(),
+                      "Exactly one of window_sum and window_kahan_sum must be "
+                      "selected");
+        if constexpr(has_op<window_sum>()) {
+            return op<window_sum>().value(m_data.data());
+        } else {
+            return op<window_kahan_sum>().value(m_data.data());
+        }
+    }
+
+    mean_type mean() const noexcept {
+        return static_cast<mean_type>(sum()) / static_cast<mean_type>(size());
+    }
+
+private:
+    template <typename Op>
+    static constexpr bool has_op() noexcept {
+        return (std::is_same<Op, Ops>::value || ...);
+    }
+
+    template <typename Op>
+    const detail::window_op<Op, T, N>& op() const noexcept {
+        return static_cast<const detail::window_op<Op, T, N>&>(*this);
+    }
+
+    size_type ring_index(size_type pos) const noexcept {
+        size_type i = m_head + pos;
+        return (i >= N) ? i - N : i;
+    }
+
+    std::array<T, N> m_data;
+    size_type m_head = 0;
+    size_type m_size = 0;
+
+};
+
+
+template <typename T, std::size_t N, typename TimePoint, typename... Ops>
+class timed_sliding_window {
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_reference = const value_type&;
+    using time_point = TimePoint;
+    using duration = decltype(std::declval<TimePoint>() -
+                              std::declval<TimePoint>());
+    using mean_type = typename sliding_window<T, N, Ops...>::mean_type;
+
+    /// @section Member functions
+
+    /**
+     * Constructs empty window keeping samples for `span`.
+     */
+    explicit timed_sliding_window(duration span) noexcept : m_span(span) {}
+
+    /// @subsection Element access
+
+    const_reference operator[](size_type pos) const noexcept {
+        return m_window[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        return m_window.at(pos);
+    }
+
+    /**
+     * Returns the time stamp of `pos`-th sample counting from the oldest one.
+     */
+    const time_point& time(size_type pos) const noexcept {
+        size_type i = m_head + pos;
+        return m_times[(i >= N) ? i - N : i];
+    }
+
+    /// @subsection Capacity
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_window.empty();
+    }
+
+    size_type size() const noexcept {
+        return m_window.size();
+    }
+
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+    duration span() const noexcept {
+        return m_span;
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Evicts samples that are older than `span()` at `now`, then adds a
+     * sample; time stamps must not decrease. Throws if the window is still
+     * full after eviction.
+     */
+    void push(const time_point& now, const T& value) {
+        expire(now);
+        if (m_window.full()) {
+            throw std::length_error("rttl::timed_sliding_window");
+        }
+        size_type i = m_head + m_window.size();
+        m_times[(i >= N) ? i - N : i] = now;
+        m_window.push(value);
+    }
+
+    /**
+     * Evicts samples that are older than `span()` at `now`.
+     */
+    void expire(const time_point& now) {
+        while (!m_window.empty() && !(now - m_times[m_head] < m_span)) {
+            m_window.pop();
+            m_head = (m_head + 1 == N) ? 0 : m_head + 1;
+        }
+    }
+
+    void clear() noexcept {
+        m_window.clear();
+        m_head = 0;
+    }
+
+    /// @subsection Aggregates
+
+    const_reference min() const noexcept {
+        return m_window.min();
+    }
+
+    const_reference max() const noexcept {
+        return m_window.max();
+    }
+
+    T sum() const noexcept {
+        return m_window.sum();
+    }
+
+    mean_type mean() const noexcept {
+        return m_window.mean();
+    }
+
+private:
+    sliding_window<T, N, Ops...> m_window;
+    std::array<time_point, N> m_times;
+    size_type m_head = 0;
+    duration m_span;
+
+};
+
+}
+
+#endif // RTTL_SLIDING_WINDOW_H_
@@ -0,0 +1,287 @@
+/**
+ * @file rttl/static_slot.h
+ *
+ * Storage with static duration for objects constructed explicitly, meant for
+ * large rttl containers that must not be placed on the stack.
+ *
+ * `rttl::static_slot<T>` holds correctly aligned storage for one `T` within
+ * the class, like `std::optional<T>`, with following differences:
+ *  - the constructor is `constexpr` and does not construct `T`, so a slot
+ *    defined at namespace scope is constant-initialized: there is neither a
+ *    guard check on access, as with function-local statics, nor a dependency
+ *    on the order of dynamic initialization, as with globals of type `T`;
+ *  - `T` is constructed with `emplace` and destroyed with `reset` or by the
+ *    destructor of the slot, at the time the program chooses;
+ *  - `operator*`, `operator->` and `get` do not check that the object exists;
+ *    `value` does and throws otherwise.
+ *
+ * Slots may be registered, e.g. next to their definitions, with an order key
+ * and optionally an initialization function; `construct_registered_slots`
+ * constructs all of them in ascending order of keys, registration order among
+ * equal keys, and `destroy_registered_slots` destroys them in the reverse
+ * order. The registry holds up to `max_registered_slots` slots and does not
+ * allocate; it is not thread-safe, being meant for program startup and
+ * shutdown.
+ *
+ * A slot is a container in terms of `rttl::memory`, so its storage may be
+ * prefaulted and locked before the object is constructed.
+ *
+ */
+#ifndef RTTL_STATIC_SLOT_H_
+#define RTTL_STATIC_SLOT_H_
+#include <cstdlib>
+#include <array>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rttl {
+
+/// Maximal number of registered slots
+constexpr std::size_t max_registered_slots = 256;
+
+template <typename T>
+class static_slot {
+    static_assert(std::is_object<T>::value && !std::is_array<T>::value,
+                  "T must be a non-array object type");
+public:
+
+    /// @section Member types
+
+    using value_type = T;
+    /// Function that constructs the object of a registered slot
+    using initializer = void (*)(static_slot&);
+
+    /// @section Member functions
+
+    constexpr static_slot() noexcept : m_empty() {}
+    static_slot(const static_slot&) = delete;
+    static_slot& operator=(const static_slot&) = delete;
+
+    ~static_slot() {
+        reset();
+    }
+
+    /// @subsection Observers
+
+    bool has_value() const noexcept {
+        return m_constructed;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_constructed;
+    }
+
+    /**
+     * @name operator*
+     *
+     * The object, which must have been constructed.
+     */
+    ///{
+    T& operator*() noexcept {
+        return *get();
+    }
+
+    const T& operator*() const noexcept {
+        return *get();
+    }
+    ///}
+
+    T* operator->() noexcept {
+        return get();
+    }
+
+    const T* operator->() const noexcept {
+        return get();
+    }
+
+    T* get() noexcept {
+        return &m_value;
+    }
+
+    const T* get() const noexcept {
+        return &m_value;
+    }
+
+    /**
+     * @name value
+     *
+     * The object; throws `std::invalid_argument` if it is not constructed.
+     */
+    ///{
+    T& value() {
+        check();
+        return *get();
+    }
+
+    const T& value() const {
+        check();
+        return *get();
+    }
+    ///}
+
+    /// @subsection Modifiers
+
+    /**
+     * Constructs the object from `args`, destroying the existing one first.
+     */
+    template <typename... Args>
+    T& emplace(Args&&... args) {
+        reset();
+        ::new(static_cast<void*>(&m_value)) T(std::forward<Args>(args)...);
+        m_constructed = true;
+        return *get();
+    }
+
+    /**
+     * Destroys the object, if constructed.
+     */
+    void reset() noexcept {
+        if (m_constructed) {
+            m_constructed = false;
+            get()->~T();
+        }
+    }
+
+private:
+    void check() const {
+        if (!m_constructed) {
+            throw std::invalid_argument("rttl::static_slot");
+        }
+    }
+
+    /// Storage of the object, initialized without constructing it
+    union {
+        char m_empty;
+        T m_value;
+    };
+    bool m_constructed = false;
+
+};
+
+namespace detail {
+
+struct slot_entry {
+    void* slot;
+    int order;
+    /// Type-erased `static_slot<T>::initializer`, if given
+    void (*init)();
+    void (*construct)(const slot_entry&);
+    void (*destroy)(void*);
+};
+
+struct slot_registry {
+    std::array<slot_entry, max_registered_slots> slots;
+    std::size_t count = 0;
+};
+
+inline slot_registry& global_slot_registry() noexcept {
+    static slot_registry instance;
+    return instance;
+}
+
+template <typename T>
+void construct_slot(const slot_entry& e) {
+    auto& slot = *static_cast<static_slot<T>*>(e.slot);
+    if (!slot.has_value()) {
+        slot.emplace();
+    }
+}
+
+template <typename T>
+void initialize_slot(const slot_entry& e) {
+    auto& slot = *static_cast<static_slot<T>*>(e.slot);
+    if (!slot.has_value()) {
+        reinterpret_cast<typename static_slot<T>::initializer>(e.init)(slot);
+    }
+}
+
+template <typename T>
+void destroy_slot(void* slot) {
+    static_cast<static_slot<T>*>(slot)->reset();
+}
+
+inline void register_slot(const slot_entry& e) {
+    auto& r = global_slot_registry();
+    if (r.count == max_registered_slots) {
+        throw std::length_error("rttl::register_slot");
+    }
+    /// Keeps entries sorted by order, stable for equal keys
+    std::size_t pos = r.count;
+    for (; pos > 0 && r.slots[pos - 1].order > e.order; --pos) {
+        r.slots[pos] = r.slots[pos - 1];
+    }
+    r.slots[pos] = e;
+    ++r.count;
+}
+
+}
+
+/**
+ * @name register_slot
+ *
+ * Registers a slot to be constructed with order key `order`, either by
+ * default construction or by `init(slot)`, which must `emplace` the object;
+ * throws if `max_registered_slots` slots are already registered.
+ */
+///{
+template <typename T>
+void register_slot(static_slot<T>& slot, int order = 0) {
+    detail::register_slot({ &slot, order, nullptr,
+                            &detail::construct_slot<T>,
+                            &detail::destroy_slot<T> });
+}
+
+template <typename T>
+void register_slot(static_slot<T>& slot, int order,
+                   typename static_slot<T>::initializer init) {
+    detail::register_slot({ &slot, order, reinterpret_cast<void (*)()>(init),
+                            &detail::initialize_slot<T>,
+                            &detail::destroy_slot<T> });
+}
+///}
+
+/**
+ * Removes all registrations of a slot.
+ */
+template <typename T>
+void unregister_slot(const static_slot<T>& slot) noexcept {
+    auto& r = detail::global_slot_registry();
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < r.count; ++i) {
+        if (r.slots[i].slot != &slot) {
+            r.slots[n++] = r.slots[i];
+        }
+    }
+    r.count = n;
+}
+
+inline std::size_t registered_slot_count() noexcept {
+    return detail::global_slot_registry().count;
+}
+
+/**
+ * Constructs registered slots that are not constructed yet, in ascending
+ * order of keys; if a construction throws, slots constructed before stay so.
+ */
+inline void construct_registered_slots() {
+    auto& r = detail::global_slot_registry();
+    for (std::size_t i = 0; i < r.count; ++i) {
+        r.slots[i].construct(r.slots[i]);
+    }
+}
+
+/**
+ * Destroys registered slots in descending order of keys.
+ */
+inline void destroy_registered_slots() noexcept {
+    auto& r = detail::global_slot_registry();
+    for (std::size_t i = r.count; i > 0; --i) {
+        r.slots[i - 1].destroy(r.slots[i - 1].slot);
+    }
+}
+
+}
+
+#endif // RTTL_STATIC_SLOT_H_
@@ -28,8 +28,11 @@
 #include <algorithm>
 #include <type_traits>
 #include <iterator>
+#include <limits>
 #include <istream>
 #include <iostream>
+#include "rttl/char_traits.h"
+#include "rttl/string_search.h"
 
 #if __cplusplus < 201703L
 #error "ISO C++ 2017 or later required"
@@ -569,27 +572,27 @@ public:
 	 */
 	 ///{
 	int compare(const std::basic_string_view<CharT, Traits>& str) const noexcept {
-		return std::basic_string_view<CharT, Traits>(c_str(), length()).compare(str);
+		return fast_view(c_str(), length()).compare(fast(str));
 	}
 
 	int compare(size_type pos, size_type len, const std::basic_string_view<CharT, Traits>& str) const {
-		return std::basic_string_view<CharT, Traits>(c_str(), length()).compare(pos, len, str);
+		return fast_view(c_str(), length()).compare(pos, len, fast(str));
 	}
 
 	int compare(size_type pos, size_type len, const std::basic_string_view<CharT, Traits>& str, size_type subpos, size_type sublen = npos) const {
-		return std::basic_string_view<CharT, Traits>(*this).compare(pos, len, str, subpos, sublen);
+		return fast_view(c_str(), length()).compare(pos, len, fast(str), subpos, sublen);
 	}
 
 	int compare(const CharT* s) const {
-		return std::basic_string_view<CharT, Traits>(*this).compare(s);
+		return fast_view(c_str(), length()).compare(s);
 	}
 
 	int compare(size_type pos, size_type len, const CharT* s) const {
-		return std::basic_string_view<CharT, Traits>(*this).compare(pos, len, s);
+		return fast_view(c_str(), length()).compare(pos, len, s);
 	}
 
 	int compare(size_type pos, size_type len, const CharT* s, size_type n) const {
-		return std::basic_string_view<CharT,Traits>(*this).compare(pos, len, s, n);
+		return fast_view(c_str(), length()).compare(pos, len, s, n);
 	}
 	///}
 
@@ -782,6 +785,23 @@ public:
 	}
 	///}
 
+	/**
+	 * Replaces contents with up to `count` characters written in place by `op`, as
+	 * `std::basic_string::resize_and_overwrite` of C++23 does.
+	 *
+	 * `op(p, count)` receives pointer `p` to the storage, whose first `size()` characters
+	 * are the current contents, must write the new contents into `[p, p + n)` and return
+	 * `n <= count`. Throws if `count > max_size()`, before `op` is invoked.
+	 */
+	template<typename Operation>
+	void resize_and_overwrite(size_type count, Operation op) {
+		if (count > max_size()) {
+			throw std::length_error("rttl::basic_string");
+		}
+		m_length = op(m_data.data(), count);
+		m_data[m_length] = CharT();
+	}
+
 	/**
 	 * @name swap
 	 */
@@ -841,18 +861,27 @@ public:
 	 */
 	 ///{
 	size_type find(const std::basic_string_view<CharT, Traits>& str, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find(str, pos);
+		if constexpr (simd_search) {
+			if (pos > length()) {
+				return npos;
+			}
+			size_type result = detail::search_forward(data() + pos, length() - pos, str.data(), str.length(),
+			                                          m_data.size() - pos);
+			return (result == detail::search_npos) ? npos : result + pos;
+		} else {
+			return fast_view(data(), length()).find(fast(str), pos);
+		}
 	}
 
 	size_type find(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find(s, pos, count);
+		return find(std::basic_string_view<CharT, Traits>(s, count), pos);
 	}
 	size_type find(const CharT* s, size_type pos = 0) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find(s, pos);
+		return find(std::basic_string_view<CharT, Traits>(s), pos);
 	}
 
 	size_type find(CharT ch, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find(ch, pos);
+		return fast_view(data(), length()).find(ch, pos);
 	}
 	///}
 
@@ -862,18 +891,28 @@ public:
 	 */
 	 ///{
 	size_type rfind(const std::basic_string_view<CharT, Traits>& str, size_type pos = npos) const noexcept {
-		return std::basic_string_view<CharT,Traits>(data(), length()).rfind(str, pos);
+		if constexpr (simd_search) {
+			if (str.length() > length()) {
+				return npos;
+			}
+			/// Occurrences may start at `pos` at most
+			size_type last = std::min(pos, length() - str.length());
+			size_type result = detail::search_backward(data(), last + str.length(), str.data(), str.length());
+			return (result == detail::search_npos) ? npos : result;
+		} else {
+			return fast_view(data(), length()).rfind(fast(str), pos);
+		}
 	}
 
 	size_type rfind(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT,Traits>(data(), length()).rfind(s, pos, count);
+		return rfind(std::basic_string_view<CharT, Traits>(s, count), pos);
 	}
 	size_type rfind(const CharT* s, size_type pos = npos) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).rfind(s, pos);
+		return rfind(std::basic_string_view<CharT, Traits>(s), pos);
 	}
 
 	size_type rfind(CharT ch, size_type pos = npos) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).rfind(ch, pos);
+		return fast_view(data(), length()).rfind(ch, pos);
 	}
 	///}
 
@@ -883,18 +922,18 @@ public:
 	 */
 	 ///{
 	size_type find_first_of(const std::basic_string_view<CharT, Traits>& str, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_of(str, pos);
+		return fast_view(data(), length()).find_first_of(fast(str), pos);
 	}
 
 	size_type find_first_of(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_of(s, pos, count);
+		return fast_view(data(), length()).find_first_of(s, pos, count);
 	}
 	size_type find_first_of(const CharT* s, size_type pos = 0) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_of(s, pos);
+		return fast_view(data(), length()).find_first_of(s, pos);
 	}
 
 	size_type find_first_of(CharT ch, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_of(ch, pos);
+		return fast_view(data(), length()).find_first_of(ch, pos);
 	}
 	///}
 
@@ -904,18 +943,18 @@ public:
 	 */
 	 ///{
 	size_type find_first_not_of(const std::basic_string_view<CharT, Traits>& str, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_not_of(str, pos);
+		return fast_view(data(), length()).find_first_not_of(fast(str), pos);
 	}
 
 	size_type find_first_not_of(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_not_of(s, pos, count);
+		return fast_view(data(), length()).find_first_not_of(s, pos, count);
 	}
 	size_type find_first_not_of(const CharT* s, size_type pos = 0) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_not_of(s, pos);
+		return fast_view(data(), length()).find_first_not_of(s, pos);
 	}
 
 	size_type find_first_not_of(CharT ch, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_first_not_of(ch, pos);
+		return fast_view(data(), length()).find_first_not_of(ch, pos);
 	}
 	///}
 
@@ -925,18 +964,18 @@ public:
 	 */
 	 ///{
 	size_type find_last_of(const std::basic_string_view<CharT, Traits>& str, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_of(str, pos);
+		return fast_view(data(), length()).find_last_of(fast(str), pos);
 	}
 
 	size_type find_last_of(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_of(s, pos, count);
+		return fast_view(data(), length()).find_last_of(s, pos, count);
 	}
 	size_type find_last_of(const CharT* s, size_type pos = 0) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_of(s, pos);
+		return fast_view(data(), length()).find_last_of(s, pos);
 	}
 
 	size_type find_last_of(CharT ch, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_of(ch, pos);
+		return fast_view(data(), length()).find_last_of(ch, pos);
 	}
 	///}
 
@@ -946,23 +985,34 @@ public:
 	 */
 	 ///{
 	size_type find_last_not_of(const std::basic_string_view<CharT, Traits>& str, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_not_of(str, pos);
+		return fast_view(data(), length()).find_last_not_of(fast(str), pos);
 	}
 
 	size_type find_last_not_of(const CharT* s, size_type pos, size_type count) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_not_of(s, pos, count);
+		return fast_view(data(), length()).find_last_not_of(s, pos, count);
 	}
 	size_type find_last_not_of(const CharT* s, size_type pos = 0) const {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_not_of(s, pos);
+		return fast_view(data(), length()).find_last_not_of(s, pos);
 	}
 
 	size_type find_last_not_of(CharT ch, size_type pos = 0) const noexcept {
-		return std::basic_string_view<CharT, Traits>(data(), length()).find_last_not_of(ch, pos);
+		return fast_view(data(), length()).find_last_not_of(ch, pos);
 	}
 	///}
 
 
 private:
+	/// Substring search of `rttl/string_search.h` applies to plain `char` strings
+	static constexpr bool simd_search = std::is_same<CharT, char>::value &&
+	                                    std::is_same<Traits, std::char_traits<char>>::value;
+
+	/// View with vectorized operations of `rttl/char_traits.h`, if there are any for `Traits`
+	using fast_view = std::basic_string_view<CharT, typename detail::fast_traits<Traits>::type>;
+
+	static fast_view fast(const std::basic_string_view<CharT, Traits>& str) noexcept {
+		return fast_view(str.data(), str.length());
+	}
+
     size_type m_length = 0;
     std::array<CharT, MaxLength + 1> m_data = { 0 };    
 
@@ -0,0 +1,281 @@
+/**
+ * @file rttl/string_search.h
+ *
+ * Substring search used by `rttl::basic_string` of `char`.
+ *
+ * `rttl::detail::search_forward` and `rttl::detail::search_backward` find the
+ * first and the last occurrence of a needle in a haystack:
+ *  - where SSE2 is available, candidate positions are filtered 16 at a time by
+ *    comparing the first and the last character of the needle, and only the
+ *    candidates are compared in full;
+ *  - forward search may read up to `readable` bytes from the haystack start,
+ *    so that a string stored in a larger buffer is scanned without a scalar
+ *    tail; bytes beyond the haystack are loaded but never matched;
+ *  - once full comparisons of false candidates cost more than the scanned
+ *    length, the search continues with the Two-Way algorithm, so that the
+ *    worst case stays linear on repetitive inputs;
+ *  - without SSE2, Two-Way is used directly.
+ *
+ */
+#ifndef RTTL_STRING_SEARCH_H_
+#define RTTL_STRING_SEARCH_H_
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "rttl/bit.h"
+#include "rttl/simd.h"
+
+namespace rttl {
+
+namespace detail {
+
+constexpr std::size_t search_npos = static_cast<std::size_t>(-1);
+
+/**
+ * Start of the maximal suffix of the needle `x` of length `m` and its
+ * period, for the ordering of characters or, if `tilde`, the reverse one.
+ */
+template <typename Needle>
+std::ptrdiff_t maximal_suffix(Needle x, std::ptrdiff_t m, bool tilde,
+                              std::ptrdiff_t& period) noexcept {
+    std::ptrdiff_t ms = -1;
+    std::ptrdiff_t j = 0;
+    std::ptrdiff_t k = 1;
+    period = 1;
+    while (j + k < m) {
+        unsigned char a = x(j + k);
+        unsigned char b = x(ms + k);
+        if (tilde ? a > b : a < b) {
+            j += k;
+            k = 1;
+            period = j - ms;
+        } else if (a == b) {
+            if (k != period) {
+                ++k;
+            } else {
+                j += period;
+                k = 1;
+            }
+        } else {
+            ms = j;
+            j = ms + 1;
+            k = 1;
+            period = 1;
+        }
+    }
+    return ms;
+}
+
+/**
+ * Two-Way search of Crochemore and Perrin: position of the first occurrence
+ * of needle `x` of length `m > 0` in haystack `y` of length `n`, both given
+ * as accessors of characters by index.
+ */
+template <typename Haystack, typename Needle>
+std::size_t two_way(Haystack y, std::ptrdiff_t n, Needle x,
+                    std::ptrdiff_t m) noexcept {
+    std::ptrdiff_t p;
+    std::ptrdiff_t q;
+    std::ptrdiff_t i = maximal_suffix(x, m, false, p);
+    std::ptrdiff_t j = maximal_suffix(x, m, true, q);
+    std::ptrdiff_t ell = (i > j) ? i : j;
+    std::ptrdiff_t per = (i > j) ? p : q;
+
+    bool periodic = (ell + 1 + per <= m);
+    for (std::ptrdiff_t k = 0; periodic && k <= ell; ++k) {
+        periodic = (x(k) == x(k + per));
+    }
+
+    if (periodic) {
+        /// Memory of the prefix matched by the previous attempt
+        std::ptrdiff_t memory = -1;
+        for (j = 0; j <= n - m;) {
+            i = std::max(ell, memory) + 1;
+            while (i < m && x(i) == y(i + j)) {
+                ++i;
+            }
+            if (i >= m) {
+                i = ell;
+                while (i > memory && x(i) == y(i + j)) {
+                    --i;
+                }
+                if (i <= memory) {
+                    return static_cast<std::size_t>(j);
+                }
+                j += per;
+                memory = m - per - 1;
+            } else {
+                j += i - ell;
+                memory = -1;
+            }
+        }
+    } else {
+        per = std::max(ell + 1, m - ell - 1) + 1;
+        for (j = 0; j <= n - m;) {
+            i = ell + 1;
+            while (i < m && x(i) == y(i + j)) {
+                ++i;
+            }
+            if (i >= m) {
+                i = ell;
+                while (i >= 0 && x(i) == y(i + j)) {
+                    --i;
+                }
+                if (i < 0) {
+                    return static_cast<std::size_t>(j);
+                }
+                j += per;
+            } else {
+                j += i - ell;
+            }
+        }
+    }
+    return search_npos;
+}
+
+inline std::size_t two_way_forward(const char* hay, std::size_t n,
+                                   const char* needle, std::size_t m) noexcept {
+    auto y = [hay](std::ptrdiff_t i) {
+        return static_cast<unsigned char>(hay[i]);
+    };
+    auto x = [needle](std::ptrdiff_t i) {
+        return static_cast<unsigned char>(needle[i]);
+    };
+    return two_way(y, static_cast<std::ptrdiff_t>(n), x,
+                   static_cast<std::ptrdiff_t>(m));
+}
+
+/**
+ * Two-Way search of the reversed needle in the reversed haystack, i.e. of
+ * the last occurrence.
+ */
+inline std::size_t two_way_backward(const char* hay, std::size_t n,
+                                    const char* needle, std::size_t m) noexcept {
+    const char* hay_last = hay + n - 1;
+    const char* needle_last = needle + m - 1;
+    auto y = [hay_last](std::ptrdiff_t i) {
+        return static_cast<unsigned char>(hay_last[-i]);
+    };
+    auto x = [needle_last](std::ptrdiff_t i) {
+        return static_cast<unsigned char>(needle_last[-i]);
+    };
+    std::size_t result = two_way(y, static_cast<std::ptrdiff_t>(n), x,
+                                 static_cast<std::ptrdiff_t>(m));
+    return (result == search_npos) ? search_npos : n - m - result;
+}
+
+/**
+ * Position of the first occurrence of `needle` of length `m` in `hay` of
+ * length `n`; `readable >= n` bytes starting at `hay` may be read.
+ */
+inline std::size_t search_forward(const char* hay, std::size_t n,
+                                  const char* needle, std::size_t m,
+                                  std::size_t readable) noexcept {
+    if (m == 0) {
+        return 0;
+    }
+    if (m > n) {
+        return search_npos;
+    }
+    if (m == 1) {
+        const void* p = std::memchr(hay, needle[0], n);
+        return p ? static_cast<std::size_t>(static_cast<const char*>(p) - hay)
+                 : search_npos;
+    }
+#if RTTL_HAS_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    /// Candidates are positions `[0, end)`
+    const std::size_t end = n - m + 1;
+    std::size_t work = 0;
+    std::size_t i = 0;
+    for (; i < end && i + m + 15 <= readable; i += 16) {
+        __m128i block_first = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(hay + i));
+        __m128i block_last = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(hay + i + m - 1));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                          _mm_cmpeq_epi8(last, block_last))));
+        if (end - i < 16) {
+            mask &= (std::uint32_t(1) << (end - i)) - 1;
+        }
+        while (mask != 0) {
+            std::size_t pos = i + static_cast<std::size_t>(countr_zero(mask));
+            if (m <= 2 || std::memcmp(hay + pos + 1, needle + 1, m - 2) == 0) {
+                return pos;
+            }
+            work += m;
+            mask &= mask - 1;
+        }
+        if (work > 2 * i + 256) {
+            break;
+        }
+    }
+    if (i >= end) {
+        return search_npos;
+    }
+    std::size_t result = two_way_forward(hay + i, n - i, needle, m);
+    return (result == search_npos) ? search_npos : i + result;
+#else
+    (void)readable;
+    return two_way_forward(hay, n, needle, m);
+#endif
+}
+
+/**
+ * Position of the last occurrence of `needle` of length `m` in `hay` of
+ * length `n`.
+ */
+inline std::size_t search_backward(const char* hay, std::size_t n,
+                                   const char* needle, std::size_t m) noexcept {
+    if (m == 0) {
+        return n;
+    }
+    if (m > n) {
+        return search_npos;
+    }
+#if RTTL_HAS_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    /// Candidates are positions `[0, end)`
+    std::size_t end = n - m + 1;
+    std::size_t work = 0;
+    std::size_t scanned = 0;
+    for (; end >= 16; end -= 16, scanned += 16) {
+        std::size_t i = end - 16;
+        __m128i block_first = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(hay + i));
+        __m128i block_last = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(hay + i + m - 1));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                          _mm_cmpeq_epi8(last, block_last))));
+        while (mask != 0) {
+            int bit = bit_width(mask) - 1;
+            std::size_t pos = i + static_cast<std::size_t>(bit);
+            if (m <= 2 || std::memcmp(hay + pos + 1, needle + 1, m - 2) == 0) {
+                return pos;
+            }
+            work += m;
+            mask ^= std::uint32_t(1) << bit;
+        }
+        if (work > 2 * scanned + 256) {
+            break;
+        }
+    }
+    if (end == 0) {
+        return search_npos;
+    }
+    return two_way_backward(hay, end + m - 1, needle, m);
+#else
+    return two_way_backward(hay, n, needle, m);
+#endif
+}
+
+}
+
+}
+
+#endif // RTTL_STRING_SEARCH_H_
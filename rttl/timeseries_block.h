@@ -0,0 +1,358 @@
+/**
+ * @file rttl/timeseries_block.h
+ *
+ * Compressed block of time series points with statically allocated storage.
+ *
+ * `rttl::timeseries_block<Bytes>` stores `(timestamp, value)` points, where
+ * timestamp is `std::uint64_t` and value is `double`, in a bit buffer of
+ * `Bytes` bytes within the class, using the encoding of Facebook's Gorilla:
+ *  - the first point is stored verbatim;
+ *  - timestamps are stored as delta-of-delta, taking 1 bit for regular
+ *    intervals and 9, 12, 16, 37 or 69 bits otherwise;
+ *  - values are XOR-ed with the previous one and only meaningful bits of the
+ *    result are stored, taking 1 bit for a repeated value;
+ *  - `append` is `O(1)` and returns `false` leaving the block intact when the
+ *    point does not fit, so that the caller can roll over to a new block;
+ *  - points are decoded sequentially by iterating over the block.
+ *
+ */
+#ifndef RTTL_TIMESERIES_BLOCK_H_
+#define RTTL_TIMESERIES_BLOCK_H_
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <utility>
+#include "rttl/bit.h"
+
+namespace rttl {
+
+template <std::size_t Bytes>
+class timeseries_block {
+    static_assert(Bytes >= 16 && Bytes % 8 == 0,
+                  "Bytes must be a multiple of 8 and at least 16");
+public:
+
+    /// @section Member types
+
+    using value_type = std::pair<std::uint64_t, double>;
+    using size_type = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename timeseries_block::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() noexcept = default;
+
+        reference operator*() const noexcept {
+            return m_point;
+        }
+
+        pointer operator->() const noexcept {
+            return &m_point;
+        }
+
+        const_iterator& operator++() noexcept {
+            ++m_index;
+            if (m_index < m_block->m_count) {
+                decode();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const const_iterator& other) const noexcept {
+            return m_index != other.m_index;
+        }
+
+    private:
+        friend class timeseries_block;
+
+        const_iterator(const timeseries_block* block, size_type index) noexcept
+            : m_block(block), m_index(index) {
+            if (m_index < m_block->m_count) {
+                m_point.first = m_block->read(m_pos, 64);
+                m_value = m_block->read(m_pos, 64);
+                m_point.second = to_double(m_value);
+            }
+        }
+
+        void decode() noexcept {
+            m_delta += m_block->read_timestamp(m_pos);
+            m_point.first += static_cast<std::uint64_t>(m_delta);
+            m_value ^= m_block->read_xor(m_pos, m_leading, m_meaningful);
+            m_point.second = to_double(m_value);
+        }
+
+        const timeseries_block* m_block = nullptr;
+        size_type m_index = 0;
+        size_type m_pos = 0;
+        value_type m_point = {};
+        std::uint64_t m_value = 0;
+        std::int64_t m_delta = 0;
+        int m_leading = 0;
+        int m_meaningful = 0;
+    };
+
+    using iterator = const_iterator;
+
+    /// @section Member functions
+
+    timeseries_block() noexcept = default;
+
+    /// @subsection Iterators
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, m_count);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /// @subsection Capacity
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_count == 0;
+    }
+
+    /**
+     * Number of points in the block.
+     */
+    size_type size() const noexcept {
+        return m_count;
+    }
+
+    /**
+     * Number of bits used by encoded points.
+     */
+    size_type bit_size() const noexcept {
+        return m_bits;
+    }
+
+    static constexpr size_type bit_capacity() noexcept {
+        return Bytes * 8;
+    }
+
+    /// @subsection Modifiers
+
+    /**
+     * Appends a point; timestamps should not decrease, though any sequence is
+     * encoded losslessly. Returns `false` if the point does not fit.
+     */
+    bool append(std::uint64_t timestamp, double value) noexcept {
+        std::uint64_t bits = to_bits(value);
+        if (m_count == 0) {
+            write(timestamp, 64);
+            write(bits, 64);
+            m_timestamp = timestamp;
+            m_value = bits;
+            m_count = 1;
+            return true;
+        }
+
+        auto delta = static_cast<std::int64_t>(timestamp - m_timestamp);
+        auto dod = static_cast<std::int64_t>(static_cast<std::uint64_t>(delta)
+                   - static_cast<std::uint64_t>(m_delta));
+        int ts_class = timestamp_class(dod);
+        size_type ts_bits = timestamp_bits(ts_class);
+
+        std::uint64_t x = bits ^ m_value;
+        int leading = 0;
+        int meaningful = 0;
+        size_type value_bits = 1;
+        bool reuse = false;
+        if (x != 0) {
+            leading = std::min(countl_zero(x), 31);
+            meaningful = 64 - leading - countr_zero(x);
+            reuse = (m_meaningful != 0) && (leading >= m_leading) &&
+                    (leading + meaningful <= m_leading + m_meaningful);
+            value_bits = reuse ? 2 + static_cast<size_type>(m_meaningful)
+                               : 13 + static_cast<size_type>(meaningful);
+        }
+
+        if (m_bits + ts_bits + value_bits > bit_capacity()) {
+            return false;
+        }
+
+        write_timestamp(ts_class, dod);
+        if (x == 0) {
+            write(0, 1);
+        } else if (reuse) {
+            write(0b10, 2);
+            write(x >> (64 - m_leading - m_meaningful), m_meaningful);
+        } else {
+            write(0b11, 2);
+            write(static_cast<std::uint64_t>(leading), 5);
+            /// Meaningful bits count of 64 is stored as 0
+            write(static_cast<std::uint64_t>(meaningful & 63), 6);
+            write(x >> (64 - leading - meaningful), meaningful);
+            m_leading = leading;
+            m_meaningful = meaningful;
+        }
+        m_timestamp = timestamp;
+        m_delta = delta;
+        m_value = bits;
+        ++m_count;
+        return true;
+    }
+
+    void clear() noexcept {
+        m_words = {};
+        m_bits = 0;
+        m_count = 0;
+        m_timestamp = 0;
+        m_delta = 0;
+        m_value = 0;
+        m_leading = 0;
+        m_meaningful = 0;
+    }
+
+private:
+    static std::uint64_t to_bits(double value) noexcept {
+        std::uint64_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    static double to_double(std::uint64_t bits) noexcept {
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    /// Delta-of-delta is stored with prefix `0`, `10`, `110`, `1110`, `11110`
+    /// or `11111` followed by 0, 7, 9, 12, 32 or 64 bits respectively
+    static constexpr int dod_width[] = { 0, 7, 9, 12, 32, 64 };
+
+    static int timestamp_class(std::int64_t dod) noexcept {
+        if (dod == 0) {
+            return 0;
+        }
+        for (int c = 1; c < 5; ++c) {
+            std::int64_t limit = std::int64_t(1) << (dod_width[c] - 1);
+            if (dod >= -limit && dod < limit) {
+                return c;
+            }
+        }
+        return 5;
+    }
+
+    static size_type timestamp_bits(int ts_class) noexcept {
+        return static_cast<size_type>(std::min(ts_class + 1, 5) +
+                                      dod_width[ts_class]);
+    }
+
+    void write_timestamp(int ts_class, std::int64_t dod) noexcept {
+        /// Prefix of `ts_class` ones terminated by zero, unless the longest
+        write((std::uint64_t(1) << ts_class) - 1, ts_class);
+        if (ts_class < 5) {
+            write(0, 1);
+        }
+        int width = dod_width[ts_class];
+        std::uint64_t mask = (width == 64) ? ~std::uint64_t(0)
+                                           : (std::uint64_t(1) << width) - 1;
+        write(static_cast<std::uint64_t>(dod) & mask, width);
+    }
+
+    std::int64_t read_timestamp(size_type& pos) const noexcept {
+        int ts_class = 0;
+        while (ts_class < 5 && read(pos, 1) != 0) {
+            ++ts_class;
+        }
+        int width = dod_width[ts_class];
+        if (width == 0) {
+            return 0;
+        }
+        std::uint64_t v = read(pos, width);
+        if (width < 64 && (v >> (width - 1)) != 0) {
+            /// Sign extension
+            v |= ~std::uint64_t(0) << width;
+        }
+        return static_cast<std::int64_t>(v);
+    }
+
+    std::uint64_t read_xor(size_type& pos, int& leading,
+                           int& meaningful) const noexcept {
+        if (read(pos, 1) == 0) {
+            return 0;
+        }
+        if (read(pos, 1) != 0) {
+            leading = static_cast<int>(read(pos, 5));
+            meaningful = static_cast<int>(read(pos, 6));
+            if (meaningful == 0) {
+                meaningful = 64;
+            }
+        }
+        return read(pos, meaningful) << (64 - leading - meaningful);
+    }
+
+    /// Writes `n <= 64` least significant bits of `v`, most significant first
+    void write(std::uint64_t v, int n) noexcept {
+        if (n == 0) {
+            return;
+        }
+        size_type word = m_bits / 64;
+        int free = 64 - static_cast<int>(m_bits % 64);
+        if (n <= free) {
+            m_words[word] |= v << (free - n);
+        } else {
+            m_words[word] |= v >> (n - free);
+            m_words[word + 1] |= v << (64 - (n - free));
+        }
+        m_bits += static_cast<size_type>(n);
+    }
+
+    std::uint64_t read(size_type& pos, int n) const noexcept {
+        if (n == 0) {
+            return 0;
+        }
+        size_type word = pos / 64;
+        int used = static_cast<int>(pos % 64);
+        int avail = 64 - used;
+        std::uint64_t result = (m_words[word] << used) >> (64 - n);
+        if (n > avail) {
+            result |= m_words[word + 1] >> (64 - (n - avail));
+        }
+        pos += static_cast<size_type>(n);
+        return result;
+    }
+
+    std::array<std::uint64_t, Bytes / 8> m_words = {};
+    size_type m_bits = 0;
+    size_type m_count = 0;
+    /// Encoder state: the last point, the last delta and the last XOR window
+    std::uint64_t m_timestamp = 0;
+    std::int64_t m_delta = 0;
+    std::uint64_t m_value = 0;
+    int m_leading = 0;
+    int m_meaningful = 0;
+
+};
+
+}
+
+#endif // RTTL_TIMESERIES_BLOCK_H_
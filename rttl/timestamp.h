@@ -0,0 +1,379 @@
+/**
+ * @file rttl/timestamp.h
+ *
+ * Formatting and parsing of UTC timestamps in fixed layouts, for log lines and
+ * protocol messages.
+ *
+ * Timestamps are nanoseconds since the Unix epoch, or `std::chrono` time
+ * points of the system clock, in one of the layouts of `timestamp_layout`
+ * with `Digits` (0, 3, 6 or 9) fractional digits of a second:
+ *  - `iso8601`: `2024-03-15T09:30:00.123456789Z`;
+ *  - `fix`: `20240315-09:30:00.123456789`, the FIX UTCTimestamp.
+ *
+ * Neither the locale nor the time zone database is consulted:
+ *  - `timestamp_formatter` converts days to the civil date arithmetically,
+ *    writes two digits at a time from a table of digit pairs, and caches the
+ *    date and time text of the last second, so that consecutive timestamps
+ *    within a second only write their fractional digits; text goes straight
+ *    into `basic_string::data()` with `resize_and_overwrite`;
+ *  - `format_timestamp` uses a formatter per thread and layout;
+ *  - `parse_timestamp` checks separators and digits and converts digits 8
+ *    characters at a time with SWAR arithmetic; it accepts exactly the layout
+ *    and returns `false` for anything else.
+ *
+ * Nanoseconds in `std::int64_t` cover years 1677 to 2262; text of other years
+ * is rejected by `parse_timestamp`.
+ *
+ */
+#ifndef RTTL_TIMESTAMP_H_
+#define RTTL_TIMESTAMP_H_
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <string_view>
+#include "rttl/bit.h"
+#include "rttl/decimal.h"
+#include "rttl/string.h"
+
+namespace rttl {
+
+enum class timestamp_layout {
+    /// `YYYY-MM-DDTHH:MM:SS.fffZ`
+    iso8601,
+    /// `YYYYMMDD-HH:MM:SS.fff`
+    fix
+};
+
+namespace detail {
+
+constexpr std::int64_t nanos_per_second = 1000000000;
+constexpr std::int64_t seconds_per_day = 86400;
+
+/// Digit pairs `00` to `99`
+constexpr std::array<char, 200> make_digit_pairs() noexcept {
+    std::array<char, 200> result = {};
+    for (std::size_t i = 0; i < 100; ++i) {
+        result[2 * i] = static_cast<char>('0' + i / 10);
+        result[2 * i + 1] = static_cast<char>('0' + i % 10);
+    }
+    return result;
+}
+
+constexpr std::array<char, 200> digit_pairs = make_digit_pairs();
+
+inline void write_2_digits(char* p, unsigned value) noexcept {
+    std::memcpy(p, digit_pairs.data() + 2 * value, 2);
+}
+
+/// Writes `n` digits of `value`, zero-padded
+inline void write_digits(char* p, std::uint32_t value, unsigned n) noexcept {
+    for (; n >= 2; n -= 2) {
+        write_2_digits(p + n - 2, value % 100);
+        value /= 100;
+    }
+    if (n == 1) {
+        *p = static_cast<char>('0' + value);
+    }
+}
+
+constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+    return a / b - ((a % b < 0) ? 1 : 0);
+}
+
+/// Civil date of the day number since 1970-01-01
+struct civil_date {
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+};
+
+constexpr civil_date civil_from_days(std::int64_t z) noexcept {
+    z += 719468;
+    std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    auto doe = static_cast<unsigned>(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    unsigned day = doy - (153 * mp + 2) / 5 + 1;
+    unsigned month = (mp < 10) ? mp + 3 : mp - 9;
+    std::int64_t year = static_cast<std::int64_t>(yoe) + era * 400 +
+                        (month <= 2 ? 1 : 0);
+    return { year, month, day };
+}
+
+constexpr std::int64_t days_from_civil(std::int64_t year, unsigned month,
+                                       unsigned day) noexcept {
+    year -= (month <= 2) ? 1 : 0;
+    std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    auto yoe = static_cast<unsigned>(year - era * 400);
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+constexpr unsigned days_in_month(std::int64_t year, unsigned month) noexcept {
+    if (month == 2) {
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return leap ? 29 : 28;
+    }
+    return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+/**
+ * Text layout: `'0'` marks digit positions, other characters are literal.
+ */
+template <timestamp_layout Layout, unsigned Digits>
+struct timestamp_pattern {
+    static_assert(Digits == 0 || Digits == 3 || Digits == 6 || Digits == 9,
+                  "Digits must be 0, 3, 6 or 9");
+
+    static constexpr bool iso = (Layout == timestamp_layout::iso8601);
+    /// Offsets of fields
+    static constexpr std::size_t year = 0;
+    static constexpr std::size_t month = iso ? 5 : 4;
+    static constexpr std::size_t day = iso ? 8 : 6;
+    static constexpr std::size_t hour = iso ? 11 : 9;
+    static constexpr std::size_t minute = iso ? 14 : 12;
+    static constexpr std::size_t second = iso ? 17 : 15;
+    /// Length of the date and time up to seconds
+    static constexpr std::size_t prefix = iso ? 19 : 17;
+    static constexpr std::size_t fraction = prefix + 1;
+    static constexpr std::size_t length =
+        prefix + (Digits > 0 ? Digits + 1 : 0) + (iso ? 1 : 0);
+
+    static constexpr std::array<char, length> make() noexcept {
+        std::array<char, length> result = {};
+        const char* text = iso ? "0000-00-00T00:00:00" : "00000000-00:00:00";
+        for (std::size_t i = 0; i < prefix; ++i) {
+            result[i] = text[i];
+        }
+        std::size_t i = prefix;
+        if (Digits > 0) {
+            result[i++] = '.';
+            for (unsigned k = 0; k < Digits; ++k) {
+                result[i++] = '0';
+            }
+        }
+        if (iso) {
+            result[i] = 'Z';
+        }
+        return result;
+    }
+
+    static constexpr std::array<char, length> text = make();
+
+    /// Number of 8-character blocks parsed at once, the last one padded
+    static constexpr std::size_t blocks = (length + 7) / 8;
+
+    /// Little-endian blocks of the literal characters, or with `digit_mask`
+    /// of `0xFF` at digit positions
+    static constexpr std::array<std::uint64_t, blocks> make_blocks(
+            bool digit_mask) noexcept {
+        std::array<char, length> t = make();
+        std::array<std::uint64_t, blocks> result = {};
+        for (std::size_t b = 0; b < blocks; ++b) {
+            for (std::size_t i = 8; i > 0; --i) {
+                std::size_t pos = b * 8 + i - 1;
+                char c = (pos < length) ? t[pos] : '\0';
+                std::uint64_t byte = digit_mask ? (c == '0' ? 0xFFu : 0u)
+                                                : static_cast<std::uint8_t>(c);
+                result[b] = (result[b] << 8) | byte;
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::array<std::uint64_t, blocks> literals = make_blocks(false);
+    static constexpr std::array<std::uint64_t, blocks> digit_masks = make_blocks(true);
+};
+
+}
+
+template <timestamp_layout Layout = timestamp_layout::iso8601,
+          unsigned Digits = 9>
+class timestamp_formatter {
+    using pattern = detail::timestamp_pattern<Layout, Digits>;
+public:
+
+    /// Number of characters of a timestamp
+    static constexpr std::size_t length = pattern::length;
+
+    constexpr timestamp_formatter() noexcept = default;
+
+    /**
+     * Writes `length` characters of the timestamp `nanos` to `p`.
+     */
+    void write(std::int64_t nanos, char* p) noexcept {
+        std::int64_t second = detail::floor_div(nanos, detail::nanos_per_second);
+        if (second != m_second) {
+            update(second);
+        }
+        std::memcpy(p, m_text.data(), length);
+        if constexpr (Digits > 0) {
+            auto fraction = static_cast<std::uint32_t>(
+                (nanos % detail::nanos_per_second + detail::nanos_per_second) %
+                detail::nanos_per_second);
+            detail::write_digits(p + pattern::fraction,
+                                 fraction / detail::pow10<std::uint32_t>(9 - Digits),
+                                 Digits);
+        }
+    }
+
+    /**
+     * @name format
+     *
+     * Replaces contents of `out` with the timestamp.
+     */
+    ///{
+    template <std::size_t MaxLength, typename Traits>
+    void format(std::int64_t nanos, basic_string<MaxLength, char, Traits>& out) {
+        static_assert(MaxLength >= length, "String is too short for timestamps");
+        out.resize_and_overwrite(length, [this, nanos](char* p, std::size_t) {
+            write(nanos, p);
+            return length;
+        });
+    }
+
+    template <std::size_t MaxLength, typename Traits, typename Duration>
+    void format(std::chrono::time_point<std::chrono::system_clock, Duration> time,
+                basic_string<MaxLength, char, Traits>& out) {
+        format(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   time.time_since_epoch()).count(), out);
+    }
+    ///}
+
+private:
+    /// Rewrites the cached text for `second`, the date only if the day changes
+    void update(std::int64_t second) noexcept {
+        std::int64_t day = detail::floor_div(second, detail::seconds_per_day);
+        if (day != m_day || m_second == unset) {
+            detail::civil_date date = detail::civil_from_days(day);
+            auto year = static_cast<unsigned>(date.year);
+            detail::write_2_digits(m_text.data() + pattern::year, year / 100);
+            detail::write_2_digits(m_text.data() + pattern::year + 2, year % 100);
+            detail::write_2_digits(m_text.data() + pattern::month, date.month);
+            detail::write_2_digits(m_text.data() + pattern::day, date.day);
+            m_day = day;
+        }
+        auto time = static_cast<unsigned>(second - day * detail::seconds_per_day);
+        detail::write_2_digits(m_text.data() + pattern::hour, time / 3600);
+        detail::write_2_digits(m_text.data() + pattern::minute, time / 60 % 60);
+        detail::write_2_digits(m_text.data() + pattern::second, time % 60);
+        m_second = second;
+    }
+
+    static constexpr std::int64_t unset = std::numeric_limits<std::int64_t>::min();
+
+    std::array<char, length> m_text = pattern::text;
+    std::int64_t m_second = unset;
+    std::int64_t m_day = 0;
+
+};
+
+/**
+ * @name format_timestamp
+ *
+ * Replaces contents of `out` with the timestamp, using a formatter of the
+ * calling thread.
+ */
+///{
+template <timestamp_layout Layout = timestamp_layout::iso8601,
+          unsigned Digits = 9, std::size_t MaxLength, typename Traits>
+void format_timestamp(std::int64_t nanos,
+                      basic_string<MaxLength, char, Traits>& out) {
+    static thread_local timestamp_formatter<Layout, Digits> formatter;
+    formatter.format(nanos, out);
+}
+
+template <timestamp_layout Layout = timestamp_layout::iso8601,
+          unsigned Digits = 9, std::size_t MaxLength, typename Traits,
+          typename Duration>
+void format_timestamp(std::chrono::time_point<std::chrono::system_clock, Duration> time,
+                      basic_string<MaxLength, char, Traits>& out) {
+    format_timestamp<Layout, Digits>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            time.time_since_epoch()).count(), out);
+}
+///}
+
+/**
+ * Parses a timestamp in the layout into nanoseconds since the epoch;
+ * returns `false`, leaving `nanos` intact, if `str` does not match the
+ * layout or is not a valid date and time.
+ */
+template <timestamp_layout Layout = timestamp_layout::iso8601,
+          unsigned Digits = 9>
+bool parse_timestamp(std::string_view str, std::int64_t& nanos) noexcept {
+    using pattern = detail::timestamp_pattern<Layout, Digits>;
+    constexpr std::size_t blocks = pattern::blocks;
+    if (str.size() != pattern::length) {
+        return false;
+    }
+    /// Text and pattern padded to whole blocks, digit values per position
+    std::array<std::uint8_t, blocks * 8> text = {};
+    std::array<std::uint8_t, blocks * 8> digits;
+    std::memcpy(text.data(), str.data(), pattern::length);
+    for (std::size_t b = 0; b < blocks; ++b) {
+        const std::uint64_t expected = pattern::literals[b];
+        const std::uint64_t digit_mask = pattern::digit_masks[b];
+        auto block = detail::load_le<std::uint64_t>(text.data() + b * 8);
+        /// Literals must match, digit positions must hold digits; literal
+        /// positions are replaced with `'0'` for the digit check
+        std::uint64_t chunk = (block & digit_mask) |
+                              (0x3030303030303030u & ~digit_mask);
+        if (((block ^ expected) & ~digit_mask) != 0 ||
+            !detail::all_digits(chunk)) {
+            return false;
+        }
+        detail::store_le(digits.data() + b * 8, chunk - 0x3030303030303030u);
+    }
+    auto two = [&digits](std::size_t pos) {
+        return static_cast<unsigned>(digits[pos] * 10 + digits[pos + 1]);
+    };
+    std::int64_t year = two(pattern::year) * 100 + two(pattern::year + 2);
+    unsigned month = two(pattern::month);
+    unsigned day = two(pattern::day);
+    unsigned hour = two(pattern::hour);
+    unsigned minute = two(pattern::minute);
+    unsigned second = two(pattern::second);
+    if (month < 1 || month > 12 || day < 1 ||
+        day > detail::days_in_month(year, month) ||
+        hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    std::int64_t fraction = 0;
+    for (std::size_t i = 0; i < Digits; ++i) {
+        fraction = fraction * 10 + digits[pattern::fraction + i];
+    }
+    fraction *= detail::pow10<std::int64_t>(9 - Digits);
+    std::int64_t seconds = detail::days_from_civil(year, month, day) *
+                               detail::seconds_per_day +
+                           hour * 3600 + minute * 60 + second;
+    /// Borrows a second for the fraction of negative times, whose whole
+    /// seconds alone may be out of range
+    if (seconds < 0 && fraction > 0) {
+        ++seconds;
+        fraction -= detail::nanos_per_second;
+    }
+    /// Range checks against precomputed bounds instead of overflow builtins
+    constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+    constexpr std::int64_t min = std::numeric_limits<std::int64_t>::min();
+    if (seconds > max / detail::nanos_per_second ||
+        seconds < min / detail::nanos_per_second) {
+        return false;
+    }
+    std::int64_t result = seconds * detail::nanos_per_second;
+    if ((fraction > 0 && result > max - fraction) ||
+        (fraction < 0 && result < min - fraction)) {
+        return false;
+    }
+    nanos = result + fraction;
+    return true;
+}
+
+}
+
+#endif // RTTL_TIMESTAMP_H_
@@ -28,6 +28,14 @@
  *  - `std::erase` and `std::erase_if` overloads are not provided;
  *  - `pop_back` operation does not cause undefined behaviour when called on
  *    empty container; it is defined to throw an exception;
+ *  - `append_uninitialized` member function is added to construct a batch of
+ *    elements at the end with a single capacity check;
+ *  - `std::hash` specialization is provided; elements of types with unique
+ *    object representations are hashed as bytes in bulk, others by combining
+ *    `std::hash` of every element; `rttl::range_hash` and `rttl::range_equal`
+ *    hash and compare any contiguous ranges consistently with it; they are
+ *    transparent, but `std::unordered_*` containers use that for lookups by
+ *    other range types only as of C++20;
  *
  * Important notes on usage:
  *  1. Be careful with placing vectors with `rttl::vector` instantiations on the
@@ -41,8 +49,11 @@
 #ifndef RTTL_VECTOR_H_
 #define RTTL_VECTOR_H_
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -589,6 +600,23 @@ public:
         resize(size() - 1);
     }
 
+    /**
+     * Appends up to `count` elements constructed in place by `op`.
+     *
+     * `op(p, count)` receives pointer `p` to the uninitialized storage past
+     * the last element, must construct `n <= count` elements in `[p, p + n)`
+     * and return `n`. Capacity is checked once, before `op` is invoked, which
+     * makes this the bulk counterpart of `emplace_back`. If `op` throws, it
+     * must destroy the elements it has already constructed.
+     */
+    template<typename Operation>
+    void append_uninitialized(size_type count, Operation op) {
+        if (size() + count > max_size()) {
+            throw std::length_error("rttl::vector");
+        }
+        m_length += op(end(), count);
+    }
+
     /**
      * @name resize
      */
@@ -822,6 +850,109 @@ void swap(std::vector<T,Alloc>& lhs, rttl::vector<T,MaxSize>& rhs) {
 }
 ///}
 
+namespace detail {
+
+/**
+ * MurmurHash64A of `size` bytes, processed 8 bytes per step.
+ */
+inline std::uint64_t hash_bytes(const void* data, std::size_t size,
+                                std::uint64_t seed) noexcept {
+    constexpr std::uint64_t m = 0xc6a4a7935bd1e995;
+    constexpr int r = 47;
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed ^ (size * m);
+    for (; size >= 8; size -= 8, p += 8) {
+        std::uint64_t k;
+        std::memcpy(&k, p, 8);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    if (size > 0) {
+        std::uint64_t k = 0;
+        std::memcpy(&k, p, size);
+        h ^= k;
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+/**
+ * Hash of 64 bits as `Size`, keeping the lower bits if `Size` is narrower.
+ */
+template <typename Size = std::size_t>
+constexpr Size narrow_hash(std::uint64_t h) noexcept {
+    if constexpr (sizeof(Size) < sizeof(h)) {
+        return static_cast<Size>(h);
+    } else {
+        return h;
+    }
+}
+
+}
+
+/**
+ * Hash of `count` elements starting at `data`; equals `std::hash` of
+ * `rttl::vector` holding the same elements. The 64-bit hash is truncated to
+ * its lower bits where `std::size_t` is narrower, e.g. on 32-bit targets.
+ */
+template <typename T>
+std::size_t hash_range(const T* data, std::size_t count) {
+    constexpr std::uint64_t seed = 0x9e3779b97f4a7c15;
+    if constexpr (std::has_unique_object_representations<T>::value) {
+        return detail::narrow_hash(detail::hash_bytes(data, count * sizeof(T), seed));
+    } else {
+        std::uint64_t h = seed ^ count;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint64_t e = std::hash<T>{}(data[i]);
+            h ^= e + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+        }
+        return detail::narrow_hash(detail::hash_bytes(&h, sizeof(h), seed));
+    }
+}
+
+/**
+ * Transparent hash of contiguous ranges: `rttl::vector`, `std::vector`,
+ * `std::array`, arrays, etc.
+ */
+struct range_hash {
+    using is_transparent = void;
+
+    template <typename Range>
+    std::size_t operator()(const Range& range) const {
+        return hash_range(std::data(range), std::size(range));
+    }
+};
+
+/**
+ * Transparent equality of contiguous ranges, matching `rttl::range_hash`.
+ */
+struct range_equal {
+    using is_transparent = void;
+
+    template <typename Range1, typename Range2>
+    bool operator()(const Range1& lhs, const Range2& rhs) const {
+        return std::equal(std::begin(lhs), std::end(lhs),
+                          std::begin(rhs), std::end(rhs));
+    }
+};
+
+}
+
+namespace std {
+
+template <typename T, std::size_t MaxSize>
+struct hash<rttl::vector<T,MaxSize>> {
+    std::size_t operator()(const rttl::vector<T,MaxSize>& v) const {
+        return rttl::hash_range(v.data(), v.size());
+    }
+};
+
 }
 
 #endif // RTTL_VECTOR_H_
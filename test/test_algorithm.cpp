@@ -0,0 +1,231 @@
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/algorithm.h"
+#include "element.h"
+
+struct Quote {
+    int price;
+    int venue;
+};
+
+static bool operator<(const Quote& lhs, const Quote& rhs) {
+    return lhs.price < rhs.price;
+}
+
+TEST(kway_merger_1) {
+    rttl::vector<int, 8> a = { 1, 4, 7 };
+    rttl::vector<int, 8> b = { 2, 5, 8 };
+    rttl::vector<int, 8> c = { 3, 6, 9 };
+    rttl::kway_merger<const int*, 3> m({ a.cbegin(), b.cbegin(), c.cbegin() },
+                                       { a.cend(), b.cend(), c.cend() });
+    CHECK_EQUAL(9u, m.size());
+    int expected = 1;
+    for (int x : m) {
+        CHECK_EQUAL(expected, x);
+        ++expected;
+    }
+    CHECK_EQUAL(10, expected);
+    CHECK(m.empty());
+    CHECK_EQUAL(0u, m.size());
+}
+
+TEST(kway_merger_2) {
+    /// Empty and single ranges
+    std::array<rttl::vector<int, 8>, 1> one = {{ { 1, 2, 3 } }};
+    rttl::kway_merger<const int*, 1> m1(one);
+    CHECK_EQUAL(1, m1.top());
+    m1.pop();
+    CHECK_EQUAL(2, m1.top());
+    m1.pop();
+    m1.pop();
+    CHECK(m1.empty());
+
+    std::array<rttl::vector<int, 8>, 5> some = {{ {}, { 5 }, {}, {}, { 2 } }};
+    rttl::kway_merger<const int*, 5> m5(some);
+    CHECK_EQUAL(2, m5.top());
+    CHECK_EQUAL(4u, m5.top_index());
+    m5.pop();
+    CHECK_EQUAL(5, m5.top());
+    CHECK_EQUAL(1u, m5.top_index());
+    m5.pop();
+    CHECK(m5.empty());
+}
+
+TEST(kway_merge_1) {
+    rttl::vector<int, 8> a = { 1, 3, 5, 7 };
+    rttl::vector<int, 4> b = { 2, 4 };
+    std::vector<int> c = { 0, 6, 8 };
+    rttl::vector<int, 16> out = { -1 };
+    rttl::kway_merge(a, b, c, out);
+    CHECK(out == std::vector<int>({ -1, 0, 1, 2, 3, 4, 5, 6, 7, 8 }));
+    rttl::vector<int, 10> small;
+    rttl::kway_merge(a, b, c, small);
+    CHECK_THROW(rttl::kway_merge(a, b, c, small), std::length_error);
+    CHECK_EQUAL(9u, small.size());
+}
+
+TEST(kway_merge_2) {
+    /// Compare with `std::merge` for various number of inputs
+    std::array<rttl::vector<int, 32>, 37> inputs;
+    std::vector<int> expected;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+        for (std::size_t j = 0; j < (i * 7) % 32; ++j) {
+            inputs[i].push_back(static_cast<int>((i * 31 + j * 17) % 101));
+        }
+        std::sort(inputs[i].begin(), inputs[i].end());
+        expected.insert(expected.end(), inputs[i].cbegin(), inputs[i].cend());
+    }
+    std::sort(expected.begin(), expected.end());
+    rttl::vector<int, 37 * 32> out;
+    rttl::kway_merge(inputs, out);
+    CHECK(out == expected);
+
+    std::reverse(expected.begin(), expected.end());
+    for (auto& v : inputs) {
+        std::reverse(v.begin(), v.end());
+    }
+    out.clear();
+    rttl::kway_merge(inputs, out, std::greater<>());
+    CHECK(out == expected);
+}
+
+TEST(stable_kway_merge_1) {
+    rttl::vector<Quote, 8> v0 = { { 1, 0 }, { 2, 0 }, { 2, 0 }, { 3, 0 } };
+    rttl::vector<Quote, 8> v1 = { { 2, 1 }, { 3, 1 } };
+    rttl::vector<Quote, 8> v2 = { { 1, 2 }, { 2, 2 }, { 3, 2 } };
+    rttl::vector<Quote, 16> out;
+    rttl::stable_kway_merge(v0, v1, v2, out);
+    CHECK_EQUAL(9u, out.size());
+    const int venues[] = { 0, 2, 0, 0, 1, 2, 0, 1, 2 };
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        CHECK_EQUAL(venues[i], out[i].venue);
+    }
+    CHECK(std::is_sorted(out.cbegin(), out.cend()));
+
+    std::array<rttl::vector<Quote, 8>, 3> inputs = {{ v2, v1, v0 }};
+    out.clear();
+    rttl::stable_kway_merge(inputs, out);
+    const int venues_reversed[] = { 2, 0, 2, 1, 0, 0, 2, 1, 0 };
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        CHECK_EQUAL(venues_reversed[i], out[i].venue);
+    }
+}
+
+TEST(kway_merge_elements) {
+    /// No element leaks
+    rttl::vector<Element, 8> a = { 1, 3 };
+    rttl::vector<Element, 8> b = { 2 };
+    rttl::vector<Element, 8> out;
+    rttl::kway_merge(a, b, out);
+    CHECK_EQUAL(3u, out.size());
+    CHECK_EQUAL(1, out[0]);
+    CHECK_EQUAL(2, out[1]);
+    CHECK_EQUAL(3, out[2]);
+}
+
+/// Compares set operations on `a` and `b` with those of the standard library
+template <typename T>
+void check_set_operations(const std::vector<T>& a, const std::vector<T>& b) {
+    std::vector<T> expected;
+    rttl::vector<T, 4096> out;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expected));
+    rttl::set_intersect(a, b, out);
+    CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    CHECK_EQUAL(expected.size(), rttl::set_intersect_count(a, b));
+
+    expected.clear();
+    out.clear();
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                   std::back_inserter(expected));
+    rttl::set_union(a, b, out);
+    CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    CHECK_EQUAL(expected.size(), rttl::set_union_count(a, b));
+
+    expected.clear();
+    out.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(expected));
+    rttl::set_difference(a, b, out);
+    CHECK(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    CHECK_EQUAL(expected.size(), rttl::set_difference_count(a, b));
+}
+
+/// Sorted set of `count` distinct values, every one of `step` on average
+template <typename T>
+std::vector<T> random_set(std::size_t count, unsigned step, unsigned seed) {
+    std::vector<T> result;
+    unsigned value = seed % step;
+    for (std::size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        value += 1 + (seed >> 16) % (2 * step - 1);
+        result.push_back(static_cast<T>(value));
+    }
+    return result;
+}
+
+TEST(set_operations_1) {
+    const std::vector<int> a = { 1, 3, 5, 7, 9, 11, 13, 15, 17 };
+    const std::vector<int> b = { 2, 3, 4, 5, 6, 15, 16, 17, 18, 19 };
+    rttl::vector<int, 32> out;
+    rttl::set_intersect(a, b, out);
+    CHECK_EQUAL(4u, out.size());
+    const int intersection[] = { 3, 5, 15, 17 };
+    CHECK_ARRAY_EQUAL(intersection, out.data(), 4);
+    out.clear();
+    rttl::set_difference(a, b, out);
+    const int difference[] = { 1, 7, 9, 11, 13 };
+    CHECK_EQUAL(5u, out.size());
+    CHECK_ARRAY_EQUAL(difference, out.data(), 5);
+
+    check_set_operations(a, b);
+    check_set_operations(b, a);
+    check_set_operations(a, std::vector<int>());
+    check_set_operations(std::vector<int>(), b);
+    check_set_operations(a, a);
+}
+
+TEST(set_operations_2) {
+    /// Balanced and skewed sizes, 16-, 32- and 64-bit elements
+    for (unsigned seed = 1; seed < 20; ++seed) {
+        check_set_operations(random_set<std::uint32_t>(1000, 2, seed),
+                             random_set<std::uint32_t>(1000, 2, seed * 7));
+        check_set_operations(random_set<std::uint32_t>(997, 3, seed),
+                             random_set<std::uint32_t>(333, 9, seed * 7));
+        check_set_operations(random_set<std::uint32_t>(20, 100, seed),
+                             random_set<std::uint32_t>(2000, 1, seed * 7));
+        check_set_operations(random_set<std::uint32_t>(2000, 1, seed),
+                             random_set<std::uint32_t>(20, 100, seed * 7));
+        check_set_operations(random_set<std::int64_t>(500, 2, seed),
+                             random_set<std::int64_t>(600, 2, seed * 7));
+        check_set_operations(random_set<std::uint16_t>(1000, 2, seed),
+                             random_set<std::uint16_t>(1000, 2, seed * 7));
+        check_set_operations(random_set<std::uint16_t>(997, 3, seed),
+                             random_set<std::uint16_t>(333, 9, seed * 7));
+    }
+}
+
+TEST(set_operations_capacity) {
+    const rttl::vector<std::uint32_t, 8> a = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const rttl::vector<std::uint32_t, 8> b = { 2, 4, 6, 8 };
+    /// The exact result size fits although the bound does not
+    rttl::vector<std::uint32_t, 8> out = { 0, 0, 0, 0 };
+    rttl::set_difference(a, b, out);
+    CHECK_EQUAL(8u, out.size());
+    CHECK_EQUAL(7u, out[7]);
+    CHECK_THROW(rttl::set_union(a, b, out), std::length_error);
+    CHECK_EQUAL(8u, out.size());
+    CHECK_EQUAL(8u, rttl::set_union_count(a, b));
+    CHECK_EQUAL(0u, rttl::set_difference_count(b, a));
+}
+
+
+int main(int, const char* []) {
+    int r = UnitTest::RunAllTests();
+    assert(s_elems_ctored.size() == 0); /// Check memory leaks
+    return r;
+}
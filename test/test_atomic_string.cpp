@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/atomic_string.h"
+
+using namespace std::string_view_literals;
+
+TEST(load_store) {
+    rttl::atomic_string<7> s;
+    CHECK(s.load().empty());
+    s.store("abc");
+    CHECK(s.load() == "abc"sv);
+    s = "abcdefg";
+    rttl::string<7> value = s;
+    CHECK(value == "abcdefg"sv);
+    CHECK_THROW(s.store("abcdefgh"), std::length_error);
+    CHECK(s.load() == "abcdefg"sv);
+
+    rttl::atomic_string<15> s15("symbol");
+    CHECK(s15.load() == "symbol"sv);
+    s15.store("fifteen chars!!");
+    CHECK(s15.load() == "fifteen chars!!"sv);
+    s15.store("");
+    CHECK(s15.load().empty());
+
+    rttl::atomic_string<32> s32("a long status line");
+    CHECK(s32.load() == "a long status line"sv);
+    CHECK(!s32.is_lock_free());
+}
+
+TEST(lock_free) {
+    CHECK(rttl::atomic_string<7>().is_lock_free());
+    /// 16-byte words fall back to a spin lock without `cmpxchg16b`
+    CHECK_EQUAL(RTTL_HAS_CAS16 != 0, rttl::atomic_string<15>::is_always_lock_free);
+    CHECK_EQUAL(RTTL_HAS_CAS16 != 0, rttl::atomic_string<15>().is_lock_free());
+    CHECK(!rttl::atomic_string<16>::is_always_lock_free);
+}
+
+TEST(embedded_zero) {
+    rttl::atomic_string<7> s(std::string_view("a\0b", 3));
+    CHECK_EQUAL(3u, s.load().length());
+    CHECK(s.load() != "a"sv);
+}
+
+TEST(exchange) {
+    rttl::atomic_string<7> s("old");
+    CHECK(s.exchange("new") == "old"sv);
+    CHECK(s.load() == "new"sv);
+
+    rttl::atomic_string<12> s12("old");
+    CHECK(s12.exchange("newer value") == "old"sv);
+    CHECK(s12.load() == "newer value"sv);
+
+    rttl::atomic_string<20> s20("old");
+    CHECK(s20.exchange("new") == "old"sv);
+    CHECK(s20.load() == "new"sv);
+}
+
+template <std::size_t N>
+void check_compare_exchange() {
+    rttl::atomic_string<N> s("ab");
+    rttl::string<N> expected("abc");
+    CHECK(!s.compare_exchange_strong(expected, "x"));
+    CHECK(expected == "ab"sv);
+    CHECK(s.compare_exchange_strong(expected, "x"));
+    CHECK(s.load() == "x"sv);
+    expected = "x";
+    while (!s.compare_exchange_weak(expected, "y")) {
+    }
+    CHECK(s.load() == "y"sv);
+}
+
+TEST(compare_exchange) {
+    check_compare_exchange<3>();
+    check_compare_exchange<15>();
+    check_compare_exchange<100>();
+}
+
+template <std::size_t N>
+void check_concurrent_updates() {
+    /// Every thread appends its digit, so no update may be lost
+    rttl::atomic_string<N> s;
+    std::vector<std::thread> threads;
+    for (char c = '0'; c < '0' + char(N / 3); ++c) {
+        threads.emplace_back([&s, c]() {
+            for (int i = 0; i < 3; ++i) {
+                rttl::string<N> expected = s.load();
+                rttl::string<N> desired;
+                do {
+                    desired = expected;
+                    desired.push_back(c);
+                    std::this_thread::yield();
+                } while (!s.compare_exchange_weak(expected, desired));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    rttl::string<N> result = s.load();
+    CHECK_EQUAL(N / 3 * 3, result.length());
+    for (char c = '0'; c < '0' + char(N / 3); ++c) {
+        CHECK_EQUAL(3, std::count(result.begin(), result.end(), c));
+    }
+}
+
+TEST(concurrent_updates) {
+    check_concurrent_updates<6>();
+    check_concurrent_updates<15>();
+    check_concurrent_updates<30>();
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,41 @@
+#include <cstdint>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/bit.h"
+
+TEST(countl_zero) {
+    CHECK_EQUAL(64, rttl::countl_zero(std::uint64_t(0)));
+    CHECK_EQUAL(63, rttl::countl_zero(std::uint64_t(1)));
+    CHECK_EQUAL(0, rttl::countl_zero(std::uint64_t(1) << 63));
+    CHECK_EQUAL(32, rttl::countl_zero(std::uint32_t(0)));
+    CHECK_EQUAL(27, rttl::countl_zero(std::uint32_t(17)));
+    CHECK_EQUAL(8, rttl::countl_zero(std::uint16_t(0xFF)));
+    CHECK_EQUAL(1, rttl::countl_zero(std::uint8_t(0x40)));
+    static_assert(rttl::countl_zero(std::uint64_t(0xFF)) == 56);
+}
+
+TEST(countr_zero) {
+    CHECK_EQUAL(64, rttl::countr_zero(std::uint64_t(0)));
+    CHECK_EQUAL(0, rttl::countr_zero(std::uint64_t(1)));
+    CHECK_EQUAL(63, rttl::countr_zero(std::uint64_t(1) << 63));
+    CHECK_EQUAL(16, rttl::countr_zero(std::uint16_t(0)));
+    CHECK_EQUAL(4, rttl::countr_zero(std::uint32_t(48)));
+}
+
+TEST(popcount) {
+    CHECK_EQUAL(0, rttl::popcount(std::uint64_t(0)));
+    CHECK_EQUAL(64, rttl::popcount(~std::uint64_t(0)));
+    CHECK_EQUAL(8, rttl::popcount(std::uint8_t(0xFF)));
+    CHECK_EQUAL(3, rttl::popcount(0x80000101u));
+}
+
+TEST(bit_width) {
+    CHECK_EQUAL(0, rttl::bit_width(std::uint64_t(0)));
+    CHECK_EQUAL(1, rttl::bit_width(std::uint64_t(1)));
+    CHECK_EQUAL(10, rttl::bit_width(std::uint32_t(1023)));
+    CHECK_EQUAL(11, rttl::bit_width(std::uint32_t(1024)));
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/broadcast_ring.h"
+
+using TestRing = rttl::broadcast_ring<int, 8, 4>;
+
+TEST(subscribe) {
+    TestRing ring;
+    CHECK_EQUAL(8u, ring.capacity());
+    CHECK_EQUAL(4u, ring.max_consumers());
+    CHECK_EQUAL(0u, ring.subscribe());
+    CHECK_EQUAL(1u, ring.subscribe());
+    CHECK_EQUAL(2u, ring.subscribe());
+    CHECK_EQUAL(3u, ring.subscribe());
+    CHECK_THROW(ring.subscribe(), std::length_error);
+    ring.unsubscribe(1);
+    CHECK_EQUAL(1u, ring.subscribe());
+}
+
+TEST(subscribe_concurrently) {
+    /// Consumers subscribing at once get distinct ids
+    for (int round = 0; round < 100; ++round) {
+        TestRing ring;
+        std::vector<std::size_t> ids(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; ++t) {
+            threads.emplace_back([&ring, &ids, t]() { ids[t] = ring.subscribe(); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::vector<bool> seen(4, false);
+        for (std::size_t id : ids) {
+            CHECK(!seen[id]);
+            seen[id] = true;
+        }
+        CHECK_THROW(ring.subscribe(), std::length_error);
+    }
+}
+
+TEST(claim_publish) {
+    TestRing ring;
+    auto c1 = ring.subscribe();
+    auto c2 = ring.subscribe();
+    TestRing::sequence_type first = 0;
+    CHECK(ring.try_claim(3, first));
+    CHECK_EQUAL(0u, first);
+    for (int i = 0; i < 3; ++i) {
+        ring[first + static_cast<unsigned>(i)] = i * 10;
+    }
+    CHECK_EQUAL(0u, ring.available(c1));
+    ring.publish();
+    CHECK_EQUAL(3u, ring.published());
+    CHECK_EQUAL(3u, ring.available(c1));
+    CHECK_EQUAL(3u, ring.available(c2));
+    CHECK_EQUAL(10, ring[ring.position(c1) + 1]);
+
+    /// Slowest consumer holds the producer back
+    CHECK(!ring.try_claim(6, first));
+    CHECK(!ring.try_claim(9, first));
+    std::vector<int> seen;
+    CHECK_EQUAL(3u, ring.consume(c1, [&seen](const int& x) {
+        seen.push_back(x);
+    }));
+    CHECK(seen == std::vector<int>({ 0, 10, 20 }));
+    CHECK(!ring.try_claim(6, first));
+    ring.release(c2, 1);
+    CHECK(ring.try_claim(6, first));
+    CHECK_EQUAL(3u, first);
+    CHECK(!ring.try_push(1));
+    ring.publish();
+    CHECK_EQUAL(8u, ring.available(c2));
+    CHECK_EQUAL(2u, ring.consume(c2, [](const int&) {}, 2));
+    CHECK_EQUAL(6u, ring.available(c2));
+    CHECK_THROW(ring.claim(9), std::length_error);
+
+    /// Unsubscribed consumers do not hold the producer back
+    ring.unsubscribe(c1);
+    ring.unsubscribe(c2);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(ring.try_push(i));
+    }
+    auto c3 = ring.subscribe();
+    CHECK_EQUAL(0u, ring.available(c3));
+    CHECK_EQUAL(109u, ring.position(c3));
+}
+
+TEST(fan_out) {
+    /// Every consumer sees every event in order
+    constexpr int events = 100000;
+    rttl::broadcast_ring<std::uint64_t, 64, 4> ring;
+    std::vector<std::size_t> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(ring.subscribe());
+    }
+    std::vector<std::uint64_t> errors(4, 0);
+    std::vector<std::thread> consumers;
+    for (std::size_t c = 0; c < 4; ++c) {
+        consumers.emplace_back([&ring, &ids, &errors, c]() {
+            std::uint64_t expected = 0;
+            while (expected < events) {
+                auto n = ring.consume(ids[c], [&](const std::uint64_t& x) {
+                    if (x != expected * 3) {
+                        ++errors[c];
+                    }
+                    ++expected;
+                });
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::uint64_t i = 0; i < events; i += 4) {
+        auto first = ring.claim(4);
+        for (std::uint64_t k = 0; k < 4; ++k) {
+            ring[first + k] = (i + k) * 3;
+        }
+        ring.publish();
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+    for (std::size_t c = 0; c < 4; ++c) {
+        CHECK_EQUAL(0u, errors[c]);
+        CHECK_EQUAL(std::uint64_t(events), ring.position(ids[c]));
+    }
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
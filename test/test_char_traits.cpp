@@ -0,0 +1,82 @@
+#include <string>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/char_traits.h"
+#include "rttl/string.h"
+
+template <typename CharT>
+void check_traits() {
+    using traits = rttl::char_traits<CharT>;
+    using std_traits = std::char_traits<CharT>;
+    CharT buf[100];
+    for (int i = 0; i < 99; ++i) {
+        buf[i] = static_cast<CharT>((sizeof(CharT) == 1 ? 0x20 : 0x100) + i);
+    }
+    buf[99] = CharT();
+    /// Every alignment and length, so that blocks and tails are covered
+    for (std::size_t first = 0; first < 8; ++first) {
+        CHECK_EQUAL(std_traits::length(buf + first), traits::length(buf + first));
+        for (std::size_t count = 0; first + count < 99; count += 3) {
+            CharT ch = buf[first + count / 2];
+            CHECK(std_traits::find(buf + first, count, ch) ==
+                  traits::find(buf + first, count, ch));
+            CHECK(traits::find(buf + first, count, CharT(1)) == nullptr);
+        }
+    }
+
+    CharT other[100];
+    std_traits::copy(other, buf, 100);
+    CHECK_EQUAL(0, traits::compare(buf, other, 99));
+    for (std::size_t pos : { 0, 5, 8, 37, 98 }) {
+        other[pos] = static_cast<CharT>(buf[pos] + 1);
+        CHECK(traits::compare(buf, other, 99) < 0);
+        CHECK(traits::compare(other, buf, 99) > 0);
+        CHECK_EQUAL(0, traits::compare(buf, other, pos));
+        other[pos] = buf[pos];
+    }
+    /// Characters are compared as by `std::char_traits`
+    other[3] = static_cast<CharT>(-1);
+    CHECK_EQUAL(std_traits::compare(buf, other, 50) < 0,
+                traits::compare(buf, other, 50) < 0);
+}
+
+TEST(char16_traits) {
+    check_traits<char16_t>();
+}
+
+TEST(char32_traits) {
+    check_traits<char32_t>();
+}
+
+TEST(wchar_traits) {
+    check_traits<wchar_t>();
+}
+
+TEST(char_traits) {
+    check_traits<char>();
+}
+
+TEST(u16string) {
+    rttl::u16string<64> s(u"The quick brown fox jumps over the lazy dog");
+    CHECK_EQUAL(4u, s.find(u'q'));
+    CHECK_EQUAL(16u, s.find(u"fox"));
+    CHECK_EQUAL(s.npos, s.find(u"cat"));
+    CHECK_EQUAL(31u, s.find(u"the", 5));
+    CHECK_EQUAL(41u, s.find_first_of(u'o', 41));
+    CHECK(s.compare(u"The quick") > 0);
+    CHECK(s.compare(u"The quick brown fox jumps over the lazy dot") < 0);
+    CHECK_EQUAL(0, s.compare(std::u16string(u"The quick brown fox jumps over the lazy dog")));
+
+    rttl::u32string<64> s32(U"\U0001F600 smile \U0001F600");
+    CHECK_EQUAL(0u, s32.find(U'\U0001F600'));
+    CHECK_EQUAL(8u, s32.find(U'\U0001F600', 1));
+    CHECK_EQUAL(2u, s32.find(U"smile"));
+
+    rttl::wstring<16> ws(L"wide");
+    CHECK_EQUAL(2u, ws.find(L"de"));
+    CHECK(ws.compare(L"wider") < 0);
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
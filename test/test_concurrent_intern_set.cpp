@@ -0,0 +1,92 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/concurrent_intern_set.h"
+
+using namespace std::string_view_literals;
+
+TEST(intern) {
+    auto set = std::make_unique<rttl::concurrent_intern_set<64, 8>>();
+    CHECK(set->empty());
+    CHECK_EQUAL(set->npos, set->find("AAPL"));
+
+    auto aapl = set->intern("AAPL");
+    auto msft = set->intern("MSFT");
+    CHECK(aapl != msft);
+    CHECK_EQUAL(aapl, set->intern("AAPL"));
+    CHECK_EQUAL(aapl, set->find("AAPL"));
+    CHECK_EQUAL(msft, set->find("MSFT"));
+    CHECK(!set->contains("AAP"));
+    CHECK_EQUAL(2u, set->size());
+    CHECK_EQUAL(8u, set->chars_used());
+
+    /// Views point into the set, not to the argument
+    std::string symbol = "GOOG";
+    auto goog = set->intern(symbol);
+    std::string_view view = set->view(goog);
+    symbol[0] = 'X';
+    CHECK(view == "GOOG"sv);
+    CHECK((*set)[aapl] == "AAPL"sv);
+
+    auto empty = set->intern("");
+    CHECK(set->view(empty).empty());
+    CHECK_EQUAL(empty, set->find(""));
+}
+
+TEST(intern_capacity) {
+    auto set = std::make_unique<rttl::concurrent_intern_set<10, 3>>();
+    set->intern("abcdef");
+    CHECK_THROW(set->intern("ghijk"), std::length_error);
+    set->intern("ghij");
+    CHECK_EQUAL(10u, set->chars_used());
+    CHECK_THROW(set->intern("k"), std::length_error);
+    set->intern("");
+    CHECK_THROW(set->intern("abc"), std::length_error);
+    /// Interned strings are still found
+    CHECK_EQUAL(3u, set->size());
+    CHECK(set->view(set->intern("ghij")) == "ghij"sv);
+    CHECK(set->contains("abcdef"));
+}
+
+TEST(intern_concurrent) {
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t symbol_count = 2000;
+    auto set = std::make_unique<rttl::concurrent_intern_set<
+        symbol_count * 8 * thread_count, symbol_count * thread_count>>();
+
+    /// Every thread interns all symbols, in different orders
+    std::vector<std::vector<std::uint32_t>> ids(
+        thread_count, std::vector<std::uint32_t>(symbol_count));
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            for (std::size_t i = 0; i < symbol_count; ++i) {
+                std::size_t k = (t % 2 == 0) ? i : symbol_count - 1 - i;
+                ids[t][k] = set->intern("SYM" + std::to_string(k));
+                if (i % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK_EQUAL(symbol_count, set->size());
+    for (std::size_t k = 0; k < symbol_count; ++k) {
+        std::string symbol = "SYM" + std::to_string(k);
+        for (std::size_t t = 0; t < thread_count; ++t) {
+            CHECK_EQUAL(ids[0][k], ids[t][k]);
+        }
+        CHECK_EQUAL(ids[0][k], set->find(symbol));
+        CHECK(set->view(ids[0][k]) == symbol);
+    }
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
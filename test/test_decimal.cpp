@@ -0,0 +1,144 @@
+#include <cstdint>
+#include <string_view>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/decimal.h"
+
+using namespace std::string_view_literals;
+
+using price = rttl::decimal<4>;
+
+TEST(parse_decimal) {
+    price p;
+    CHECK(rttl::parse_decimal("123.4500", p) == rttl::decimal_status::ok);
+    CHECK_EQUAL(1234500, p.raw());
+    CHECK(rttl::parse_decimal("-0.0001", p) == rttl::decimal_status::ok);
+    CHECK_EQUAL(-1, p.raw());
+    CHECK(rttl::parse_decimal("+7", p) == rttl::decimal_status::ok);
+    CHECK(p == price::from_units(7));
+    CHECK(rttl::parse_decimal(".5", p) == rttl::decimal_status::ok);
+    CHECK_EQUAL(5000, p.raw());
+    CHECK(rttl::parse_decimal("12.", p) == rttl::decimal_status::ok);
+    CHECK_EQUAL(120000, p.raw());
+    CHECK(rttl::parse_decimal("0000000000000000000012.34", p) ==
+          rttl::decimal_status::ok);
+    CHECK_EQUAL(123400, p.raw());
+
+    /// Long runs of digits go through SWAR conversion
+    CHECK(rttl::parse_decimal("12345678901234.5678", p) ==
+          rttl::decimal_status::ok);
+    CHECK_EQUAL(123456789012345678, p.raw());
+    CHECK(rttl::parse_decimal("1.23450000000000000000", p) ==
+          rttl::decimal_status::ok);
+    CHECK_EQUAL(12345, p.raw());
+
+    /// Extra fractional digits truncate
+    CHECK(rttl::parse_decimal("1.00019", p) == rttl::decimal_status::inexact);
+    CHECK_EQUAL(10001, p.raw());
+    CHECK(rttl::parse_decimal("-1.00019", p) == rttl::decimal_status::inexact);
+    CHECK_EQUAL(-10001, p.raw());
+
+    /// Errors leave the value intact
+    const char* invalid[] = { "", "-", ".", "1.2.3", "12a", "1 ", "+-1",
+                              "1234567a", "1.0000000x", "0x10", "1e5" };
+    for (const char* text : invalid) {
+        CHECK(rttl::parse_decimal(text, p) == rttl::decimal_status::invalid);
+    }
+    CHECK_EQUAL(-10001, p.raw());
+
+    CHECK(rttl::parse_decimal("922337203685477.5807", p) ==
+          rttl::decimal_status::ok);
+    CHECK_EQUAL(INT64_MAX, p.raw());
+    CHECK(rttl::parse_decimal("-922337203685477.5808", p) ==
+          rttl::decimal_status::ok);
+    CHECK_EQUAL(INT64_MIN, p.raw());
+    CHECK(rttl::parse_decimal("922337203685477.5808", p) ==
+          rttl::decimal_status::overflow);
+    CHECK(rttl::parse_decimal("1000000000000000", p) ==
+          rttl::decimal_status::overflow);
+    CHECK(rttl::parse_decimal("99999999999999999999999", p) ==
+          rttl::decimal_status::overflow);
+    CHECK_EQUAL(INT64_MIN, p.raw());
+
+    rttl::string<16> text = "42.42";
+    CHECK(rttl::parse_decimal(text, p) == rttl::decimal_status::ok);
+    CHECK_EQUAL(424200, p.raw());
+
+    rttl::decimal<0> whole;
+    CHECK(rttl::parse_decimal("-15", whole) == rttl::decimal_status::ok);
+    CHECK_EQUAL(-15, whole.raw());
+    CHECK(rttl::parse_decimal("15.5", whole) == rttl::decimal_status::inexact);
+    CHECK_EQUAL(15, whole.raw());
+}
+
+TEST(format_decimal) {
+    rttl::string<32> out;
+    CHECK(rttl::format_decimal(price::from_raw(1234500), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "123.4500"sv);
+    CHECK(rttl::format_decimal(price::from_raw(-1), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "-0.0001"sv);
+    CHECK(rttl::format_decimal(price(), out) == rttl::decimal_status::ok);
+    CHECK(out == "0.0000"sv);
+    CHECK(rttl::format_decimal(price::from_raw(INT64_MAX), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "922337203685477.5807"sv);
+    CHECK(rttl::format_decimal(price::from_raw(INT64_MIN), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "-922337203685477.5808"sv);
+    CHECK(rttl::format_decimal(rttl::decimal<0>::from_raw(-120), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "-120"sv);
+    CHECK(rttl::format_decimal(rttl::decimal<12>::from_raw(5), out) ==
+          rttl::decimal_status::ok);
+    CHECK(out == "0.000000000005"sv);
+
+    rttl::string<6> small = "x";
+    CHECK(rttl::format_decimal(price::from_raw(1234500), small) ==
+          rttl::decimal_status::overflow);
+    CHECK(small == "x"sv);
+    CHECK(rttl::format_decimal(price::from_raw(12345), small) ==
+          rttl::decimal_status::ok);
+    CHECK(small == "1.2345"sv);
+
+    /// Round trip
+    price p;
+    for (std::int64_t raw = -3000000; raw <= 3000000; raw += 9973) {
+        CHECK(rttl::format_decimal(price::from_raw(raw), out) ==
+              rttl::decimal_status::ok);
+        CHECK(rttl::parse_decimal(out, p) == rttl::decimal_status::ok);
+        CHECK_EQUAL(raw, p.raw());
+    }
+}
+
+TEST(decimal_arithmetic) {
+    price a = price::from_raw(15000);
+    price b = price::from_units(2);
+    CHECK((a + b).raw() == 35000);
+    CHECK((a - b).raw() == -5000);
+    CHECK(-a < a);
+    CHECK(a <= a && a >= a && b > a && a != b);
+    CHECK_EQUAL(10000, price::one);
+}
+
+#if RTTL_HAS_INT128
+TEST(decimal_128) {
+    using amount = rttl::decimal<18, rttl::int128>;
+    amount a;
+    CHECK(rttl::parse_decimal("-12345678901234567890.123456789012345678", a) ==
+          rttl::decimal_status::ok);
+    rttl::string<48> out;
+    CHECK(rttl::format_decimal(a, out) == rttl::decimal_status::ok);
+    CHECK(out == "-12345678901234567890.123456789012345678"sv);
+    CHECK(rttl::parse_decimal("170141183460469231731.687303715884105727", a) ==
+          rttl::decimal_status::ok);
+    CHECK(rttl::parse_decimal("170141183460469231731.687303715884105728", a) ==
+          rttl::decimal_status::overflow);
+    CHECK(rttl::format_decimal(a, out) == rttl::decimal_status::ok);
+    CHECK(out == "170141183460469231731.687303715884105727"sv);
+}
+#endif
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
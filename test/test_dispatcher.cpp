@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/dispatcher.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+
+struct quote {
+    int bid;
+    int ask;
+};
+
+}
+
+TEST(dispatcher_topics) {
+    rttl::dispatcher<4, 8> d;
+    auto trades = d.topic("trades");
+    CHECK(static_cast<bool>(trades));
+    CHECK(trades == d.topic("trades"sv));
+    CHECK(trades == d.find_topic("trades"));
+    CHECK(d.topic_name(trades) == "trades"sv);
+    CHECK(!d.find_topic("quotes"));
+    rttl::string<16> name("quotes");
+    auto quotes = d.topic(name);
+    CHECK(quotes != trades);
+    CHECK_EQUAL(2u, d.topic_count());
+    d.topic("a");
+    d.topic("b");
+    CHECK_THROW(d.topic("c"), std::length_error);
+    CHECK_THROW(d.topic(std::string_view(rttl::string<80>(80, 'x'))), std::length_error);
+    CHECK(!d.find_topic(std::string_view(rttl::string<80>(80, 'x'))));
+    CHECK_EQUAL(4u, d.topic_count());
+}
+
+TEST(dispatcher_publish) {
+    rttl::dispatcher<4, 8, 32, void(const quote&, std::int64_t)> d;
+    auto topic = d.topic("IBM");
+    rttl::vector<int, 16> calls;
+    d.subscribe(topic, [&calls](const quote& q, std::int64_t) { calls.push_back(q.bid); });
+    d.subscribe("IBM", [&calls](const quote& q, std::int64_t t) {
+        calls.push_back(q.ask + static_cast<int>(t));
+    });
+    d.subscribe("MSFT", [&calls](const quote&, std::int64_t) { calls.push_back(-1); });
+    CHECK_EQUAL(2u, d.publish(topic, quote{ 10, 20 }, 5));
+    CHECK_EQUAL(2u, calls.size());
+    /// Order of subscription
+    CHECK_EQUAL(10, calls[0]);
+    CHECK_EQUAL(25, calls[1]);
+    CHECK_EQUAL(1u, d.publish("MSFT", quote{ 0, 0 }, 0));
+    CHECK_EQUAL(0u, d.publish("AAPL", quote{ 0, 0 }, 0));
+    CHECK_EQUAL(3u, calls.size());
+    CHECK_EQUAL(3u, d.subscriber_count());
+    CHECK_EQUAL(2u, d.subscriber_count(topic));
+}
+
+TEST(dispatcher_unsubscribe) {
+    rttl::dispatcher<2, 3> d;
+    auto topic = d.topic("events");
+    int a = 0;
+    int b = 0;
+    int c = 0;
+    auto sa = d.subscribe(topic, [&a](std::string_view) { ++a; });
+    auto sb = d.subscribe(topic, [&b](std::string_view) { ++b; });
+    auto sc = d.subscribe(topic, [&c](std::string_view) { ++c; });
+    CHECK_THROW(d.subscribe(topic, [](std::string_view) {}), std::length_error);
+    /// Middle, head and tail of the list
+    CHECK(d.unsubscribe(sb));
+    CHECK_EQUAL(2u, d.publish(topic, "x"));
+    CHECK(d.unsubscribe(sa));
+    CHECK_EQUAL(1u, d.publish(topic, "x"));
+    CHECK(d.unsubscribe(sc));
+    CHECK_EQUAL(0u, d.publish(topic, "x"));
+    CHECK_EQUAL(1, a);
+    CHECK_EQUAL(0, b);
+    CHECK_EQUAL(2, c);
+    CHECK(!d.unsubscribe(sa));
+    CHECK(!d.unsubscribe(decltype(sa)()));
+    /// Entries are reused, and stale handles do not remove new subscriptions
+    auto sd = d.subscribe(topic, [&a](std::string_view) { a += 10; });
+    CHECK(!d.unsubscribe(sc));
+    CHECK_EQUAL(1u, d.publish(topic, "x"));
+    CHECK_EQUAL(11, a);
+    CHECK(d.unsubscribe(sd));
+    CHECK_EQUAL(0u, d.subscriber_count());
+}
+
+TEST(dispatcher_callback_lifetime) {
+    auto counter = std::make_shared<int>(0);
+    {
+        rttl::dispatcher<1, 2, 32, void(int)> d;
+        auto sub = d.subscribe("n", [counter](int n) { *counter += n; });
+        d.subscribe("n", [counter](int n) { *counter += 2 * n; });
+        CHECK_EQUAL(3, counter.use_count());
+        CHECK_EQUAL(2u, d.publish("n", 1));
+        CHECK_EQUAL(3, *counter);
+        d.unsubscribe(sub);
+        CHECK_EQUAL(2, counter.use_count());
+    }
+    CHECK_EQUAL(1, counter.use_count());
+}
+
+TEST(dispatcher_throwing_callable) {
+    struct throwing {
+        throwing() = default;
+        throwing(const throwing&) {
+            throw std::runtime_error("copy");
+        }
+        void operator()(int) const {}
+    };
+    rttl::dispatcher<1, 1, 32, void(int)> d;
+    throwing callable;
+    CHECK_THROW(d.subscribe("n", callable), std::runtime_error);
+    CHECK_THROW(d.subscribe("n", callable), std::runtime_error);
+    CHECK_EQUAL(0u, d.subscriber_count());
+    /// The only entry is still available
+    int calls = 0;
+    auto sub = d.subscribe("n", [&calls](int) { ++calls; });
+    CHECK_EQUAL(1u, d.publish("n", 1));
+    CHECK_EQUAL(1, calls);
+    CHECK_THROW(d.subscribe("n", [](int) {}), std::length_error);
+    /// Also when it is reused after unsubscribing
+    d.unsubscribe(sub);
+    CHECK_THROW(d.subscribe("n", callable), std::runtime_error);
+    d.subscribe("n", [&calls](int) { ++calls; });
+    CHECK_EQUAL(1u, d.publish("n", 1));
+    CHECK_EQUAL(2, calls);
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/edit_distance.h"
+
+/// Reference dynamic programming
+static std::size_t levenshtein(const std::string& a, const std::string& b) {
+    std::vector<std::size_t> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            std::size_t above = row[j];
+            row[j] = std::min({ row[j] + 1, row[j - 1] + 1,
+                                diagonal + (a[i - 1] != b[j - 1] ? 1u : 0u) });
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+/// Random string of `length` characters out of the first `alphabet` letters
+static std::string random_string(std::size_t length, unsigned alphabet,
+                                 unsigned& seed) {
+    std::string result;
+    for (std::size_t i = 0; i < length; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        result += static_cast<char>('a' + (seed >> 16) % alphabet);
+    }
+    return result;
+}
+
+TEST(edit_distance_1) {
+    CHECK_EQUAL(3u, rttl::edit_distance("kitten", "sitting"));
+    CHECK_EQUAL(3u, rttl::edit_distance("sitting", "kitten"));
+    CHECK_EQUAL(0u, rttl::edit_distance("", ""));
+    CHECK_EQUAL(4u, rttl::edit_distance("", "abcd"));
+    CHECK_EQUAL(0u, rttl::edit_distance("AAPL", "AAPL"));
+    CHECK_EQUAL(1u, rttl::edit_distance("AAPL", "APL"));
+
+    /// Bounded
+    CHECK_EQUAL(3u, rttl::edit_distance("kitten", "sitting", 3));
+    CHECK_EQUAL(3u, rttl::edit_distance("kitten", "sitting", 2));
+    CHECK_EQUAL(1u, rttl::edit_distance("", "abcd", 0));
+    CHECK_EQUAL(2u, rttl::edit_distance("abcdefgh", "abcdefghij", 1));
+
+    rttl::string<32> a = "MSFT";
+    rttl::string<16> b = "MSFTX";
+    CHECK_EQUAL(1u, rttl::edit_distance(a, b));
+    CHECK_EQUAL(1u, rttl::edit_distance(a, b, 1));
+    CHECK_EQUAL(1u, rttl::edit_distance(a, b, 0));
+
+    std::string longer(300, 'x');
+    CHECK_THROW(rttl::edit_distance(longer, longer), std::length_error);
+    CHECK_EQUAL(0u, rttl::edit_distance<300>(longer, longer));
+}
+
+TEST(edit_distance_2) {
+    /// Single and multiple words against dynamic programming
+    unsigned seed = 7;
+    for (int round = 0; round < 400; ++round) {
+        std::size_t length_a = seed % 150;
+        std::size_t length_b = (seed >> 8) % 150;
+        unsigned alphabet = 2 + (seed >> 4) % 4;
+        std::string a = random_string(length_a, alphabet, seed);
+        std::string b = random_string(length_b, alphabet, seed);
+        std::size_t expected = levenshtein(a, b);
+        CHECK_EQUAL(expected, rttl::edit_distance(a, b));
+        std::size_t max_k = seed % 40;
+        CHECK_EQUAL(std::min(expected, max_k + 1),
+                    rttl::edit_distance(a, b, max_k));
+    }
+}
+
+TEST(edit_distance_bytes) {
+    /// Every byte value, so every row of the mask table is used
+    std::string all;
+    for (int c = 0; c < 256; ++c) {
+        all += static_cast<char>(c);
+    }
+    std::string shifted = all.substr(1) + all.substr(0, 1);
+    CHECK_EQUAL(levenshtein(all, shifted), rttl::edit_distance(all, shifted));
+    unsigned seed = 11;
+    for (int round = 0; round < 50; ++round) {
+        std::string a = random_string(seed % 200, 200, seed);
+        std::string b = random_string((seed >> 8) % 200, 200, seed);
+        CHECK_EQUAL(levenshtein(a, b), rttl::edit_distance(a, b));
+    }
+}
+
+TEST(edit_distances) {
+    rttl::vector<rttl::string<32>, 8> candidates = {
+        "AAPL", "AAP", "APPL", "MSFT", "", "AAPLE" };
+    rttl::vector<std::size_t, 8> out;
+    rttl::edit_distances("AAPL", candidates, 1, out);
+    const std::size_t expected[] = { 0, 1, 1, 2, 2, 1 };
+    CHECK_EQUAL(6u, out.size());
+    CHECK_ARRAY_EQUAL(expected, out.data(), 6);
+
+    rttl::vector<std::size_t, 4> small;
+    CHECK_THROW(rttl::edit_distances("AAPL", candidates, 1, small),
+                std::length_error);
+    CHECK(small.empty());
+
+    unsigned seed = 11;
+    std::string query = random_string(100, 3, seed);
+    std::vector<std::string> texts;
+    for (int i = 0; i < 20; ++i) {
+        texts.push_back(random_string(seed % 130, 3, seed));
+    }
+    rttl::vector<std::size_t, 32> distances;
+    rttl::edit_distances(query, texts, rttl::edit_distance_unbounded,
+                         distances);
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+        CHECK_EQUAL(levenshtein(query, texts[i]), distances[i]);
+    }
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,147 @@
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/group_by.h"
+#include "rttl/string.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+
+struct trade {
+    int symbol;
+    double price;
+    int quantity;
+};
+
+struct expected_group {
+    std::size_t count = 0;
+    long volume = 0;
+    double notional = 0;
+    double low = 1e9;
+    double high = 0;
+};
+
+rttl::vector<trade, 2000> make_trades() {
+    rttl::vector<trade, 2000> trades;
+    std::uint32_t x = 42;
+    for (int i = 0; i < 2000; ++i) {
+        x = x * 1664525 + 1013904223;
+        int symbol = static_cast<int>(x >> 8) % 97 * 1024;
+        trades.push_back({ symbol, 100 + (x % 1000) / 100.0,
+                           static_cast<int>(x % 50) + 1 });
+    }
+    return trades;
+}
+
+std::map<int, expected_group> expected(const rttl::vector<trade, 2000>& trades) {
+    std::map<int, expected_group> result;
+    for (const trade& t : trades) {
+        expected_group& g = result[t.symbol];
+        ++g.count;
+        g.volume += t.quantity;
+        g.notional += t.price * t.quantity;
+        g.low = std::min(g.low, t.price);
+        g.high = std::max(g.high, t.price);
+    }
+    return result;
+}
+
+auto symbol_of = [](const trade& t) { return t.symbol; };
+auto price_of = [](const trade& t) { return t.price; };
+auto quantity_of = [](const trade& t) { return static_cast<long>(t.quantity); };
+
+template <typename Rows>
+void check_rows(const Rows& rows, const std::map<int, expected_group>& groups) {
+    CHECK_EQUAL(groups.size(), rows.size());
+    for (const auto& row : rows) {
+        auto it = groups.find(row.key);
+        CHECK(it != groups.end());
+        const expected_group& g = it->second;
+        CHECK_EQUAL(g.count, std::get<0>(row.values));
+        CHECK_EQUAL(g.volume, std::get<1>(row.values));
+        CHECK_CLOSE(g.notional / static_cast<double>(g.volume), std::get<2>(row.values), 1e-9);
+        CHECK_EQUAL(g.low, std::get<3>(row.values));
+        CHECK_EQUAL(g.high, std::get<4>(row.values));
+    }
+}
+
+}
+
+/// Count, volume, VWAP, low and high of a symbol
+using trade_row = rttl::group_row<int, std::size_t, long, double, double, double>;
+
+TEST(group_by) {
+    auto trades = make_trades();
+    static rttl::vector<trade_row, 128> rows;
+    rttl::group_by(trades, symbol_of, rows,
+        rttl::aggregate::count(), rttl::aggregate::sum(quantity_of),
+        rttl::aggregate::weighted_mean(price_of, quantity_of),
+        rttl::aggregate::min(price_of), rttl::aggregate::max(price_of));
+    check_rows(rows, expected(trades));
+    /// Order of first appearance
+    CHECK_EQUAL(trades[0].symbol, rows[0].key);
+    /// The table is reused by the next call, and rows are replaced
+    trades.resize(10);
+    rttl::group_by(trades, symbol_of, rows,
+        rttl::aggregate::count(), rttl::aggregate::sum(quantity_of),
+        rttl::aggregate::weighted_mean(price_of, quantity_of),
+        rttl::aggregate::min(price_of), rttl::aggregate::max(price_of));
+    check_rows(rows, expected(trades));
+}
+
+TEST(group_by_sorted) {
+    auto trades = make_trades();
+    std::stable_sort(trades.begin(), trades.end(), [](const trade& a, const trade& b) {
+        return a.symbol < b.symbol;
+    });
+    static rttl::vector<trade_row, 128> rows;
+    rttl::group_by_sorted(trades, symbol_of, rows,
+        rttl::aggregate::count(), rttl::aggregate::sum(quantity_of),
+        rttl::aggregate::weighted_mean(price_of, quantity_of),
+        rttl::aggregate::min(price_of), rttl::aggregate::max(price_of));
+    check_rows(rows, expected(trades));
+    CHECK(std::is_sorted(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.key < b.key;
+    }));
+}
+
+TEST(group_by_string_keys) {
+    rttl::vector<rttl::string<8>, 6> words;
+    for (const char* w : { "bid", "ask", "bid", "trade", "ask", "bid" }) {
+        words.push_back(w);
+    }
+    rttl::vector<rttl::group_row<rttl::string<8>, std::size_t, double>, 4> rows;
+    rttl::group_by(words, [](const rttl::string<8>& s) { return s; }, rows,
+        rttl::aggregate::count(),
+        rttl::aggregate::mean([](const rttl::string<8>& s) { return s.size(); }));
+    CHECK_EQUAL(3u, rows.size());
+    CHECK(rows[0].key == "bid"sv);
+    CHECK_EQUAL(3u, std::get<0>(rows[0].values));
+    CHECK(rows[2].key == "trade"sv);
+    CHECK_EQUAL(5.0, std::get<1>(rows[2].values));
+}
+
+TEST(group_by_capacity) {
+    auto trades = make_trades();
+    rttl::vector<rttl::group_row<int, std::size_t>, 8> rows;
+    CHECK_THROW(rttl::group_by(trades, symbol_of, rows, rttl::aggregate::count()),
+                std::length_error);
+    CHECK(rows.empty());
+    CHECK_THROW(rttl::group_by_sorted(trades, symbol_of, rows, rttl::aggregate::count()),
+                std::length_error);
+    CHECK_EQUAL(8u, rows.size());
+    /// The table recovers after a failed call
+    trades.resize(3);
+    rttl::group_by(trades, symbol_of, rows, rttl::aggregate::count());
+    CHECK_EQUAL(expected(trades).size(), rows.size());
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,156 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/hdr_histogram.h"
+
+using TestHistogram = rttl::hdr_histogram<1, 3600000000, 3>;
+
+TEST(parameters) {
+    CHECK_EQUAL(1, TestHistogram::min_value());
+    CHECK_EQUAL(3600000000, TestHistogram::max_value());
+    CHECK_EQUAL(3, TestHistogram::significant_digits());
+    /// Same layout as HdrHistogram of the same parameters
+    CHECK_EQUAL(23552u, TestHistogram::bucket_count());
+}
+
+TEST(equivalent_values) {
+    /// Values below 2048 are exact, above them buckets double in width
+    CHECK_EQUAL(1, TestHistogram::equivalent_range(1000));
+    CHECK_EQUAL(1000, TestHistogram::lowest_equivalent(1000));
+    CHECK_EQUAL(2047, TestHistogram::highest_equivalent(2047));
+    CHECK_EQUAL(2, TestHistogram::equivalent_range(2048));
+    CHECK_EQUAL(8, TestHistogram::equivalent_range(10009));
+    CHECK_EQUAL(10000, TestHistogram::lowest_equivalent(10007));
+    CHECK_EQUAL(10015, TestHistogram::highest_equivalent(10008));
+    CHECK_EQUAL(10004, TestHistogram::median_equivalent(10001));
+}
+
+TEST(record) {
+    TestHistogram h;
+    CHECK_EQUAL(0, h.total_count());
+    CHECK_EQUAL(0, h.value_at_percentile(50.0));
+    CHECK(h.record(1000));
+    CHECK(h.record(100000000));
+    CHECK(h.record(1000, 2));
+    CHECK(!h.record(-1));
+    CHECK(!h.record(3600000001));
+    CHECK_EQUAL(4, h.total_count());
+    CHECK_EQUAL(3, h.count_at(1000));
+    CHECK_EQUAL(1, h.count_at(100000000));
+    CHECK_EQUAL(1000, h.min());
+    CHECK(h.max() >= 100000000 && h.max() <= 100100000);
+    h.reset();
+    CHECK_EQUAL(0, h.total_count());
+}
+
+TEST(percentiles) {
+    /// 10000 values of 1000 and one of 100000000
+    rttl::hdr_histogram<1, 3600000000, 3> h;
+    for (int i = 0; i < 10000; ++i) {
+        h.record(1000);
+    }
+    h.record(100000000);
+    CHECK_EQUAL(1000, h.value_at_percentile(30.0));
+    CHECK_EQUAL(1000, h.value_at_percentile(99.0));
+    CHECK_EQUAL(1000, h.value_at_percentile(99.99));
+    CHECK(h.value_at_percentile(100.0) >= 100000000);
+    CHECK(h.value_at_percentile(100.0) <= 100100000);
+    CHECK_CLOSE((10000 * 1000.0 + 100000000.0) / 10001.0, h.mean(), 10.0);
+
+    rttl::hdr_histogram<1, 1000000, 2> linear;
+    for (int i = 1; i <= 100; ++i) {
+        linear.record(i);
+    }
+    CHECK_EQUAL(50, linear.value_at_percentile(50.0));
+    CHECK_EQUAL(90, linear.value_at_percentile(90.0));
+    CHECK_EQUAL(1, linear.value_at_percentile(0.0));
+}
+
+TEST(min_value_resolution) {
+    rttl::hdr_histogram<1000, 1000000000, 2> h;
+    h.record(1500);
+    h.record(1100);
+    CHECK_EQUAL(2, h.count_at(1024));
+    CHECK_EQUAL(1024, h.min());
+    CHECK_EQUAL(1535, h.max());
+}
+
+TEST(add) {
+    TestHistogram h1;
+    TestHistogram h2;
+    h1.record(10);
+    h2.record(10);
+    h2.record(20000);
+    h1.add(h2);
+    CHECK_EQUAL(3, h1.total_count());
+    CHECK_EQUAL(2, h1.count_at(10));
+    CHECK_EQUAL(1, h1.count_at(20000));
+}
+
+TEST(atomic_record) {
+    rttl::atomic_hdr_histogram<1, 1000000, 3> h;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                h.record(t * 1000 + i % 100);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    CHECK_EQUAL(40000, h.total_count());
+    CHECK_EQUAL(100, h.count_at(1042));
+    rttl::hdr_histogram<1, 1000000, 3> merged;
+    merged.add(h);
+    CHECK_EQUAL(40000, merged.total_count());
+}
+
+TEST(serialize) {
+    TestHistogram h;
+    h.record(1, 5);
+    h.record(1000, 7);
+    h.record(123456789, 1000000);
+    rttl::vector<std::uint8_t, 64> buf;
+    h.serialize(buf);
+    CHECK(buf.size() < 32u);
+    TestHistogram h2;
+    h2.record(5);
+    h2.deserialize(buf.data(), buf.size());
+    CHECK_EQUAL(1000012, h2.total_count());
+    CHECK_EQUAL(5, h2.count_at(1));
+    CHECK_EQUAL(7, h2.count_at(1000));
+    CHECK_EQUAL(1000000, h2.count_at(123456789));
+    CHECK_EQUAL(0, h2.count_at(5));
+    CHECK_THROW(h2.deserialize(buf.data(), buf.size() - 1),
+                std::invalid_argument);
+    CHECK_EQUAL(buf.size(), h.serialized_size());
+    /// Nothing is appended when the output does not fit
+    rttl::vector<std::uint8_t, 8> small(3, std::uint8_t{ 0xAB });
+    CHECK_THROW(h.serialize(small), std::length_error);
+    CHECK_EQUAL(3u, small.size());
+}
+
+TEST(serialize_invalid) {
+    TestHistogram h;
+    CHECK(!h.record(1, -1));
+    CHECK_EQUAL(0, h.total_count());
+    /// Zigzag varint of the minimum count, a run no histogram can have
+    const std::uint8_t crafted[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    CHECK_THROW(h.deserialize(crafted, sizeof(crafted)),
+                std::invalid_argument);
+    /// One empty bucket more than there are left
+    rttl::vector<std::uint8_t, 64> buf;
+    h.serialize(buf);
+    CHECK_EQUAL(buf.size(), h.serialized_size());
+    buf.push_back(0x01);
+    CHECK_THROW(h.deserialize(buf.data(), buf.size()), std::invalid_argument);
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
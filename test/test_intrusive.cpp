@@ -0,0 +1,215 @@
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/intrusive.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+
+struct session {
+    std::uint32_t id = 0;
+    rttl::string<16> user;
+    rttl::intrusive_list_hook lru;
+    rttl::intrusive_list_hook by_user;
+    rttl::intrusive_hash_hook by_id;
+};
+
+struct session_id {
+    std::uint32_t operator()(const session& s) const noexcept {
+        return s.id;
+    }
+};
+
+using lru_list = rttl::intrusive_list<session, &session::lru>;
+using user_list = rttl::intrusive_list<session, &session::by_user>;
+using id_set = rttl::intrusive_hash_set<session, &session::by_id, 7, session_id>;
+
+template <typename List>
+rttl::vector<std::uint32_t, 16> ids(const List& list) {
+    rttl::vector<std::uint32_t, 16> result;
+    for (const session& s : list) {
+        result.push_back(s.id);
+    }
+    return result;
+}
+
+rttl::vector<std::uint32_t, 16> make_ids(std::initializer_list<std::uint32_t> ilist) {
+    return rttl::vector<std::uint32_t, 16>(ilist);
+}
+
+}
+
+TEST(intrusive_list) {
+    rttl::vector<session, 8> sessions(5);
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        sessions[i].id = i;
+    }
+    lru_list lru;
+    CHECK(lru.empty());
+    for (session& s : sessions) {
+        lru.push_back(s);
+    }
+    CHECK_EQUAL(5u, lru.size());
+    CHECK(ids(lru) == make_ids({ 0, 1, 2, 3, 4 }));
+    CHECK_EQUAL(0u, lru.front().id);
+    CHECK_EQUAL(4u, lru.back().id);
+    /// Touching an element moves it to the back
+    lru.move(lru.end(), sessions[1]);
+    CHECK(ids(lru) == make_ids({ 0, 2, 3, 4, 1 }));
+    lru.pop_front();
+    lru.erase(lru.iterator_to(sessions[3]));
+    CHECK(ids(lru) == make_ids({ 2, 4, 1 }));
+    CHECK(!sessions[0].lru.is_linked());
+    lru.push_front(sessions[0]);
+    CHECK(ids(lru) == make_ids({ 0, 2, 4, 1 }));
+    CHECK_THROW(lru.push_back(sessions[2]), std::invalid_argument);
+    rttl::vector<std::uint32_t, 16> reversed;
+    for (auto it = lru.rbegin(); it != lru.rend(); ++it) {
+        reversed.push_back(it->id);
+    }
+    CHECK(reversed == make_ids({ 1, 4, 2, 0 }));
+    lru.clear();
+    CHECK(lru.empty());
+    for (const session& s : sessions) {
+        CHECK(!s.lru.is_linked());
+    }
+}
+
+TEST(intrusive_list_splice) {
+    rttl::vector<session, 8> sessions(4);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        sessions[i].id = i;
+    }
+    lru_list a;
+    lru_list b;
+    a.push_back(sessions[0]);
+    a.push_back(sessions[3]);
+    b.push_back(sessions[1]);
+    b.push_back(sessions[2]);
+    a.splice(++a.begin(), b);
+    CHECK(b.empty());
+    CHECK(ids(a) == make_ids({ 0, 1, 2, 3 }));
+    b.splice(b.end(), a);
+    CHECK(a.empty());
+    CHECK_EQUAL(4u, b.size());
+}
+
+TEST(intrusive_several_hooks) {
+    rttl::vector<session, 8> sessions(4);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        sessions[i].id = i;
+        sessions[i].user = (i % 2 == 0) ? "alice" : "bob";
+    }
+    lru_list lru;
+    user_list alice;
+    for (session& s : sessions) {
+        lru.push_back(s);
+        if (s.user == "alice"sv) {
+            alice.push_back(s);
+        }
+    }
+    CHECK(ids(alice) == make_ids({ 0, 2 }));
+    alice.erase(alice.begin());
+    /// Other lists are not affected
+    CHECK(ids(lru) == make_ids({ 0, 1, 2, 3 }));
+    CHECK(ids(alice) == make_ids({ 2 }));
+}
+
+TEST(intrusive_auto_unlink) {
+    lru_list lru;
+    id_set set;
+    session a;
+    a.id = 1;
+    lru.push_back(a);
+    {
+        session b;
+        b.id = 2;
+        lru.push_back(b);
+        set.insert(b);
+        CHECK_EQUAL(2u, lru.size());
+        CHECK(set.contains(2u));
+    }
+    CHECK_EQUAL(1u, lru.size());
+    CHECK(!set.contains(2u));
+    CHECK(set.empty());
+    /// Copies are not linked, and assignment keeps links
+    session c = a;
+    CHECK(!c.lru.is_linked());
+    a = c;
+    CHECK(a.lru.is_linked());
+    /// Destroying a list unlinks its elements
+    {
+        lru_list other;
+        other.push_back(c);
+    }
+    CHECK(!c.lru.is_linked());
+}
+
+TEST(intrusive_hash_set) {
+    rttl::vector<session, 16> sessions(12);
+    for (std::uint32_t i = 0; i < 12; ++i) {
+        sessions[i].id = i * 10;
+    }
+    id_set set;
+    for (session& s : sessions) {
+        CHECK(set.insert(s).second);
+    }
+    CHECK_EQUAL(12u, set.size());
+    CHECK_THROW(set.insert(sessions[0]), std::invalid_argument);
+    session duplicate;
+    duplicate.id = 30;
+    auto [it, inserted] = set.insert(duplicate);
+    CHECK(!inserted);
+    CHECK_EQUAL(&sessions[3], &*it);
+    CHECK(!duplicate.by_id.is_linked());
+    CHECK_EQUAL(&sessions[5], &*set.find(50u));
+    CHECK(set.find(55u) == set.end());
+    CHECK_EQUAL(1u, set.count(110u));
+    CHECK_EQUAL(1u, set.erase(110u));
+    CHECK_EQUAL(0u, set.erase(110u));
+    set.erase(set.iterator_to(sessions[0]));
+    sessions[7].by_id.unlink();
+    CHECK_EQUAL(9u, set.size());
+    std::uint32_t sum = 0;
+    for (const session& s : set) {
+        sum += s.id;
+    }
+    CHECK_EQUAL(660u - 110u - 70u, sum);
+    /// Erasing while iterating
+    for (auto i = set.begin(); i != set.end();) {
+        i = (i->id % 20 == 0) ? set.erase(i) : std::next(i);
+    }
+    CHECK_EQUAL(4u, set.size());
+    set.clear();
+    CHECK(set.empty());
+    CHECK(!sessions[1].by_id.is_linked());
+}
+
+TEST(intrusive_hash_set_string_keys) {
+    struct user {
+        rttl::string<16> name;
+        rttl::intrusive_hash_hook hook;
+    };
+    struct name_of {
+        std::string_view operator()(const user& u) const noexcept {
+            return u.name;
+        }
+    };
+    rttl::intrusive_hash_set<user, &user::hook, 4, name_of> users;
+    user a{ rttl::string<16>("alice"), {} };
+    user b{ rttl::string<16>("bob"), {} };
+    users.insert(a);
+    users.insert(b);
+    CHECK_EQUAL(&b, &*users.find("bob"sv));
+    CHECK(!users.contains("carol"sv));
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
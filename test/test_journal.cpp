@@ -0,0 +1,216 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/journal.h"
+
+using namespace std::string_view_literals;
+
+/// Path of a new empty temporary file
+static std::string temp_path() {
+    char path[] = "/tmp/rttl_journal_XXXXXX";
+    int fd = ::mkstemp(path);
+    CHECK(fd >= 0);
+    ::close(fd);
+    return path;
+}
+
+TEST(crc32c) {
+    /// Check value of the CRC-32C catalogue
+    CHECK_EQUAL(0xE3069283u, rttl::detail::crc32c(0, "123456789", 9));
+    std::uint32_t crc = rttl::detail::crc32c(0, "1234", 4);
+    CHECK_EQUAL(0xE3069283u, rttl::detail::crc32c(crc, "56789", 5));
+}
+
+TEST(journal_write_read) {
+    std::string path = temp_path();
+    {
+        rttl::journal_writer<256> writer(path.c_str());
+        CHECK_EQUAL(1u, writer.append("first"));
+        CHECK_EQUAL(2u, writer.append(""));
+        rttl::string<16> record = "third";
+        auto seq = writer.append(record.data(), record.size());
+        CHECK_EQUAL(3u, seq);
+        writer.wait(seq);
+        CHECK_EQUAL(3u, writer.durable());
+        CHECK_THROW(writer.append(std::string(249, 'x')), std::length_error);
+        CHECK_EQUAL(4u, writer.append(std::string(248, 'x')));
+        CHECK_EQUAL(4u, writer.flush());
+    }
+
+    rttl::journal_reader reader(path.c_str());
+    rttl::string<16> record;
+    CHECK(reader.next(record));
+    CHECK(record == "first"sv);
+    CHECK(reader.next(record));
+    CHECK(record.empty());
+    CHECK(reader.next(record));
+    CHECK(record == "third"sv);
+    CHECK_THROW(reader.next(record), std::length_error);
+    CHECK(reader.skip());
+    CHECK(!reader.next(record));
+    CHECK_EQUAL(4u, reader.count());
+    CHECK_EQUAL(4 * rttl::journal_header_size + 5 + 5 + 248, reader.offset());
+    ::unlink(path.c_str());
+}
+
+TEST(journal_recovery) {
+    std::string path = temp_path();
+    {
+        rttl::journal_writer<1024> writer(path.c_str());
+        writer.append("one");
+        writer.append("two");
+        writer.flush();
+    }
+    /// Torn record at the tail
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        const unsigned char torn[] = { 10, 0, 0, 0, 1, 2, 3, 4, 't', 'h' };
+        CHECK_EQUAL(static_cast<ssize_t>(sizeof(torn)),
+                    ::write(fd, torn, sizeof(torn)));
+        ::close(fd);
+    }
+    {
+        rttl::journal_reader reader(path.c_str());
+        while (reader.skip()) {}
+        CHECK_EQUAL(2u, reader.count());
+    }
+    {
+        /// Sequence numbers continue after the valid records
+        rttl::journal_writer<1024> writer(path.c_str());
+        CHECK_EQUAL(2u, writer.durable());
+        CHECK_EQUAL(3u, writer.append("three"));
+        writer.flush();
+    }
+    /// Corrupt payload
+    {
+        int fd = ::open(path.c_str(), O_WRONLY);
+        CHECK_EQUAL(1, ::pwrite(fd, "T", 1, 2 * rttl::journal_header_size + 4));
+        ::close(fd);
+    }
+    rttl::journal_reader reader(path.c_str());
+    rttl::string<8> record;
+    CHECK(reader.next(record));
+    CHECK(record == "one"sv);
+    CHECK(!reader.next(record));
+    CHECK(record.empty());
+    CHECK_EQUAL(1u, reader.count());
+    ::unlink(path.c_str());
+}
+
+TEST(journal_corrupt_length) {
+    std::string path = temp_path();
+    {
+        rttl::journal_writer<1024> writer(path.c_str());
+        writer.append("one");
+        writer.flush();
+    }
+    /// Garbage length at the tail, beyond any capacity and the file size
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        const unsigned char torn[] = { 0xFF, 0xFF, 0xFF, 0x7F, 1, 2, 3, 4, 'x' };
+        CHECK_EQUAL(static_cast<ssize_t>(sizeof(torn)),
+                    ::write(fd, torn, sizeof(torn)));
+        ::close(fd);
+    }
+    {
+        rttl::journal_reader reader(path.c_str());
+        rttl::string<8> record;
+        CHECK(reader.next(record));
+        CHECK(!reader.next(record));
+        CHECK_EQUAL(1u, reader.count());
+    }
+    {
+        rttl::journal_writer<1024> writer(path.c_str());
+        CHECK_EQUAL(1u, writer.durable());
+        CHECK_EQUAL(2u, writer.append("two"));
+        writer.flush();
+    }
+    rttl::journal_reader reader(path.c_str());
+    while (reader.skip()) {}
+    CHECK_EQUAL(2u, reader.count());
+    CHECK_EQUAL(2 * rttl::journal_header_size + 6, reader.offset());
+    ::unlink(path.c_str());
+}
+
+TEST(journal_write_error) {
+    std::string path = temp_path();
+    /// The writer opens its descriptor first, at the lowest free number
+    int fd = ::open("/dev/null", O_RDONLY);
+    ::close(fd);
+    {
+        rttl::journal_writer<256> writer(path.c_str());
+        auto first = writer.append("first");
+        writer.wait(first);
+        /// Writes fail once the descriptor is replaced by a read-only one
+        int read_only = ::open(path.c_str(), O_RDONLY);
+        CHECK(read_only >= 0);
+        CHECK_EQUAL(fd, ::dup2(read_only, fd));
+        ::close(read_only);
+        auto lost = writer.append("lost");
+        CHECK_THROW(writer.wait(lost), std::system_error);
+        /// Neither a later batch nor any wait reports the lost record durable
+        CHECK_THROW(writer.append("later"), std::system_error);
+        CHECK_THROW(writer.flush(), std::system_error);
+        CHECK_THROW(writer.wait(lost), std::system_error);
+        CHECK_EQUAL(first, writer.durable());
+        writer.wait(first);
+    }
+    rttl::journal_reader reader(path.c_str());
+    while (reader.skip()) {}
+    CHECK_EQUAL(1u, reader.count());
+    ::unlink(path.c_str());
+}
+
+TEST(journal_group_commit) {
+    std::string path = temp_path();
+    constexpr int thread_count = 4;
+    constexpr int record_count = 500;
+    {
+        rttl::journal_options options;
+        options.commit_bytes = 1024;
+        options.commit_interval = std::chrono::microseconds(200);
+        rttl::journal_writer<4096> writer(path.c_str(), options);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&writer, t]() {
+                for (int i = 0; i < record_count; ++i) {
+                    std::string record = std::to_string(t) + ":" +
+                                         std::to_string(i);
+                    auto seq = writer.append(record);
+                    if (i % 100 == 99) {
+                        writer.wait(seq);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK_EQUAL(static_cast<std::uint64_t>(thread_count * record_count),
+                    writer.appended());
+    }
+
+    /// Records of every thread are durable and in order
+    rttl::journal_reader reader(path.c_str());
+    std::vector<int> next(thread_count, 0);
+    rttl::string<16> record;
+    while (reader.next(record)) {
+        std::string text(record.data(), record.size());
+        auto colon = text.find(':');
+        int t = std::stoi(text.substr(0, colon));
+        CHECK_EQUAL(next[static_cast<std::size_t>(t)],
+                    std::stoi(text.substr(colon + 1)));
+        ++next[static_cast<std::size_t>(t)];
+    }
+    CHECK_EQUAL(static_cast<std::uint64_t>(thread_count * record_count),
+                reader.count());
+    ::unlink(path.c_str());
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/memory.h"
+#include "rttl/string.h"
+#include "rttl/vector.h"
+
+static rttl::vector<std::uint64_t, 1024 * 1024> big_vector;
+static rttl::string<100000> big_string;
+
+static std::size_t pages_spanned(const void* data, std::size_t size) {
+    auto page = rttl::memory::page_size();
+    auto first = reinterpret_cast<std::uintptr_t>(data) / page;
+    auto last = (reinterpret_cast<std::uintptr_t>(data) + size - 1) / page;
+    return last - first + 1;
+}
+
+TEST(prefault) {
+    big_vector.push_back(42);
+    auto r = rttl::memory::prefault(big_vector);
+    CHECK_EQUAL(pages_spanned(&big_vector, sizeof(big_vector)), r.pages_touched);
+    CHECK(r.huge_page_bytes <= sizeof(big_vector));
+    /// Contents are preserved
+    CHECK_EQUAL(1u, big_vector.size());
+    CHECK_EQUAL(42u, big_vector[0]);
+
+    char small[10] = { 1, 2, 3 };
+    r = rttl::memory::prefault(small);
+    CHECK(r.pages_touched == 1 || r.pages_touched == 2);
+    CHECK_EQUAL(0u, r.huge_page_bytes);
+    CHECK_EQUAL(3, small[2]);
+    CHECK_EQUAL(0u, rttl::memory::prefault(small, 0).pages_touched);
+}
+
+TEST(lock) {
+    char small[10] = {};
+    /// Locking may be not permitted, but must not fail otherwise
+    if (rttl::memory::lock(small)) {
+        CHECK(munlock(small, sizeof(small)) == 0);
+    }
+}
+
+TEST(registry) {
+    CHECK_EQUAL(0u, rttl::memory::registered_count());
+    rttl::memory::register_container(big_vector);
+    rttl::memory::register_container(big_string);
+    CHECK_EQUAL(2u, rttl::memory::registered_count());
+    auto r = rttl::memory::prefault_registered();
+    CHECK_EQUAL(pages_spanned(&big_vector, sizeof(big_vector)) +
+                pages_spanned(&big_string, sizeof(big_string)),
+                r.pages_touched);
+    CHECK_EQUAL(0u, r.locked_bytes);
+
+    rttl::memory::unregister_region(&big_string);
+    CHECK_EQUAL(1u, rttl::memory::registered_count());
+    rttl::memory::unregister_region(&big_vector);
+    CHECK_EQUAL(0u, rttl::memory::registered_count());
+
+    char buf[16];
+    for (std::size_t i = 0; i < rttl::memory::max_registered; ++i) {
+        rttl::memory::register_region(buf, sizeof(buf));
+    }
+    CHECK_THROW(rttl::memory::register_region(buf, sizeof(buf)),
+                std::length_error);
+    rttl::memory::unregister_region(buf);
+    CHECK_EQUAL(0u, rttl::memory::registered_count());
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <cstring>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/packet_buffer.h"
+
+using TestBuffer = rttl::packet_buffer<16, 64>;
+
+TEST(initial_state) {
+    TestBuffer b;
+    CHECK(b.empty());
+    CHECK_EQUAL(0u, b.size());
+    CHECK_EQUAL(16u, b.headroom());
+    CHECK_EQUAL(64u, b.tailroom());
+    CHECK_EQUAL(80u, TestBuffer::max_size());
+    CHECK(b.begin() == b.end());
+}
+
+TEST(encapsulation) {
+    /// Payload, then 2-byte length prefix, then 4-byte transport header
+    TestBuffer b;
+    b.append("hello", 5);
+    const std::uint8_t* payload = b.data();
+    auto length = static_cast<std::uint16_t>(b.size());
+    b.push_header(2).put_be(length);
+    b.push_header(4).put_be(std::uint16_t(0xABCD)).put_le(std::uint16_t(0x1234));
+    b.push_trailer(1).put_be(std::uint8_t(0x7F));
+    CHECK_EQUAL(12u, b.size());
+    CHECK_EQUAL(10u, b.headroom());
+    /// Payload is not moved
+    CHECK(payload == b.data() + 6);
+
+    const std::uint8_t expected[] = { 0xAB, 0xCD, 0x34, 0x12, 0x00, 0x05,
+                                      'h', 'e', 'l', 'l', 'o', 0x7F };
+    CHECK_ARRAY_EQUAL(expected, b.data(), 12);
+
+    auto r = b.read();
+    CHECK_EQUAL(0xABCD, r.get_be<std::uint16_t>());
+    CHECK_EQUAL(0x1234, r.get_le<std::uint16_t>());
+    CHECK_EQUAL(5, r.get_be<std::uint16_t>());
+    char text[5];
+    r.get(text, 5);
+    CHECK(std::memcmp(text, "hello", 5) == 0);
+    CHECK_EQUAL(1u, r.remaining());
+
+    b.trim_front(4);
+    b.trim_back(1);
+    CHECK_EQUAL(7u, b.size());
+    CHECK_EQUAL(5, b.read(0, 2).get_be<std::uint16_t>());
+}
+
+TEST(typed_cursors) {
+    rttl::packet_buffer<0, 32> b;
+    b.push_trailer(24)
+        .put_be(std::uint64_t(0x0102030405060708))
+        .put_le(std::uint64_t(0x0102030405060708))
+        .put_be<std::int32_t>(-2)
+        .put_le(std::int16_t(-300))
+        .put_be(std::uint8_t(9))
+        .put_le(std::int8_t(-1));
+    CHECK_EQUAL(0x01, b[0]);
+    CHECK_EQUAL(0x08, b[7]);
+    CHECK_EQUAL(0x08, b[8]);
+    CHECK_EQUAL(0x01, b[15]);
+    auto r = b.read(0, 24);
+    CHECK_EQUAL(0x0102030405060708u, r.get_be<std::uint64_t>());
+    CHECK_EQUAL(0x0102030405060708u, r.get_le<std::uint64_t>());
+    CHECK_EQUAL(-2, r.get_be<std::int32_t>());
+    CHECK_EQUAL(-300, r.get_le<std::int16_t>());
+    CHECK_EQUAL(9, r.get_be<std::uint8_t>());
+    CHECK_EQUAL(-1, r.get_le<std::int8_t>());
+    CHECK_EQUAL(0u, r.remaining());
+
+    b.write(4, 4).put_be<std::uint32_t>(0xDEADBEEF);
+    CHECK_EQUAL(0xDEADBEEFu, b.read(4, 4).get_be<std::uint32_t>());
+}
+
+TEST(bounds) {
+    rttl::packet_buffer<4, 8> b;
+    CHECK_THROW(b.prepend(5), std::length_error);
+    CHECK_THROW(b.append(9), std::length_error);
+    b.append("abcdefgh", 8);
+    CHECK_EQUAL(0u, b.tailroom());
+    CHECK_THROW(b.push_trailer(1), std::length_error);
+    b.prepend("1234", 4);
+    CHECK_EQUAL(12u, b.size());
+    CHECK_THROW(b.push_header(1), std::length_error);
+    CHECK_THROW(b.read(10, 3), std::out_of_range);
+    CHECK_THROW(b.write(13, 0), std::out_of_range);
+    CHECK_THROW(b.trim_front(13), std::length_error);
+    CHECK_THROW(b.trim_back(13), std::length_error);
+    CHECK_EQUAL(12u, b.size());
+    /// Empty copies accept null pointers
+    b.append(nullptr, 0);
+    b.prepend(nullptr, 0);
+    b.write(0, 4).put(nullptr, 0);
+    b.read(0, 0).get(nullptr, 0);
+    CHECK_EQUAL(12u, b.size());
+    b.clear();
+    CHECK(b.empty());
+    CHECK_EQUAL(4u, b.headroom());
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/rank_select_bitset.h"
+
+template <std::size_t Bits>
+void check_against_scan(const rttl::rank_select_bitset<Bits>& b) {
+    std::vector<std::size_t> ones;
+    for (std::size_t i = 0; i < Bits; ++i) {
+        CHECK_EQUAL(ones.size(), b.rank(i));
+        if (b[i]) {
+            ones.push_back(i);
+        }
+    }
+    CHECK_EQUAL(ones.size(), b.rank(Bits));
+    CHECK_EQUAL(ones.size(), b.count());
+    for (std::size_t k = 0; k < ones.size(); ++k) {
+        CHECK_EQUAL(ones[k], b.select(k));
+    }
+    CHECK_EQUAL(Bits, b.select(ones.size()));
+}
+
+TEST(empty) {
+    rttl::rank_select_bitset<100> b;
+    CHECK_EQUAL(100u, b.size());
+    CHECK_EQUAL(0u, b.count());
+    CHECK_EQUAL(0u, b.rank(100));
+    CHECK_EQUAL(100u, b.select(0));
+}
+
+TEST(directory_size) {
+    /// Bits take 12504 bytes, the directory about a quarter of that
+    CHECK(sizeof(rttl::rank_select_bitset<100000>) <= 12504 + 12504 / 4 + 32);
+}
+
+TEST(select_in_word) {
+    std::uint64_t x = 0x8000000100010001u;
+    CHECK_EQUAL(0, rttl::detail::select_in_word(x, 0));
+    CHECK_EQUAL(16, rttl::detail::select_in_word(x, 1));
+    CHECK_EQUAL(32, rttl::detail::select_in_word(x, 2));
+    CHECK_EQUAL(63, rttl::detail::select_in_word(x, 3));
+    for (int r = 0; r < 64; ++r) {
+        CHECK_EQUAL(r, rttl::detail::select_in_word(~std::uint64_t(0), r));
+    }
+}
+
+TEST(random_densities) {
+    static rttl::rank_select_bitset<5000> b;
+    std::uint32_t seed = 7;
+    for (unsigned density : { 1u, 10u, 50u, 90u, 100u }) {
+        b.reset();
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            if ((seed >> 8) % 100 < density) {
+                b.set(i);
+            }
+        }
+        b.rebuild();
+        check_against_scan(b);
+    }
+}
+
+TEST(sparse) {
+    /// Superblocks without ones between select samples
+    static rttl::rank_select_bitset<200000> b;
+    for (std::size_t i = 0; i < b.size(); i += 997) {
+        b.set(i);
+    }
+    b.set(b.size() - 1);
+    b.rebuild();
+    CHECK_EQUAL(202u, b.count());
+    for (std::size_t k = 0; k < 201; ++k) {
+        CHECK_EQUAL(k * 997, b.select(k));
+        CHECK_EQUAL(k, b.rank(k * 997));
+        CHECK_EQUAL(k + 1, b.rank(k * 997 + 1));
+    }
+    CHECK_EQUAL(b.size() - 1, b.select(201));
+}
+
+TEST(modifiers) {
+    rttl::rank_select_bitset<70> b;
+    b.set(3).set(64).set(69);
+    b.flip(3);
+    b.reset(64);
+    b.set(10, true);
+    CHECK(b.test(10));
+    CHECK(!b.test(3));
+    CHECK_THROW(b.set(70), std::out_of_range);
+    CHECK_THROW(b.test(70), std::out_of_range);
+    b.rebuild();
+    CHECK_EQUAL(2u, b.count());
+    CHECK_EQUAL(69u, b.select(1));
+
+    b.words()[0] = 0xFF;
+    b.rebuild();
+    CHECK_EQUAL(9u, b.count());
+    check_against_scan(b);
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
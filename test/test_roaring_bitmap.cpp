@@ -0,0 +1,215 @@
+#include <cstdint>
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/roaring_bitmap.h"
+
+using bitmap = rttl::roaring_bitmap<8>;
+
+namespace {
+
+/// Values of several chunks: sparse, dense and runs
+std::set<std::uint32_t> sample(std::uint32_t seed) {
+    std::set<std::uint32_t> result;
+    std::uint32_t x = seed;
+    for (int i = 0; i < 3000; ++i) {
+        x = x * 1664525 + 1013904223;
+        result.insert(x % 65536);
+    }
+    for (int i = 0; i < 20000; ++i) {
+        x = x * 1664525 + 1013904223;
+        result.insert((3u << 16) | (x % 65536));
+    }
+    for (std::uint32_t v = 1000 + seed; v < 9000; ++v) {
+        result.insert((5u << 16) | v);
+    }
+    result.insert(0xFFFFFFFFu);
+    return result;
+}
+
+template <typename Bitmap>
+void fill(Bitmap& b, const std::set<std::uint32_t>& values) {
+    for (std::uint32_t v : values) {
+        b.add(v);
+    }
+}
+
+template <typename Bitmap>
+std::vector<std::uint32_t> contents(const Bitmap& b) {
+    return std::vector<std::uint32_t>(b.begin(), b.end());
+}
+
+}
+
+TEST(roaring_bitmap_add_remove) {
+    static bitmap b;
+    CHECK(b.empty());
+    CHECK(b.add(7));
+    CHECK(!b.add(7));
+    CHECK(b.add(0x10000));
+    CHECK(b.add(0xFFFFFFFFu));
+    CHECK(b.contains(7) && b.contains(0x10000) && b.contains(0xFFFFFFFFu));
+    CHECK(!b.contains(8) && !b.contains(0x10001));
+    CHECK_EQUAL(3u, b.cardinality());
+    CHECK_EQUAL(3u, b.container_count());
+    CHECK(b.remove(0x10000));
+    CHECK(!b.remove(0x10000));
+    CHECK_EQUAL(2u, b.container_count());
+    /// Array to bitmap and back
+    for (std::uint32_t v = 0; v < 10000; v += 2) {
+        b.add(v);
+    }
+    CHECK_EQUAL(5002u, b.cardinality());
+    for (std::uint32_t v = 0; v < 10000; v += 4) {
+        CHECK(b.remove(v));
+    }
+    CHECK_EQUAL(2502u, b.cardinality());
+    CHECK(b.contains(7) && b.contains(9998) && !b.contains(9996));
+    b.clear();
+    CHECK(b.empty());
+    CHECK(b.begin() == b.end());
+}
+
+TEST(roaring_bitmap_capacity) {
+    static rttl::roaring_bitmap<2> b;
+    b.add(1);
+    b.add(0x10001);
+    CHECK_THROW(b.add(0x20001), std::length_error);
+    CHECK_EQUAL(2u, b.cardinality());
+    b.remove(1);
+    b.add(0x20001);
+    CHECK(b.contains(0x20001));
+}
+
+TEST(roaring_bitmap_iteration) {
+    static bitmap b;
+    auto values = sample(1);
+    fill(b, values);
+    CHECK_EQUAL(values.size(), b.cardinality());
+    CHECK(contents(b) == std::vector<std::uint32_t>(values.begin(), values.end()));
+    std::vector<std::uint32_t> seen;
+    b.for_each([&seen](std::uint32_t v) { seen.push_back(v); });
+    CHECK(seen == contents(b));
+    b.run_optimize();
+    CHECK(contents(b) == std::vector<std::uint32_t>(values.begin(), values.end()));
+    seen.clear();
+    b.for_each([&seen](std::uint32_t v) { seen.push_back(v); });
+    CHECK(seen == contents(b));
+    for (std::uint32_t v : { 5000u, 0x51000u, 0x53000u, 0x52327u }) {
+        CHECK_EQUAL(values.count(v) != 0, b.contains(v));
+    }
+}
+
+TEST(roaring_bitmap_run_containers) {
+    static bitmap a;
+    static bitmap b;
+    for (std::uint32_t v = 100; v < 60000; ++v) {
+        a.add(v);
+        b.add(v);
+    }
+    a.run_optimize();
+    CHECK(a == b);
+    CHECK(a.serialized_size() < 20);
+    CHECK(a.remove(200));
+    CHECK(!a.contains(200) && a.contains(201));
+    CHECK(a.add(200));
+    CHECK(a == b);
+}
+
+TEST(roaring_bitmap_set_operations) {
+    /// Run containers on neither side, on the left, and on both sides
+    for (int optimize : { 0, 1, 2 }) {
+        auto va = sample(1);
+        auto vb = sample(2);
+        vb.insert(7u << 16);
+        /// Bitmaps combined with arrays, both ways
+        for (std::uint32_t v = 0; v < 6000; ++v) {
+            va.insert((9u << 16) | v);
+            vb.insert((10u << 16) | (v * 7 % 9000));
+        }
+        for (std::uint32_t v = 0; v < 9000; v += 13) {
+            vb.insert((9u << 16) | v);
+            va.insert((10u << 16) | v);
+        }
+        static bitmap a;
+        static bitmap b;
+        static bitmap r;
+        a.clear();
+        b.clear();
+        fill(a, va);
+        fill(b, vb);
+        if (optimize > 0) {
+            a.run_optimize();
+        }
+        if (optimize > 1) {
+            b.run_optimize();
+        }
+        std::vector<std::uint32_t> expected;
+        r = a;
+        r &= b;
+        std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(),
+                              std::back_inserter(expected));
+        CHECK(contents(r) == expected);
+        CHECK_EQUAL(expected.size(), r.cardinality());
+        expected.clear();
+        r = a;
+        r |= b;
+        std::set_union(va.begin(), va.end(), vb.begin(), vb.end(),
+                       std::back_inserter(expected));
+        CHECK(contents(r) == expected);
+        CHECK_EQUAL(expected.size(), r.cardinality());
+        expected.clear();
+        r = a;
+        r -= b;
+        std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(),
+                            std::back_inserter(expected));
+        CHECK(contents(r) == expected);
+        CHECK_EQUAL(expected.size(), r.cardinality());
+        r = b;
+        r -= b;
+        CHECK(r.empty());
+    }
+}
+
+TEST(roaring_bitmap_union_capacity) {
+    static rttl::roaring_bitmap<2> a;
+    static rttl::roaring_bitmap<2> b;
+    a.add(1);
+    a.add(0x10001);
+    b.add(0x20001);
+    CHECK_THROW(a |= b, std::length_error);
+    CHECK_EQUAL(2u, a.cardinality());
+    b.clear();
+    b.add(0x10002);
+    a |= b;
+    CHECK_EQUAL(3u, a.cardinality());
+}
+
+TEST(roaring_bitmap_serialization) {
+    static bitmap a;
+    static bitmap b;
+    fill(a, sample(3));
+    a.run_optimize();
+    std::vector<std::uint8_t> buffer(a.serialized_size());
+    CHECK_THROW(a.serialize(buffer.data(), buffer.size() - 1), std::length_error);
+    CHECK_EQUAL(buffer.size(), a.serialize(buffer.data(), buffer.size()));
+    b.add(12345678);
+    b.deserialize(buffer.data(), buffer.size());
+    CHECK(a == b);
+    CHECK(contents(a) == contents(b));
+    CHECK_THROW(b.deserialize(buffer.data(), buffer.size() - 1), std::invalid_argument);
+    CHECK(b.empty());
+    /// Descending values in the first container
+    buffer[4 + 7] ^= 0xFF;
+    CHECK_THROW(b.deserialize(buffer.data(), buffer.size()), std::invalid_argument);
+    static rttl::roaring_bitmap<1> small;
+    std::vector<std::uint8_t> data(a.serialized_size());
+    a.serialize(data.data(), data.size());
+    CHECK_THROW(small.deserialize(data.data(), data.size()), std::length_error);
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,207 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/segmented_vector.h"
+#include "element.h"
+
+TEST(push_back) {
+    rttl::segmented_vector<int, 4, 8> v;
+    CHECK(v.empty());
+    CHECK_EQUAL(32u, v.max_size());
+    CHECK_EQUAL(0u, v.capacity());
+
+    std::vector<const int*> addresses;
+    for (int i = 0; i < 30; ++i) {
+        v.push_back(i);
+        addresses.push_back(&v.back());
+    }
+    CHECK_EQUAL(30u, v.size());
+    CHECK_EQUAL(32u, v.capacity());
+    /// Addresses are stable
+    for (int i = 0; i < 30; ++i) {
+        CHECK_EQUAL(i, v[static_cast<std::size_t>(i)]);
+        CHECK_EQUAL(addresses[static_cast<std::size_t>(i)],
+                    &v[static_cast<std::size_t>(i)]);
+    }
+    CHECK_EQUAL(0, v.front());
+    CHECK_EQUAL(29, v.back());
+    CHECK_EQUAL(7, v.at(7));
+    CHECK_THROW(v.at(30), std::out_of_range);
+
+    v.push_back(30);
+    v.push_back(31);
+    CHECK_THROW(v.push_back(32), std::length_error);
+    CHECK_EQUAL(32u, v.size());
+
+    v.pop_back();
+    CHECK_EQUAL(30, v.back());
+    v.clear();
+    CHECK(v.empty());
+    CHECK_THROW(v.pop_back(), std::invalid_argument);
+    CHECK_EQUAL(32u, v.capacity());
+    v.shrink_to_fit();
+    CHECK_EQUAL(0u, v.capacity());
+}
+
+TEST(iterators) {
+    rttl::segmented_vector<int, 8, 16> v;
+    for (int i = 0; i < 100; ++i) {
+        v.push_back(i);
+    }
+    CHECK_EQUAL(100, std::distance(v.begin(), v.end()));
+    CHECK_EQUAL(4950, std::accumulate(v.cbegin(), v.cend(), 0));
+    CHECK(std::is_sorted(v.begin(), v.end()));
+
+    auto it = v.begin() + 50;
+    CHECK_EQUAL(50, *it);
+    CHECK_EQUAL(57, it[7]);
+    --it;
+    CHECK_EQUAL(49, *it);
+    it -= 41;
+    CHECK_EQUAL(8, *it);
+    --it;
+    CHECK_EQUAL(7, *it);
+    CHECK(it < v.end());
+    rttl::segmented_vector<int, 8, 16>::const_iterator cit = it;
+    CHECK(cit == it);
+    CHECK_EQUAL(93, v.cend() - cit);
+
+    std::vector<int> reversed(v.rbegin(), v.rend());
+    CHECK_EQUAL(99, reversed.front());
+    CHECK_EQUAL(0, reversed.back());
+
+    std::sort(v.begin(), v.end(), std::greater<int>());
+    CHECK_EQUAL(99, v[0]);
+    CHECK_EQUAL(0, v[99]);
+
+    std::vector<std::size_t> runs;
+    v.for_each_segment([&runs](const int*, std::size_t count) {
+        runs.push_back(count);
+    });
+    CHECK_EQUAL(13u, runs.size());
+    CHECK_EQUAL(8u, runs.front());
+    CHECK_EQUAL(4u, runs.back());
+}
+
+TEST(pool) {
+    using vector_type = rttl::segmented_vector<int, 4, 8, 3>;
+    vector_type::pool_type pool;
+    CHECK_EQUAL(3u, pool.available());
+    vector_type a(pool);
+    vector_type b(pool);
+    a.resize(8, 1);
+    CHECK_EQUAL(1u, pool.available());
+    b.resize(4);
+    CHECK_EQUAL(0u, pool.available());
+    /// The pool, not the segment table, is exhausted
+    CHECK_THROW(b.push_back(2), std::length_error);
+    CHECK_EQUAL(4u, b.size());
+
+    a.resize(3);
+    a.shrink_to_fit();
+    CHECK_EQUAL(1u, pool.available());
+    b.push_back(2);
+    CHECK_EQUAL(2, b[4]);
+
+    /// Moves take over segments
+    const int* first = &b[0];
+    vector_type c(std::move(b));
+    CHECK(b.empty());
+    CHECK_EQUAL(first, &c[0]);
+    CHECK_EQUAL(5u, c.size());
+    a = std::move(c);
+    CHECK_EQUAL(first, &a[0]);
+    CHECK_EQUAL(1u, pool.available());
+
+    /// Segments of a copy that failed are returned
+    CHECK_THROW(vector_type copy(a), std::length_error);
+    CHECK_EQUAL(1u, pool.available());
+    a.pop_back();
+    a.shrink_to_fit();
+    vector_type d(a);
+    CHECK_EQUAL(1u, pool.available());
+    CHECK(std::equal(a.begin(), a.end(), d.begin(), d.end()));
+    swap(a, d);
+    CHECK_EQUAL(first, &d[0]);
+}
+
+TEST(shared_default_pool) {
+    /// Vectors of the same type share the default pool of 4 segments
+    using vector_type = rttl::segmented_vector<short, 2, 4>;
+    vector_type a;
+    vector_type b;
+    CHECK_EQUAL(8u, vector_type::max_size());
+    a.resize(6);
+    CHECK_EQUAL(1u, vector_type::default_pool().available());
+    b.resize(2);
+    CHECK_THROW(b.resize(4), std::length_error);
+    CHECK(b.size() < b.max_size());
+    a.clear();
+    a.shrink_to_fit();
+    b.resize(8);
+    CHECK_EQUAL(0u, vector_type::default_pool().available());
+}
+
+TEST(pool_threads) {
+    using pool_type = rttl::segment_pool<int, 4, 16>;
+    static pool_type pool;
+    std::atomic<bool> overlapped{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&overlapped]() {
+            for (int i = 0; i < 10000; ++i) {
+                int* a = pool.acquire();
+                int* b = pool.acquire();
+                a[0] = i;
+                b[0] = -i;
+                if (a[0] != i) {
+                    overlapped = true;
+                }
+                pool.release(a);
+                pool.release(b);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(!overlapped);
+    CHECK_EQUAL(16u, pool.available());
+    /// Every segment is handed out exactly once
+    std::vector<int*> segments;
+    for (int i = 0; i < 16; ++i) {
+        segments.push_back(pool.acquire());
+    }
+    std::sort(segments.begin(), segments.end());
+    CHECK(std::adjacent_find(segments.begin(), segments.end()) == segments.end());
+    CHECK_THROW(pool.acquire(), std::length_error);
+}
+
+TEST(elements) {
+    /// No element leaks
+    {
+        rttl::segmented_vector<Element, 2, 8> v = { 1, 2, 3 };
+        v.emplace_back(4);
+        v.push_back(Element(5));
+        rttl::segmented_vector<Element, 2, 8> w(v);
+        CHECK_EQUAL(5u, w.size());
+        CHECK_EQUAL(5, w.back());
+        w.pop_back();
+        w.resize(7);
+        CHECK_EQUAL(0, w[6]);
+        v = w;
+        CHECK_EQUAL(7u, v.size());
+        w.clear();
+    }
+    CHECK_EQUAL(0u, s_elems_ctored.size());
+}
+
+int main(int, const char* []) {
+    int r = UnitTest::RunAllTests();
+    assert(s_elems_ctored.size() == 0); /// Check memory leaks
+    return r;
+}
@@ -0,0 +1,135 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string_view>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/sketch.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+
+rttl::string<16> client_id(std::uint64_t n) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "C%llu", static_cast<unsigned long long>(n));
+    return rttl::string<16>(buf);
+}
+
+}
+
+TEST(sketch_hash) {
+    rttl::string<16> s("AAPL");
+    CHECK_EQUAL(rttl::sketch_hash("AAPL"sv), rttl::sketch_hash(s));
+    CHECK(rttl::sketch_hash("AAPL"sv) != rttl::sketch_hash("AAPM"sv));
+    CHECK(rttl::sketch_hash(1) != rttl::sketch_hash(2));
+    CHECK_EQUAL(rttl::sketch_hash(std::uint64_t(7)), rttl::sketch_hash(std::int64_t(7)));
+}
+
+TEST(hyperloglog) {
+    rttl::hyperloglog<12> hll;
+    CHECK_EQUAL(0.0, hll.estimate());
+    for (int i = 0; i < 10; ++i) {
+        hll.add(i);
+        hll.add(i);
+    }
+    CHECK_CLOSE(10.0, hll.estimate(), 0.5);
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        hll.add(i * 7919);
+    }
+    /// About three standard errors of 1.6%
+    CHECK_CLOSE(100000.0, hll.estimate(), 5000.0);
+    hll.clear();
+    CHECK_EQUAL(0.0, hll.estimate());
+}
+
+TEST(hyperloglog_merge) {
+    rttl::hyperloglog<14> a;
+    rttl::hyperloglog<14> b;
+    for (std::uint64_t i = 0; i < 30000; ++i) {
+        a.add(client_id(i));
+        b.add(client_id(i + 20000));
+    }
+    CHECK_CLOSE(30000.0, a.estimate(), 1000.0);
+    a.merge(b);
+    CHECK_CLOSE(50000.0, a.estimate(), 1500.0);
+}
+
+TEST(count_min) {
+    static rttl::count_min<1024, 4> cms;
+    std::map<std::uint64_t, std::uint32_t> exact;
+    std::uint32_t x = 1;
+    for (int i = 0; i < 20000; ++i) {
+        x = x * 1664525 + 1013904223;
+        std::uint64_t key = (x >> 8) % 2000;
+        cms.add(key);
+        ++exact[key];
+    }
+    CHECK_EQUAL(20000u, cms.total());
+    std::size_t within = 0;
+    for (const auto& [key, count] : exact) {
+        std::uint32_t estimate = cms.estimate(key);
+        CHECK(estimate >= count);
+        /// e / width * total is about 53
+        within += (estimate - count <= 53) ? 1 : 0;
+    }
+    CHECK(within > exact.size() * 95 / 100);
+}
+
+TEST(count_min_merge) {
+    static rttl::count_min<256, 3, std::uint64_t> a;
+    static rttl::count_min<256, 3, std::uint64_t> b;
+    a.add("IBM"sv, 5);
+    b.add("IBM"sv, 7);
+    b.add("MSFT"sv);
+    a.merge(b);
+    CHECK(a.estimate("IBM"sv) >= 12u);
+    CHECK(a.estimate("MSFT"sv) >= 1u);
+    CHECK_EQUAL(13u, a.total());
+    a.clear();
+    CHECK_EQUAL(0u, a.estimate("IBM"sv));
+}
+
+TEST(heavy_hitters) {
+    using hitters = rttl::heavy_hitters<rttl::string<16>, 4, 512, 4>;
+    static hitters a;
+    static hitters b;
+    std::uint32_t x = 7;
+    for (int i = 0; i < 20000; ++i) {
+        x = x * 1664525 + 1013904223;
+        a.add(client_id((x >> 8) % 500));
+        b.add(client_id((x >> 12) % 700 + 1000));
+        if (i % 4 == 0) {
+            a.add(client_id(1));
+            b.add(client_id(2));
+        }
+        if (i % 8 == 0) {
+            a.add(client_id(3));
+            b.add(client_id(3));
+        }
+    }
+    rttl::vector<hitters::entry, 4> top;
+    a.top(top);
+    CHECK_EQUAL(4u, top.size());
+    CHECK(top[0].key == "C1"sv);
+    CHECK(top[1].key == "C3"sv);
+    CHECK(top[0].count >= 5000u);
+    a.merge(b);
+    a.top(top);
+    /// C1, C2 and C3 have 5000 counts each after merging, in any order
+    std::map<std::string_view, std::uint32_t> merged;
+    for (std::size_t i = 0; i < 3; ++i) {
+        merged[std::string_view(top[i].key.data(), top[i].key.size())] = top[i].count;
+    }
+    CHECK_EQUAL(1u, merged.count("C1"sv));
+    CHECK_EQUAL(1u, merged.count("C2"sv));
+    CHECK_EQUAL(1u, merged.count("C3"sv));
+    for (const auto& [key, count] : merged) {
+        CHECK(count >= 5000u);
+    }
+    CHECK(top[3].count < 1000u);
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
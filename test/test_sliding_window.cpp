@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/sliding_window.h"
+
+using TestWindow = rttl::sliding_window<int, 4, rttl::window_min,
+                                        rttl::window_max, rttl::window_sum>;
+
+TEST(push_pop) {
+    TestWindow w;
+    CHECK(w.empty());
+    CHECK_EQUAL(4u, w.capacity());
+    w.push(3);
+    w.push(1);
+    w.push(4);
+    CHECK_EQUAL(3u, w.size());
+    CHECK_EQUAL(3, w.front());
+    CHECK_EQUAL(4, w.back());
+    w.push(1);
+    w.push(5);
+    CHECK(w.full());
+    CHECK_EQUAL(1, w[0]);
+    CHECK_EQUAL(4, w[1]);
+    CHECK_EQUAL(1, w[2]);
+    CHECK_EQUAL(5, w[3]);
+    CHECK_THROW(w.at(4), std::out_of_range);
+    w.pop();
+    CHECK_EQUAL(3u, w.size());
+    CHECK_EQUAL(4, w.front());
+    w.clear();
+    CHECK(w.empty());
+    CHECK_THROW(w.pop(), std::invalid_argument);
+}
+
+TEST(aggregates) {
+    /// Compare with rescanning of the last samples
+    TestWindow w;
+    std::vector<int> samples;
+    for (int i = 0; i < 100; ++i) {
+        int x = (i * 37 + 11) % 23 - 7;
+        w.push(x);
+        samples.push_back(x);
+        auto first = samples.cend() - static_cast<std::ptrdiff_t>(w.size());
+        CHECK_EQUAL(*std::min_element(first, samples.cend()), w.min());
+        CHECK_EQUAL(*std::max_element(first, samples.cend()), w.max());
+        CHECK_EQUAL(std::accumulate(first, samples.cend(), 0), w.sum());
+        CHECK_CLOSE(std::accumulate(first, samples.cend(), 0) /
+                    static_cast<double>(w.size()), w.mean(), 1e-12);
+    }
+    w.pop();
+    w.pop();
+    CHECK_EQUAL(std::min(samples[98], samples[99]), w.min());
+    CHECK_EQUAL(std::max(samples[98], samples[99]), w.max());
+    CHECK_EQUAL(samples[98] + samples[99], w.sum());
+}
+
+TEST(kahan_sum) {
+    /// Running sums drift over many evictions, compensated one should not
+    rttl::sliding_window<double, 16, rttl::window_kahan_sum> kahan;
+    rttl::sliding_window<double, 16, rttl::window_sum> plain;
+    for (int i = 0; i < 100000; ++i) {
+        double x = 0.1 * (i % 7) + 1e3 * (i % 3);
+        kahan.push(x);
+        plain.push(x);
+    }
+    double exact = 0.0;
+    for (std::size_t i = 0; i < kahan.size(); ++i) {
+        exact += kahan[i];
+    }
+    CHECK_CLOSE(exact, kahan.sum(), 1e-9);
+    CHECK(std::abs(exact - kahan.sum()) <= std::abs(exact - plain.sum()));
+    CHECK_CLOSE(exact / 16.0, kahan.mean(), 1e-9);
+}
+
+TEST(timed_window) {
+    rttl::timed_sliding_window<int, 4, std::int64_t, rttl::window_min,
+                               rttl::window_max, rttl::window_sum> w(10);
+    CHECK_EQUAL(10, w.span());
+    w.push(100, 5);
+    w.push(103, 2);
+    w.push(105, 7);
+    CHECK_EQUAL(3u, w.size());
+    CHECK_EQUAL(2, w.min());
+    CHECK_EQUAL(7, w.max());
+    CHECK_EQUAL(14, w.sum());
+    w.push(110, 4);
+    CHECK_EQUAL(3u, w.size());
+    CHECK_EQUAL(103, w.time(0));
+    CHECK_EQUAL(2, w[0]);
+    w.push(112, 1);
+    CHECK_THROW(w.push(112, 3), std::length_error);
+    CHECK_EQUAL(1, w.min());
+    w.expire(115);
+    CHECK_EQUAL(2u, w.size());
+    CHECK_EQUAL(1, w.min());
+    CHECK_EQUAL(4, w.max());
+    CHECK_EQUAL(2.5, w.mean());
+    w.expire(200);
+    CHECK(w.empty());
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
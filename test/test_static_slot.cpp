@@ -0,0 +1,101 @@
+#include <cassert>
+#include <string>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/static_slot.h"
+#include "rttl/vector.h"
+#include "element.h"
+
+using big_vector = rttl::vector<int, 1000000>;
+
+/// Constant-initialized, too large for the stack
+static rttl::static_slot<big_vector> s_big;
+
+static std::vector<std::string> s_log;
+
+struct Logged {
+    explicit Logged(std::string name) : name(std::move(name)) {
+        s_log.push_back("+" + this->name);
+    }
+
+    ~Logged() {
+        s_log.push_back("-" + name);
+    }
+
+    std::string name;
+};
+
+static rttl::static_slot<Logged> s_first;
+static rttl::static_slot<Logged> s_second;
+static rttl::static_slot<Logged> s_third;
+static rttl::static_slot<Element> s_element;
+
+TEST(emplace_reset) {
+    CHECK(!s_big.has_value());
+    CHECK_THROW(s_big.value(), std::invalid_argument);
+
+    big_vector& v = s_big.emplace(3, 7);
+    CHECK(s_big);
+    CHECK_EQUAL(&v, s_big.get());
+    CHECK_EQUAL(3u, s_big->size());
+    CHECK_EQUAL(7, (*s_big)[2]);
+    s_big->push_back(8);
+    CHECK_EQUAL(4u, s_big.value().size());
+
+    s_big.emplace();
+    CHECK(s_big->empty());
+    s_big.reset();
+    CHECK(!s_big.has_value());
+    s_big.reset();
+
+    /// No element leaks
+    s_element.emplace(1);
+    s_element.emplace(2);
+    CHECK_EQUAL(2, *s_element);
+    {
+        rttl::static_slot<Element> local;
+        local.emplace(3);
+    }
+    s_element.reset();
+    CHECK_EQUAL(0u, s_elems_ctored.size());
+}
+
+TEST(registry) {
+    s_log.clear();
+    rttl::register_slot(s_third, 2, [](rttl::static_slot<Logged>& slot) {
+        slot.emplace("third");
+    });
+    rttl::register_slot(s_first, 1, [](rttl::static_slot<Logged>& slot) {
+        slot.emplace("first");
+    });
+    rttl::register_slot(s_second, 1, [](rttl::static_slot<Logged>& slot) {
+        slot.emplace("second");
+    });
+    rttl::register_slot(s_big);
+    CHECK_EQUAL(4u, rttl::registered_slot_count());
+
+    rttl::construct_registered_slots();
+    CHECK(s_big.has_value());
+    const std::vector<std::string> constructed = {
+        "+first", "+second", "+third" };
+    CHECK(s_log == constructed);
+
+    /// Constructed slots are kept
+    rttl::construct_registered_slots();
+    CHECK_EQUAL(3u, s_log.size());
+
+    rttl::destroy_registered_slots();
+    CHECK(!s_big.has_value());
+    const std::vector<std::string> destroyed = {
+        "+first", "+second", "+third", "-third", "-second", "-first" };
+    CHECK(s_log == destroyed);
+
+    rttl::unregister_slot(s_second);
+    CHECK_EQUAL(3u, rttl::registered_slot_count());
+}
+
+int main(int, const char* []) {
+    int r = UnitTest::RunAllTests();
+    assert(s_elems_ctored.size() == 0); /// Check memory leaks
+    return r;
+}
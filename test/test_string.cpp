@@ -876,6 +876,19 @@ TEST(resize_2) {
 	CHECK_THROW(s.resize(33, 'z'), std::length_error);
 }
 
+TEST(resize_and_overwrite) {
+	rttl::string<32> s("Hello");
+	s.resize_and_overwrite(13, [](char* p, std::size_t n) {
+		CHECK_EQUAL(n, 13u);
+		CHECK_EQUAL(std::strncmp(p, "Hello", 5), 0);
+		std::memcpy(p + 5, ", World", 7);
+		return std::size_t(12);
+	});
+	CHECK_EQUAL(std::strcmp(s.c_str(), "Hello, World"), 0);
+	CHECK_EQUAL(s.length(), 12u);
+	CHECK_THROW(s.resize_and_overwrite(33, [](char*, std::size_t) { return std::size_t(0); }), std::length_error);
+}
+
 TEST(swap) {
 	rttl::string<32> s("Hello, World!");
 	rttl::string<32> s1("Bye-bye!");
@@ -950,6 +963,48 @@ TEST(find_4) {
 	CHECK_EQUAL(r3, s.npos);
 }
 
+TEST(find_5) {
+	/// Needles of 1..64 characters over small alphabets, compared with std::string_view
+	rttl::string<1000> s;
+	std::string_view sv;
+	unsigned seed = 1;
+	auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7FFF; };
+	for (unsigned alphabet = 1; alphabet <= 4; alphabet *= 2) {
+		s.clear();
+		for (int i = 0; i < 900; ++i) {
+			s.push_back(static_cast<char>('a' + next() % alphabet));
+		}
+		sv = std::string_view(s.data(), s.length());
+		for (std::size_t m = 1; m <= 64; ++m) {
+			std::size_t start = next() % (s.length() - m);
+			std::string needle(sv.substr(start, m));
+			needle[m / 2] = static_cast<char>('a' + next() % (alphabet + 1));
+			for (std::size_t pos : { std::size_t(0), std::size_t(17), start, s.length() }) {
+				CHECK_EQUAL(sv.find(needle, pos), s.find(needle, pos));
+				CHECK_EQUAL(sv.rfind(needle, pos), s.rfind(needle, pos));
+			}
+			CHECK_EQUAL(sv.rfind(needle), s.rfind(needle));
+		}
+	}
+	/// Worst case for filtering by the first and the last characters
+	s.assign(999, 'a');
+	std::string needle = std::string(30, 'a') + "b" + std::string(30, 'a');
+	CHECK_EQUAL(s.npos, s.find(needle));
+	CHECK_EQUAL(s.npos, s.rfind(needle));
+	s.replace(500, 1, "b");
+	CHECK_EQUAL(470u, s.find(needle));
+	CHECK_EQUAL(470u, s.rfind(needle));
+	/// Stale characters past the end of a shrunk string are never matched
+	s.assign("xxxxabcd");
+	s.resize(6);
+	CHECK_EQUAL(s.npos, s.find("abc"));
+	CHECK_EQUAL(4u, s.find("ab"));
+	CHECK_EQUAL(0u, s.find(""));
+	CHECK_EQUAL(6u, s.find("", 6));
+	CHECK_EQUAL(s.npos, s.find("", 7));
+	CHECK_EQUAL(6u, s.rfind(""));
+}
+
 TEST(rfind_1) {
 	rttl::string<32> s("Hello Hello");
 	rttl::string<16> s1("Hello");
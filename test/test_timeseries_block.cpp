@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/timeseries_block.h"
+
+using Point = std::pair<std::uint64_t, double>;
+
+template <std::size_t Bytes>
+static std::vector<Point> decode(const rttl::timeseries_block<Bytes>& block) {
+    return std::vector<Point>(block.cbegin(), block.cend());
+}
+
+TEST(empty) {
+    rttl::timeseries_block<64> block;
+    CHECK(block.empty());
+    CHECK_EQUAL(0u, block.size());
+    CHECK(block.begin() == block.end());
+    CHECK_EQUAL(512u, block.bit_capacity());
+}
+
+TEST(append_decode) {
+    rttl::timeseries_block<256> block;
+    std::vector<Point> points = {
+        { 1000000000, 101.25 },
+        { 1000001000, 101.25 },
+        { 1000002000, 101.50 },
+        { 1000003001, 101.25 },
+        { 1000003001, -3.0 },
+        { 1000010000, std::numeric_limits<double>::infinity() },
+        { 999999999, 0.0 },
+        { UINT64_MAX, 1e300 },
+        { 0, 1e-300 },
+    };
+    for (const auto& p : points) {
+        CHECK(block.append(p.first, p.second));
+    }
+    CHECK_EQUAL(points.size(), block.size());
+    std::vector<Point> decoded = decode(block);
+    CHECK_EQUAL(points.size(), decoded.size());
+    for (std::size_t i = 0; i < decoded.size(); ++i) {
+        CHECK_EQUAL(points[i].first, decoded[i].first);
+        CHECK_EQUAL(points[i].second, decoded[i].second);
+    }
+    auto it = block.begin();
+    CHECK_EQUAL(1000000000u, it->first);
+    it++;
+    CHECK_EQUAL(1000001000u, (*it).first);
+    block.clear();
+    CHECK(block.empty());
+    CHECK_EQUAL(0u, block.bit_size());
+}
+
+TEST(regular_series) {
+    /// Regular intervals and repeated values take 2 bits per point
+    rttl::timeseries_block<64> block;
+    CHECK(block.append(5000, 1.5));
+    for (std::uint64_t t = 1; t < 100; ++t) {
+        CHECK(block.append(5000 + t * 10, 1.5));
+    }
+    CHECK_EQUAL(128u + 9u + 1u + 98u * 2u, block.bit_size());
+}
+
+TEST(full) {
+    rttl::timeseries_block<32> block;
+    std::size_t n = 0;
+    while (block.append(1000 + n * 7919 * n, 100.0 + std::sin(double(n)))) {
+        ++n;
+    }
+    CHECK(n > 1);
+    CHECK_EQUAL(n, block.size());
+    CHECK(block.bit_size() <= block.bit_capacity());
+    std::size_t bits = block.bit_size();
+    CHECK(!block.append(UINT64_MAX, 1e300));
+    CHECK_EQUAL(bits, block.bit_size());
+    std::vector<Point> decoded = decode(block);
+    CHECK_EQUAL(n, decoded.size());
+    for (std::size_t i = 0; i < decoded.size(); ++i) {
+        CHECK_EQUAL(1000 + i * 7919 * i, decoded[i].first);
+        CHECK_EQUAL(100.0 + std::sin(double(i)), decoded[i].second);
+    }
+}
+
+TEST(market_data) {
+    /// Ticks at roughly 1ms with prices on a 0.01 grid compress well below
+    /// 16 bytes per point
+    rttl::timeseries_block<4096> block;
+    std::uint64_t t = 1600000000000000000u;
+    long cents = 10000;
+    std::size_t n = 0;
+    while (true) {
+        t += 1000000 + (n % 5 == 0 ? 1000 : 0);
+        cents += static_cast<long>(n % 7) - 3;
+        if (!block.append(t, static_cast<double>(cents) / 100.0)) {
+            break;
+        }
+        ++n;
+    }
+    CHECK(n > 4096 / 8);
+    std::uint64_t expected_t = 1600000000000000000u;
+    long expected_cents = 10000;
+    std::size_t i = 0;
+    for (const auto& p : block) {
+        expected_t += 1000000 + (i % 5 == 0 ? 1000 : 0);
+        expected_cents += static_cast<long>(i % 7) - 3;
+        CHECK_EQUAL(expected_t, p.first);
+        CHECK_EQUAL(static_cast<double>(expected_cents) / 100.0, p.second);
+        ++i;
+    }
+    CHECK_EQUAL(n, i);
+}
+
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <chrono>
+#include <limits>
+#include <string_view>
+#include <UnitTest++/UnitTest++.h>
+#include "rttl/timestamp.h"
+
+using namespace std::string_view_literals;
+
+using rttl::timestamp_layout;
+
+constexpr std::int64_t nanos = 1710495000LL * 1000000000 + 123456789;
+
+TEST(format_timestamp_iso8601) {
+    rttl::string<32> out;
+    rttl::format_timestamp(nanos, out);
+    CHECK(out == "2024-03-15T09:30:00.123456789Z"sv);
+    rttl::format_timestamp<timestamp_layout::iso8601, 3>(nanos, out);
+    CHECK(out == "2024-03-15T09:30:00.123Z"sv);
+    rttl::format_timestamp<timestamp_layout::iso8601, 6>(nanos, out);
+    CHECK(out == "2024-03-15T09:30:00.123456Z"sv);
+    rttl::format_timestamp<timestamp_layout::iso8601, 0>(nanos, out);
+    CHECK(out == "2024-03-15T09:30:00Z"sv);
+    rttl::format_timestamp(0, out);
+    CHECK(out == "1970-01-01T00:00:00.000000000Z"sv);
+    rttl::format_timestamp(-1, out);
+    CHECK(out == "1969-12-31T23:59:59.999999999Z"sv);
+    rttl::format_timestamp(951782400LL * 1000000000, out);
+    CHECK(out == "2000-02-29T00:00:00.000000000Z"sv);
+}
+
+TEST(format_timestamp_fix) {
+    rttl::string<32> out;
+    rttl::format_timestamp<timestamp_layout::fix>(nanos, out);
+    CHECK(out == "20240315-09:30:00.123456789"sv);
+    rttl::format_timestamp<timestamp_layout::fix, 3>(nanos, out);
+    CHECK(out == "20240315-09:30:00.123"sv);
+    rttl::format_timestamp<timestamp_layout::fix, 0>(nanos, out);
+    CHECK(out == "20240315-09:30:00"sv);
+    CHECK_EQUAL(21u, (rttl::timestamp_formatter<timestamp_layout::fix, 3>::length));
+}
+
+TEST(format_timestamp_chrono) {
+    rttl::string<32> out;
+    std::chrono::system_clock::time_point t{std::chrono::seconds(1710495000) +
+                                            std::chrono::milliseconds(5)};
+    rttl::format_timestamp<timestamp_layout::iso8601, 3>(t, out);
+    CHECK(out == "2024-03-15T09:30:00.005Z"sv);
+}
+
+TEST(timestamp_formatter_cache) {
+    /// Crossing seconds, minutes and days through the cached text
+    rttl::timestamp_formatter<> formatter;
+    rttl::string<32> out;
+    std::int64_t midnight = 1710547200LL * 1000000000;
+    formatter.format(midnight - 1, out);
+    CHECK(out == "2024-03-15T23:59:59.999999999Z"sv);
+    formatter.format(midnight - 999999999, out);
+    CHECK(out == "2024-03-15T23:59:59.000000001Z"sv);
+    formatter.format(midnight, out);
+    CHECK(out == "2024-03-16T00:00:00.000000000Z"sv);
+    formatter.format(midnight + 61000000000, out);
+    CHECK(out == "2024-03-16T00:01:01.000000000Z"sv);
+    formatter.format(midnight - 86400000000000, out);
+    CHECK(out == "2024-03-15T00:00:00.000000000Z"sv);
+    formatter.format(std::numeric_limits<std::int64_t>::max(), out);
+    CHECK(out == "2262-04-11T23:47:16.854775807Z"sv);
+    formatter.format(std::numeric_limits<std::int64_t>::min(), out);
+    CHECK(out == "1677-09-21T00:12:43.145224192Z"sv);
+}
+
+TEST(parse_timestamp) {
+    std::int64_t t = 0;
+    CHECK(rttl::parse_timestamp("2024-03-15T09:30:00.123456789Z", t));
+    CHECK_EQUAL(nanos, t);
+    CHECK((rttl::parse_timestamp<timestamp_layout::iso8601, 3>("2024-03-15T09:30:00.123Z", t)));
+    CHECK_EQUAL(nanos - 456789, t);
+    CHECK((rttl::parse_timestamp<timestamp_layout::fix, 0>("20240315-09:30:00", t)));
+    CHECK_EQUAL(nanos - 123456789, t);
+    CHECK((rttl::parse_timestamp<timestamp_layout::fix, 6>("19691231-23:59:59.999999", t)));
+    CHECK_EQUAL(-1000, t);
+    CHECK(rttl::parse_timestamp("2000-02-29T00:00:00.000000000Z", t));
+    CHECK_EQUAL(951782400LL * 1000000000, t);
+    CHECK(rttl::parse_timestamp("2262-04-11T23:47:16.854775807Z", t));
+    CHECK_EQUAL(std::numeric_limits<std::int64_t>::max(), t);
+    CHECK(rttl::parse_timestamp("1677-09-21T00:12:43.145224192Z", t));
+    CHECK_EQUAL(std::numeric_limits<std::int64_t>::min(), t);
+    CHECK(rttl::parse_timestamp("2262-04-11T23:47:16.000000000Z", t));
+    CHECK_EQUAL(9223372036000000000, t);
+    CHECK(rttl::parse_timestamp("1677-09-21T00:12:44.000000000Z", t));
+    CHECK_EQUAL(-9223372036000000000, t);
+}
+
+TEST(parse_timestamp_invalid) {
+    std::int64_t t = 42;
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:30:00.123456789", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:30:00.123456789ZZ", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15 09:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:30:00,123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:3a:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:30:00.12345678/Z", t));
+    CHECK(!rttl::parse_timestamp("2024-13-15T09:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-00-15T09:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2023-02-29T09:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-04-31T09:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T24:30:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:60:00.123456789Z", t));
+    CHECK(!rttl::parse_timestamp("2024-03-15T09:30:60.123456789Z", t));
+    CHECK(!(rttl::parse_timestamp<timestamp_layout::fix, 0>("2024-03-15T09:30:00Z", t)));
+    CHECK(!rttl::parse_timestamp("2262-04-11T23:47:16.854775808Z", t));
+    CHECK(!rttl::parse_timestamp("1677-09-21T00:12:43.145224191Z", t));
+    CHECK(!rttl::parse_timestamp("9999-12-31T23:59:59.000000000Z", t));
+    CHECK(!rttl::parse_timestamp("2262-04-11T23:47:17.000000000Z", t));
+    CHECK(!rttl::parse_timestamp("1677-09-21T00:12:43.000000000Z", t));
+    CHECK_EQUAL(42, t);
+}
+
+TEST(timestamp_round_trip) {
+    rttl::string<32> out;
+    std::int64_t t = 0;
+    for (std::int64_t n = -5000000000000000000; n < 5000000000000000000;
+         n += 123456789012345677) {
+        rttl::format_timestamp(n, out);
+        CHECK(rttl::parse_timestamp(out, t));
+        CHECK_EQUAL(n, t);
+        rttl::format_timestamp<timestamp_layout::fix>(n, out);
+        CHECK(rttl::parse_timestamp<timestamp_layout::fix>(out, t));
+        CHECK_EQUAL(n, t);
+    }
+}
+
+int main(int, const char* []) {
+    return UnitTest::RunAllTests();
+}
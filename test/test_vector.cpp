@@ -1,5 +1,10 @@
 #include <cassert>
+#include <array>
+#include <cstdint>
 #include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <UnitTest++/UnitTest++.h>
 #include "rttl/vector.h"
 #include "element.h"
@@ -693,6 +698,28 @@ TEST(pop_back) {
     CHECK_THROW(v.pop_back(), std::exception);
 }
 
+TEST(append_uninitialized) {
+    TestVector v = { 123, 456 };
+    v.append_uninitialized(3, [](Element* p, std::size_t count) {
+        CHECK_EQUAL(3u, count);
+        ::new(p) Element(789);
+        ::new(p + 1) Element(0);
+        return std::size_t(2);
+    });
+    CHECK_EQUAL(4u, v.size());
+    CHECK_EQUAL(123, v[0]);
+    CHECK_EQUAL(456, v[1]);
+    CHECK_EQUAL(789, v[2]);
+    CHECK_EQUAL(0, v[3]);
+    bool invoked = false;
+    CHECK_THROW(v.append_uninitialized(29, [&invoked](Element*, std::size_t) {
+        invoked = true;
+        return std::size_t(0);
+    }), std::length_error);
+    CHECK(!invoked);
+    CHECK_EQUAL(4u, v.size());
+}
+
 TEST(resize_1) {
     TestVector v = { 123, 456, 789, 0 };
     CHECK_THROW(v.resize(33), std::length_error);
@@ -1092,6 +1119,59 @@ TEST(adl_swap_3) {
 }
 
 
+TEST(hash) {
+    using Key = rttl::vector<std::uint32_t, 8>;
+    Key k1 = { 1, 2, 3 };
+    Key k2 = { 1, 2, 3 };
+    Key k3 = { 1, 2, 4 };
+    Key k4 = { 1, 2 };
+    std::hash<Key> h;
+    CHECK_EQUAL(h(k1), h(k2));
+    CHECK(h(k1) != h(k3));
+    CHECK(h(k1) != h(k4));
+    CHECK(h(Key()) != h(Key{ 0 }));
+
+    /// Consistent with contiguous ranges of other types
+    std::vector<std::uint32_t> sv = { 1, 2, 3 };
+    std::array<std::uint32_t, 3> sa = { 1, 2, 3 };
+    CHECK_EQUAL(h(k1), rttl::range_hash{}(sv));
+    CHECK_EQUAL(h(k1), rttl::range_hash{}(sa));
+    CHECK_EQUAL(h(k1), rttl::hash_range(sa.data(), sa.size()));
+    CHECK(rttl::range_equal{}(k1, sv));
+    CHECK(!rttl::range_equal{}(k4, sa));
+
+    std::unordered_map<Key, int> map;
+    map[k1] = 1;
+    map[k3] = 3;
+    CHECK_EQUAL(1, map[k2]);
+    CHECK_EQUAL(2u, map.size());
+
+    /// Elements without unique object representations
+    using StringKey = rttl::vector<std::string, 4>;
+    StringKey s1 = { "a", "bc" };
+    StringKey s2 = { "ab", "c" };
+    std::vector<std::string> s3 = { "a", "bc" };
+    CHECK(std::hash<StringKey>{}(s1) != std::hash<StringKey>{}(s2));
+    CHECK_EQUAL(std::hash<StringKey>{}(s1), rttl::range_hash{}(s3));
+    std::unordered_set<StringKey> set = { s1, s2 };
+    CHECK_EQUAL(1u, set.count(StringKey{ "ab", "c" }));
+}
+
+TEST(range_hash_containers) {
+    using Key = rttl::vector<std::uint32_t, 8>;
+    std::unordered_set<Key, rttl::range_hash, rttl::range_equal> set = { { 1, 2, 3 }, { 4 } };
+    CHECK_EQUAL(1u, set.count(Key{ 1, 2, 3 }));
+    CHECK_EQUAL(0u, set.count(Key{ 1, 2 }));
+    std::array<std::uint32_t, 3> sa = { 1, 2, 3 };
+    /// Lookups by other ranges construct a key in C++17
+    CHECK_EQUAL(1u, set.count(Key(sa.begin(), sa.end())));
+#if __cplusplus >= 202002L
+    CHECK_EQUAL(1u, set.count(sa));
+    CHECK(set.find(std::vector<std::uint32_t>{ 4 }) != set.end());
+#endif
+}
+
+
 int main(int, const char* []) {
     int r = UnitTest::RunAllTests();
     assert(s_elems_ctored.size() == 0); /// Check memory leaks